@@ -1,5 +1,8 @@
 #include "AnimationComponents.h"
 
+#include "Engine/Engine.h"
+#include "Engine/Core/FrameAllocator.h"
+
 namespace Mega
 {
 	namespace Component
@@ -24,6 +27,16 @@ namespace Mega
 			ClearAnimationJobs();
 		}
 
+		template<typename tJob>
+		tJob* AnimatedModel::CreateJob()
+		{
+			if (!Engine::IsUpdatingScene()) { return new tJob(); }
+
+			tJob* pJob = FrameAllocator::Get().New<tJob>();
+			pJob->isFrameAllocated = true;
+			return pJob;
+		}
+
 		void AnimatedModel::AddAnimation(const tFilePath in_name, tAnimation in_animation, bool in_shouldLoop)
 		{
 			MEGA_ASSERT(skeleton.skeletonIndex >= 0, "Animation needs a skeleton loaded first");
@@ -56,7 +69,7 @@ namespace Mega
 			isPlaying = true;
 
 			// Create the animation job
-			PlaybackJob* pPlaybackJob = new PlaybackJob();
+			PlaybackJob* pPlaybackJob = CreateJob<PlaybackJob>();
 
 			pPlaybackJob->isValid = true;
 			pPlaybackJob->pActiveAnimation = &animationNameMap.at(in_animName);
@@ -73,7 +86,7 @@ namespace Mega
 			isPlaying = true;
 
 			// Create the animation job
-			BlendJob* pBlendJob = new BlendJob();
+			BlendJob* pBlendJob = CreateJob<BlendJob>();
 
 			pBlendJob->isValid = true;
 			pBlendJob->blendFactor = in_blendFactor;
@@ -85,7 +98,7 @@ namespace Mega
 		}
 		void AnimatedModel::InverseKinematics(const tJointName in_startJoint, const tJointName in_midJoint, const tJointName in_endJoint, const Vec3& in_target, const Vec3& in_pole, const Transform* in_pEntityTransform)
 		{
-			InverseKinematicsJob* pIKJob = new InverseKinematicsJob();
+			InverseKinematicsJob* pIKJob = CreateJob<InverseKinematicsJob>();
 
 			pIKJob->startJoint = in_startJoint;
 			pIKJob->midJoint = in_midJoint;
@@ -101,7 +114,7 @@ namespace Mega
 		{
 			MEGA_ASSERT(in_pBarnacleTransform != nullptr, "Creating Joint Attachment Job with a nullptr transform");
 			MEGA_ASSERT(in_pJointTransform != nullptr, "Creating Joint Attachment Job with a nullptr transform");
-			JointAttachmentJob* pAttachmentJob = new JointAttachmentJob();
+			JointAttachmentJob* pAttachmentJob = CreateJob<JointAttachmentJob>();
 
 			pAttachmentJob->m_attachmentJointName = in_joint;
 			pAttachmentJob->m_pBarnacleTransform = in_pBarnacleTransform;
@@ -113,7 +126,7 @@ namespace Mega
 		void AnimatedModel::PlantFoot(const tJointName in_ankleJoint, const Vec3& in_angleNormal, const Vec3& in_pole, Transform* in_pEntityTransform)
 		{
 			MEGA_ASSERT(in_pEntityTransform != nullptr, "Creating Foot Planting Job with a nullptr transform");
-			FootPlantingJob* pAttachmentJob = new FootPlantingJob();
+			FootPlantingJob* pAttachmentJob = CreateJob<FootPlantingJob>();
 
 			// For some reason the foot will not turn all the way unless these vectors are large
 			pAttachmentJob->angleNormal = in_angleNormal; // * Vec3(100);
@@ -128,7 +141,10 @@ namespace Mega
 		{
 			for (AnimationJob* pJob : pAnimationJobs)
 			{
-				if (pJob) { delete pJob; }
+				if (!pJob) { continue; }
+
+				if (pJob->isFrameAllocated) { pJob->~AnimationJob(); }
+				else { delete pJob; }
 			}
 
 			pAnimationJobs.clear();
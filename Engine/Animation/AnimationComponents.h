@@ -35,13 +35,19 @@ namespace Mega
 			void PlantFoot(const tJointName in_ankleJoint, const Vec3& in_angleNormal, const Vec3& in_pole, Transform* in_pEntityTransform);
 
 			// ---------------- Member Variables  --------------- //
-			std::vector<AnimationJob*> pAnimationJobs;
+			std::vector<AnimationJob*> pAnimationJobs; // Cleared by the animation system every tick
 
 			bool ikHasReached = false;
 			bool isPlaying = true;
 			tMesh mesh{};
 			tSkeleton skeleton{};
 			std::unordered_map<tAnimationName, tAnimation> animationNameMap{};
+
+		private:
+			// Jobs made while the scene updates are run and cleared in the same tick, so they come from frame memory.
+			// Anything else (set up code, the loading thread) still uses the heap
+			template<typename tJob>
+			tJob* CreateJob();
 		};
 	} // namespace Component
 } // namespace Mega
\ No newline at end of file
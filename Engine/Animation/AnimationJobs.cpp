@@ -14,13 +14,10 @@
 #include "ozz/base/maths/soa_transform.h"
 #include "ozz/base/maths/simd_quaternion.h"
 
-#include "ImGui/imgui.h"
-
 float g_twist = 0.0f;
 float g_soften = 1.0f;
 float g_weight = 1.0f;
 
-float g_dtMult = 1;
 Mega::Animation* pLastAnimation = nullptr;
 namespace Mega
 {
@@ -43,15 +40,11 @@ namespace Mega
 			pLastAnimation = pActiveAnimation;
 		}
 
-		float timeRatio = controller.time_ratio();
-		ImGui::DragFloat("Animation Runtime", &timeRatio);
-		
-		ImGui::DragFloat("Animation Speed", &g_dtMult, 0.01f);
 		controller.set_loop(pActiveAnimation->shouldLoop);
 		// Our tTimstep is a float containing number of milliseconds since last frame,
 		// but the controller update function takes a float containing the number (or fraction)
 		// of seconds since last frame, so in_dt needs a quick conversion between the two
-		controller.Update(animationData, (in_dt * g_dtMult) / 1000);
+		controller.Update(animationData, (in_dt * in_pAnimationSystem->m_playbackSpeed) / 1000);
 
 		ozz::animation::SamplingJob sampling_job;
 		sampling_job.animation = &animationData;
@@ -64,7 +57,7 @@ namespace Mega
 		}
 		
 		// Converts from local space to model space matrices.
-		const ozz::math::Float4x4 worldSpaceTransform = GLMToOzz(pEntityTransform->GetTransform());
+		const ozz::math::Float4x4 worldSpaceTransform = GLMToOzz(pEntityTransform->GetWorldTransform());
 
 		ozz::animation::LocalToModelJob ltm_job;
 		ltm_job.root = &worldSpaceTransform;
@@ -173,7 +166,7 @@ namespace Mega
 		}
 
 		// Converts from local space to model space matrices.
-		const ozz::math::Float4x4 worldSpaceTransform = GLMToOzz(pEntityTransform->GetTransform());
+		const ozz::math::Float4x4 worldSpaceTransform = GLMToOzz(pEntityTransform->GetWorldTransform());
 
 		ozz::animation::LocalToModelJob ltm_job;
 		ltm_job.skeleton = &skeleton;
@@ -239,7 +232,7 @@ namespace Mega
 		//}
 
 		ozz::math::SimdInt4 invertible;
-		const ozz::math::Float4x4 invertRoot = Invert(GLMToOzz(pEntityTransform->GetTransform()), &invertible);
+		const ozz::math::Float4x4 invertRoot = Invert(GLMToOzz(pEntityTransform->GetWorldTransform()), &invertible);
 		
 		const ozz::math::SimdFloat4 target_ms = ozz::math::simd_float4::Load3PtrU(&target.x); // TransformPoint(invertRoot, ozz::math::simd_float4::Load3PtrU(&target.x));
 		const ozz::math::SimdFloat4 pole_vector_ms = ozz::math::simd_float4::Load3PtrU(&pole.x); // TransformVector(invertRoot, ozz::math::simd_float4::Load3PtrU(&pole.x));
@@ -287,7 +280,7 @@ namespace Mega
 		
 		// Updates model-space matrices now IK has been applied to local transforms.
 		// All the ancestors of the start of the IK chain must be computed.
-		const ozz::math::Float4x4 worldSpaceTransform = GLMToOzz(pEntityTransform->GetTransform());
+		const ozz::math::Float4x4 worldSpaceTransform = GLMToOzz(pEntityTransform->GetWorldTransform());
 
 		ozz::animation::LocalToModelJob ltm_job;
 		//ltm_job.root = &worldSpaceTransform;
@@ -315,7 +308,7 @@ namespace Mega
 		ozz::vector<ozz::math::Float4x4>& modelMats = in_pAnimationSystem->m_models;
 
 		ozz::math::SimdInt4 invertible;
-		const ozz::math::Float4x4& root = GLMToOzz(pEntityTransform->GetTransform());
+		const ozz::math::Float4x4 root = GLMToOzz(pEntityTransform->GetWorldTransform());
 		const ozz::math::Float4x4& inverseRoot = Invert(root, &invertible);
 
 		// Find the model matrixes for each joint we're modifying
@@ -25,9 +25,11 @@ namespace Mega
 	struct AnimationJob
 	{
 		friend AnimationSystem;
+		virtual ~AnimationJob() = default;
 		virtual bool RunJob(AnimationSystem* in_pAnimationSystem, Component::AnimatedModel* in_pModel, const tTimestep in_dt) = 0;
 		
 		bool isValid = false;
+		bool isFrameAllocated = false; // Lives in frame memory (see AnimatedModel::CreateJob) and is only destructed
 	};
 
 	// ---------- Simple animation playing ---------- //
@@ -6,13 +6,18 @@
 
 #include "Engine/Engine.h"
 #include "Engine/Core/Debug.h"
+#include "Engine/Core/Telemetry.h"
+#include "Engine/Core/MemoryTracker.h"
 #include "Engine/Scene/Scene.h"
 #include "Engine/ECS/Components.h"
 #include "Engine/Animation/AnimationHelpers.h"
 #include "Engine/Animation/AnimationObjects.h"
 
+#include "ImGui/imgui.h"
+
 // For loading
 #include "ozz/base/log.h"
+#include "ozz/base/memory/allocator.h"
 #include "ozz/base/span.h"
 #include "ozz/base/io/stream.h"
 #include "ozz/base/io/archive.h"
@@ -20,9 +25,25 @@
 
 namespace Mega
 {
+	namespace
+	{
+		// Everything ozz allocates (skeletons, animations, meshes, and the runtime buffers) is counted under animation
+		class TrackedOzzAllocator final : public ozz::memory::Allocator
+		{
+		public:
+			void* Allocate(size_t in_size, size_t in_alignment) override { return MemoryTracker::AllocateTagged(eMemoryTag::Animation, in_size, in_alignment); }
+			void Deallocate(void* in_pBlock) override { MemoryTracker::FreeTagged(in_pBlock); }
+		};
+		TrackedOzzAllocator g_ozzAllocator; // Never swapped back, ozz memory outlives the system
+
+		const tCounterID g_playingModelCounter = Telemetry::Register("Animation/Playing models", eCounterType::Gauge);
+	}
+
 	// =============== Base System Class Functions ============= //
 	eMegaResult AnimationSystem::OnInitialize()
 	{
+		ozz::memory::SetDefaulAllocator(&g_ozzAllocator); // Before anything is loaded
+		MEGA_ADD_DEBUG_PANEL(this, "Animation", [this]() { BuildDebugPanel(); });
 		return eMegaResult::SUCCESS;
 	}
 	eMegaResult AnimationSystem::OnDestroy()
@@ -36,16 +57,23 @@ namespace Mega
 		//ozz::memory::default_allocator()->Deallocate((void*)&m_skinningMats);
 		//ozz::memory::default_allocator()->Deallocate((void*)&m_meshes);
 
+		MEGA_REMOVE_DEBUG_PANELS(this);
 		return eMegaResult::SUCCESS;
 	}
 	eMegaResult AnimationSystem::OnUpdate(const tTimestep in_dt, Scene* in_pScene)
 	{
-		auto view = in_pScene->GetRegistry().view<Component::AnimatedModel>();
+		entt::registry& registry = in_pScene->GetRegistry();
+		auto view = registry.view<Component::AnimatedModel>();
+		uint32_t playingCount = 0;
 		for (auto [entity, model] : view.each())
 		{
-			if (!model.IsPlaying()) { continue; }
-
-			ImGui::Text("Playing Animation");
+			// Jobs never outlive the tick, even unrun ones, since they may be in frame memory
+			if (!model.IsPlaying() || registry.all_of<Component::Disabled>(entity))
+			{
+				model.ClearAnimationJobs();
+				continue;
+			}
+			playingCount++;
 
 			const ozz::vector<ozz::sample::Mesh>& meshes = m_meshes[model.mesh.meshIndex];
 			const ozz::animation::Skeleton& skeleton = m_skeletons[model.skeleton.skeletonIndex];
@@ -81,10 +109,27 @@ namespace Mega
 			// Clear the animation jobs
 			model.ClearAnimationJobs();
 		}
+		SetTouchedCount(playingCount);
+		Telemetry::Set(g_playingModelCounter, playingCount);
 
 		return eMegaResult::SUCCESS;
 	}
 
+	void AnimationSystem::DeclareAccess(SystemAccess& in_access) const
+	{
+		in_access.Writes<Component::AnimatedModel>();
+		in_access.Writes<Component::Transform>(); // Joint attachment jobs move the attached entity
+		in_access.Reads<Component::Disabled>();
+	}
+
+#ifndef MEGA_DISABLE_DEBUG_UI
+	void AnimationSystem::BuildDebugPanel()
+	{
+		ImGui::DragFloat("Animation Speed", &m_playbackSpeed, 0.01f);
+		ImGui::Text("Playing models: %lld", (long long)Telemetry::GetValue(g_playingModelCounter));
+	}
+#endif
+
 	// ============== Loaders =========================== //
 	AnimatedMesh AnimationSystem::LoadAnimatedMesh(const tFilePath in_filePath)
 	{
@@ -112,6 +157,7 @@ namespace Mega
 		// Allocates skinning matrices.
 		m_skinningMats.resize(m_maxSkinningMats);
 		m_glmModels.resize(m_glmModels.size() + m_maxSkinningMats);
+		MemoryTracker::SetTrackedBytes(eMemoryTag::Animation, m_trackedGLMModelBytes, m_glmModels.capacity() * sizeof(Mat4x4));
 
 		// Get highest joint index
 		uint32_t highestJointIndex = 0;
@@ -38,6 +38,8 @@ namespace Mega
 		eMegaResult OnInitialize() override;
 		eMegaResult OnDestroy() override;
 		eMegaResult OnUpdate(const tTimestep in_dt, Scene* in_pScene) override;
+		const char* GetName() const override { return "AnimationSystem"; }
+		void DeclareAccess(SystemAccess& in_access) const override;
 
 		// Getters
 		inline const std::vector<Mat4x4>& GetModelMatData() const { return m_glmModels; }
@@ -48,6 +50,10 @@ namespace Mega
 		Animation LoadAnimation(const tFilePath in_filePath);
 
 	private:
+#ifndef MEGA_DISABLE_DEBUG_UI
+		void BuildDebugPanel();
+#endif
+
 		std::vector<ozz::vector<ozz::sample::Mesh>> m_meshes;
 
 		ozz::animation::SamplingJob::Context m_contexts[MAX_BLEND_LAYERS]; // stores 'hot keys' used during sampling
@@ -57,6 +63,8 @@ namespace Mega
 		ozz::vector<ozz::math::Float4x4> m_models{}; // model space matrices
 
 		std::vector<Mat4x4> m_glmModels{}; // world space matrices in GLM column major format for skinning and displaying graphics
+		size_t m_trackedGLMModelBytes = 0; // Reported to the MemoryTracker, the ozz buffers are counted by its allocator
+		float m_playbackSpeed = 1.0f; // Scales the time every playback job advances by
 
 		static const uint32_t m_maxLayersCount = MAX_BLEND_LAYERS;
 		uint32_t m_maxSOAJointsCount = 0;
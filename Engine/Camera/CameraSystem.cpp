@@ -41,11 +41,14 @@ namespace Mega
 		//m_stateMachine.AddState(eMovementState::Idle, &CharacterController::OnUpdateIdle);
 		//SetState(eMovementState::Idle);
 
+		MEGA_ADD_DEBUG_PANEL(this, "Camera", [this]() { BuildDebugPanel(); });
+
 		return eMegaResult::SUCCESS;
 	}
 
 	eMegaResult CameraSystem::OnDestroy()
 	{
+		MEGA_REMOVE_DEBUG_PANELS(this);
 		delete m_pActiveCamera;
 
 		return eMegaResult::SUCCESS;
@@ -74,20 +77,17 @@ namespace Mega
 
 		// Use camera target component to calculate camera position
 		const Vec3& currentPos = m_pActiveCamera->GetPosition();
-		const Vec3& playerPos = targetsTransform->GetPosition();
+		// Runs once per drawn frame (not per tick), following where the target is drawn keeps it from jittering
+		const Vec3 playerPos = Vec3(targetsTransform->GetInterpolatedTransform(Engine::GetInterpolationAlpha())[3]);
 		// Rotation is in euler angles, so use yaw to get 2D facing vector
 		const Vec2& facing = GetDirectionVector(targetsTransform->GetRotation().y);
 		const Vec3& playerDir = Vec3(facing.x, 0.0f, facing.y);
 
-		
-		ImGui::Checkbox("Lock Camera", &g_lockCamera);
 		if (g_lockCamera) { return eMegaResult::SUCCESS; }
 		switch (cameraTarget->GetState()) // TODO: camera state should be member variable of system? "Manual" state shouldn't need a target
 		{
 			case CameraTarget::eCameraState::Manual:
 			{
-				ImGui::DragFloat3("Camera Position", &g_camPos.x, 0.01f);
-				ImGui::DragFloat3("Camera Look At", &g_camLookAt.x, 0.01f);
 				m_pActiveCamera->SetPosition(g_camPos);
 				m_pActiveCamera->LookAtPoint(g_camLookAt);
 
@@ -152,4 +152,19 @@ namespace Mega
 
 		return eMegaResult::SUCCESS;
 	}
+
+	void CameraSystem::DeclareAccess(SystemAccess& in_access) const
+	{
+		in_access.Reads<Component::Transform, Component::CameraTarget>();
+	}
+
+#ifndef MEGA_DISABLE_DEBUG_UI
+	void CameraSystem::BuildDebugPanel()
+	{
+		ImGui::Checkbox("Lock Camera", &g_lockCamera);
+		// Used by targets in the manual state
+		ImGui::DragFloat3("Camera Position", &g_camPos.x, 0.01f);
+		ImGui::DragFloat3("Camera Look At", &g_camLookAt.x, 0.01f);
+	}
+#endif
 } // namespace Mega
\ No newline at end of file
@@ -22,10 +22,16 @@ namespace Mega
 		eMegaResult OnInitialize() override;
 		eMegaResult OnDestroy() override;
 		eMegaResult OnUpdate(const tTimestep in_dt, Scene* in_pScene) override;
+		const char* GetName() const override { return "CameraSystem"; }
+		void DeclareAccess(SystemAccess& in_access) const override;
 
 		inline const EulerCamera* GetActiveCamera() const { return m_pActiveCamera; }
 
 	private:
+#ifndef MEGA_DISABLE_DEBUG_UI
+		void BuildDebugPanel();
+#endif
+
 		EulerCamera* m_pActiveCamera = nullptr;
 
 		// Camera state
@@ -2,6 +2,8 @@
 
 #include "Engine/Core/Time.h"
 #include "Engine/Core/Debug.h"
+#include "Engine/Core/DebugUI.h"
+#include "Engine/Core/Profiler.h"
 #include "Engine/Core/Math/Math.h"
 #include "Engine/Core/StateMachine.h"
 #include "Engine/Core/StateController.h"
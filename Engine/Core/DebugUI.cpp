@@ -0,0 +1,72 @@
+#include "DebugUI.h"
+
+#ifndef MEGA_DISABLE_DEBUG_UI
+#include <iterator>
+#include <algorithm>
+
+#include "ImGui/imgui.h"
+
+namespace Mega
+{
+	std::vector<DebugUI::Panel> DebugUI::s_panels;
+	bool DebugUI::s_isDrawing = false;
+	std::vector<DebugUI::Panel> DebugUI::s_addedPanels;
+
+	void DebugUI::AddPanel(const void* in_pOwner, const char* in_name, tBuildFunction in_buildFunction, const bool in_isOpen)
+	{
+		std::vector<Panel>& panels = s_isDrawing ? s_addedPanels : s_panels;
+		panels.push_back({ in_pOwner, in_name, std::move(in_buildFunction), in_isOpen });
+	}
+	void DebugUI::RemovePanels(const void* in_pOwner)
+	{
+		const auto isOwned = [in_pOwner](const Panel& in_panel) { return in_panel.pOwner == in_pOwner; };
+		s_addedPanels.erase(std::remove_if(s_addedPanels.begin(), s_addedPanels.end(), isOwned), s_addedPanels.end());
+
+		if (!s_isDrawing)
+		{
+			s_panels.erase(std::remove_if(s_panels.begin(), s_panels.end(), isOwned), s_panels.end());
+			return;
+		}
+
+		// The panel being built may be one of them, its function can not be destroyed while it runs
+		for (Panel& panel : s_panels)
+		{
+			if (isOwned(panel)) { panel.isRemoved = true; }
+		}
+	}
+
+	void DebugUI::Draw()
+	{
+		if (ImGui::Begin("Debug Panels"))
+		{
+			for (Panel& panel : s_panels)
+			{
+				ImGui::Checkbox(panel.name, &panel.isOpen);
+			}
+		}
+		ImGui::End();
+
+		s_isDrawing = true;
+		for (Panel& panel : s_panels)
+		{
+			if (!panel.isOpen || panel.isRemoved) { continue; }
+
+			// Begin returns false when the window is collapsed or clipped, nothing in it would be seen
+			if (ImGui::Begin(panel.name, &panel.isOpen))
+			{
+				panel.buildFunction();
+			}
+			ImGui::End();
+		}
+		s_isDrawing = false;
+
+		// Whatever the panels changed about the list
+		s_panels.erase(std::remove_if(s_panels.begin(), s_panels.end(), [](const Panel& in_panel) { return in_panel.isRemoved; }), s_panels.end());
+		if (!s_addedPanels.empty())
+		{
+			std::move(s_addedPanels.begin(), s_addedPanels.end(), std::back_inserter(s_panels));
+			s_addedPanels.clear();
+		}
+	}
+} // namespace Mega
+#endif
\ No newline at end of file
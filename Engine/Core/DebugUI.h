@@ -0,0 +1,58 @@
+#pragma once
+
+#include <vector>
+#include <functional>
+
+// Release builds (NDEBUG) compile every debug panel out unless MEGA_ENABLE_DEBUG_UI is defined, defining
+// MEGA_DISABLE_DEBUG_UI does the same in any build. Panels are added through the macros so their build functions
+// are not even compiled when it is off
+#if defined(NDEBUG) && !defined(MEGA_ENABLE_DEBUG_UI) && !defined(MEGA_DISABLE_DEBUG_UI)
+#define MEGA_DISABLE_DEBUG_UI
+#endif
+
+#ifndef MEGA_DISABLE_DEBUG_UI
+#define MEGA_ADD_DEBUG_PANEL(pOwner, name, ...) ::Mega::DebugUI::AddPanel(pOwner, name, __VA_ARGS__)
+#define MEGA_REMOVE_DEBUG_PANELS(pOwner) ::Mega::DebugUI::RemovePanels(pOwner)
+#else
+#define MEGA_ADD_DEBUG_PANEL(pOwner, name, ...)
+#define MEGA_REMOVE_DEBUG_PANELS(pOwner)
+#endif
+
+#ifndef MEGA_DISABLE_DEBUG_UI
+namespace Mega
+{
+	// Debug windows that systems register once instead of calling ImGui from their updates. The engine lists them in a
+	// "Debug Panels" window and only runs the build function of a panel that is open (and not collapsed), on the main
+	// thread between ticks, so building one never races with the systems' jobs. Names must outlive the panel (string
+	// literals) since only the pointer is kept. Main thread only
+	class DebugUI final
+	{
+	public:
+		using tBuildFunction = std::function<void()>;
+
+		DebugUI() = delete;
+
+		// The owner is only used to remove its panels again, usually the registering system
+		static void AddPanel(const void* in_pOwner, const char* in_name, tBuildFunction in_buildFunction, const bool in_isOpen = false);
+		static void RemovePanels(const void* in_pOwner);
+
+		// Builds the panel list and every open panel, inside an ImGui frame
+		static void Draw();
+
+	private:
+		struct Panel
+		{
+			const void* pOwner = nullptr;
+			const char* name = nullptr;
+			tBuildFunction buildFunction;
+			bool isOpen = false;
+			bool isRemoved = false; // By a panel while Draw ran, erased once it is done
+		};
+		static std::vector<Panel> s_panels;
+
+		// Panels can add or remove panels while they are built, the list only changes once Draw is done with it
+		static bool s_isDrawing;
+		static std::vector<Panel> s_addedPanels;
+	};
+} // namespace Mega
+#endif
\ No newline at end of file
@@ -0,0 +1,116 @@
+#include "FrameAllocator.h"
+
+#include <new>
+#include <mutex>
+#include <atomic>
+#include <cstdlib>
+#include <algorithm>
+
+#include "Engine/Core/Debug.h"
+#include "Engine/Core/MemoryTracker.h"
+
+namespace Mega
+{
+	namespace
+	{
+		std::mutex g_allocatorsMutex;
+		std::vector<std::unique_ptr<FrameAllocator>> g_pAllocators; // Kept for the whole run, a thread's blocks are reused by its next frame
+		thread_local FrameAllocator* t_pAllocator = nullptr;
+		thread_local bool t_isFrameThread = false;
+
+		std::atomic<uint64_t> g_heapAllocationCount = 0;
+	}
+
+	FrameAllocator& FrameAllocator::Get()
+	{
+		MEGA_ASSERT(t_isFrameThread, "Using frame memory on a thread that outlives frames");
+
+		if (!t_pAllocator)
+		{
+			std::lock_guard<std::mutex> lock(g_allocatorsMutex);
+			t_pAllocator = g_pAllocators.emplace_back(std::make_unique<FrameAllocator>()).get();
+		}
+		return *t_pAllocator;
+	}
+	void FrameAllocator::RegisterFrameThread()
+	{
+		t_isFrameThread = true;
+	}
+	void FrameAllocator::ResetAll()
+	{
+		std::lock_guard<std::mutex> lock(g_allocatorsMutex);
+		for (const std::unique_ptr<FrameAllocator>& pAllocator : g_pAllocators)
+		{
+			pAllocator->Reset();
+		}
+	}
+
+	size_t FrameAllocator::GetTotalUsedBytes()
+	{
+		std::lock_guard<std::mutex> lock(g_allocatorsMutex);
+
+		size_t out_bytes = 0;
+		for (const std::unique_ptr<FrameAllocator>& pAllocator : g_pAllocators)
+		{
+			out_bytes += pAllocator->GetUsedBytes();
+		}
+		return out_bytes;
+	}
+	uint64_t FrameAllocator::GetHeapAllocationCount()
+	{
+		return g_heapAllocationCount.load(std::memory_order_relaxed);
+	}
+
+	void* FrameAllocator::Allocate(const size_t in_size, const size_t in_alignment)
+	{
+		MEGA_ASSERT(in_alignment > 0 && (in_alignment & (in_alignment - 1)) == 0, "Frame allocations must be aligned to a power of two");
+
+		// Bump through the kept blocks first, a new block is only made the first time a frame needs this much
+		while (m_blockIndex < m_blocks.size())
+		{
+			Block& block = m_blocks[m_blockIndex];
+			const uintptr_t address = (uintptr_t)block.pData.get() + m_offset;
+			const size_t padding = (in_alignment - address % in_alignment) % in_alignment;
+			if (m_offset + padding + in_size <= block.size)
+			{
+				m_offset += padding + in_size;
+				m_usedBytes += padding + in_size;
+				return (void*)(address + padding);
+			}
+
+			m_blockIndex++;
+			m_offset = 0;
+		}
+
+		// new[] is aligned for any fundamental type, bigger alignments get room to be padded to
+		const size_t blockSize = std::max<size_t>(FRAME_ALLOCATOR_BLOCK_SIZE, in_size + in_alignment);
+		m_blocks.push_back({ std::make_unique<uint8_t[]>(blockSize), blockSize });
+		MemoryTracker::Allocate(eMemoryTag::Frame, blockSize);
+		return Allocate(in_size, in_alignment);
+	}
+
+	void FrameAllocator::Reset()
+	{
+		m_blockIndex = 0;
+		m_offset = 0;
+		m_usedBytes = 0;
+	}
+} // namespace Mega
+
+#ifdef MEGA_TRACK_HEAP_ALLOCATIONS
+// Counts every heap allocation in the program, the array and nothrow forms go through these by default
+void* operator new(std::size_t in_size)
+{
+	Mega::g_heapAllocationCount.fetch_add(1, std::memory_order_relaxed);
+	if (void* pMemory = std::malloc(in_size > 0 ? in_size : 1)) { return pMemory; }
+	throw std::bad_alloc();
+}
+void operator delete(void* in_pMemory) noexcept
+{
+	std::free(in_pMemory);
+}
+void operator delete(void* in_pMemory, std::size_t) noexcept
+{
+	std::free(in_pMemory);
+}
+#endif
\ No newline at end of file
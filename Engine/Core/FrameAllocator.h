@@ -0,0 +1,105 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+// Size of each block a frame allocator grows by, allocations bigger than it get a block of their own
+#define FRAME_ALLOCATOR_BLOCK_SIZE (256 * 1024)
+
+// Defining MEGA_TRACK_HEAP_ALLOCATIONS replaces the global operator new with one that counts every call, so the
+// engine can flag frames that still touch the heap once the game has warmed up (see EngineSettings)
+
+namespace Mega
+{
+	// Bump allocator for memory that is only needed until the end of the frame. Every thread that runs frame work (the
+	// main thread and the job system's workers) has its own, so allocating never locks. Blocks are kept across frames
+	// and the engine rewinds every allocator once a frame has been drawn, so a steady frame never reaches the heap.
+	// Nothing is destructed on reset, objects that own memory of their own must be destructed by their user
+	class FrameAllocator final
+	{
+	public:
+		// The calling thread's allocator
+		static FrameAllocator& Get();
+		// Marks the calling thread as running frame work, other threads (the scene loading thread) outlive frames
+		// and can not use frame memory
+		static void RegisterFrameThread();
+		// Rewinds every thread's allocator. Called by the engine at the end of a frame, while no frame work is running
+		static void ResetAll();
+
+		static size_t GetTotalUsedBytes(); // By every thread this frame
+		static uint64_t GetHeapAllocationCount(); // Calls to operator new so far, always 0 without MEGA_TRACK_HEAP_ALLOCATIONS
+		static constexpr bool IsTrackingHeapAllocations()
+		{
+#ifdef MEGA_TRACK_HEAP_ALLOCATIONS
+			return true;
+#else
+			return false;
+#endif
+		}
+
+		FrameAllocator() = default;
+
+		// Handed out memory lives in the blocks, so the allocator is not copyable or movable
+		FrameAllocator(const FrameAllocator&) = delete;
+		FrameAllocator(FrameAllocator&&) = delete;
+		FrameAllocator& operator=(const FrameAllocator&) = delete;
+		FrameAllocator& operator=(FrameAllocator&&) = delete;
+
+		void* Allocate(const size_t in_size, const size_t in_alignment);
+
+		template<typename T, class... Args>
+		T* New(Args&&... in_args)
+		{
+			return new (Allocate(sizeof(T), alignof(T))) T(std::forward<Args>(in_args)...);
+		}
+
+		inline size_t GetUsedBytes() const { return m_usedBytes; }
+
+	private:
+		void Reset();
+
+		struct Block
+		{
+			std::unique_ptr<uint8_t[]> pData;
+			size_t size = 0;
+		};
+		std::vector<Block> m_blocks;
+		size_t m_blockIndex = 0; // Block being allocated from
+		size_t m_offset = 0; // Into that block
+		size_t m_usedBytes = 0;
+	};
+
+	// Lets standard containers keep their elements in frame memory, see tFrameVector. Deallocating does nothing, the
+	// memory comes back when the frame ends
+	template<typename T>
+	class FrameAllocatorAdaptor
+	{
+	public:
+		using value_type = T;
+
+		FrameAllocatorAdaptor()
+			: m_pAllocator(&FrameAllocator::Get()) {}
+		template<typename U>
+		FrameAllocatorAdaptor(const FrameAllocatorAdaptor<U>& in_other)
+			: m_pAllocator(in_other.m_pAllocator) {}
+
+		inline T* allocate(const size_t in_count) { return static_cast<T*>(m_pAllocator->Allocate(in_count * sizeof(T), alignof(T))); }
+		inline void deallocate(T*, const size_t) {}
+
+		template<typename U>
+		inline bool operator==(const FrameAllocatorAdaptor<U>& in_other) const { return m_pAllocator == in_other.m_pAllocator; }
+		template<typename U>
+		inline bool operator!=(const FrameAllocatorAdaptor<U>& in_other) const { return m_pAllocator != in_other.m_pAllocator; }
+
+	private:
+		template<typename U> friend class FrameAllocatorAdaptor;
+
+		FrameAllocator* m_pAllocator = nullptr;
+	};
+
+	template<typename T>
+	using tFrameVector = std::vector<T, FrameAllocatorAdaptor<T>>;
+} // namespace Mega
\ No newline at end of file
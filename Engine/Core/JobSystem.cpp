@@ -0,0 +1,269 @@
+#include "JobSystem.h"
+
+#include <string>
+#include <algorithm>
+
+#include "Engine/Core/Debug.h"
+#include "Engine/Core/Profiler.h"
+#include "Engine/Core/FrameAllocator.h"
+
+namespace Mega
+{
+	namespace
+	{
+		thread_local uint32_t t_threadIndex = JOB_SYSTEM_NO_THREAD_INDEX; // See GetThreadIndex
+
+		// Which queue the calling thread pushes to and pops from first, threads without an index use the main thread's
+		inline uint32_t GetQueueIndex() { return t_threadIndex == JOB_SYSTEM_NO_THREAD_INDEX ? 0 : t_threadIndex; }
+	}
+
+	void JobSystem::Initialize(const uint32_t in_workerCount)
+	{
+		MEGA_ASSERT(m_queues.empty(), "Job system already initialized");
+
+		t_threadIndex = 0; // The main thread
+
+		m_isStopping = false;
+		m_queues.resize((size_t)in_workerCount + 1);
+		for (auto& pQueue : m_queues)
+		{
+			pQueue = std::make_unique<WorkQueue>();
+		}
+
+		m_threads.reserve(in_workerCount);
+		for (uint32_t i = 0; i < in_workerCount; i++)
+		{
+			m_threads.emplace_back(&JobSystem::WorkerLoop, this, i + 1);
+		}
+
+		m_isBlockingStopping = false;
+		m_blockingThread = std::thread(&JobSystem::BlockingLoop, this);
+	}
+	void JobSystem::Destroy()
+	{
+		// Blocking jobs may still queue work for the workers, so they finish first
+		{
+			std::lock_guard<std::mutex> lock(m_blockingMutex);
+			m_isBlockingStopping = true;
+		}
+		m_blockingCondition.notify_all();
+		if (m_blockingThread.joinable()) { m_blockingThread.join(); }
+
+		{
+			std::lock_guard<std::mutex> lock(m_sleepMutex);
+			m_isStopping = true;
+		}
+		m_sleepCondition.notify_all();
+
+		for (std::thread& thread : m_threads)
+		{
+			thread.join();
+		}
+		m_threads.clear();
+		m_queues.clear();
+		m_queuedCount = 0;
+	}
+
+	uint32_t JobSystem::GetThreadIndex()
+	{
+		return t_threadIndex;
+	}
+
+	void JobSystem::Run(tJob in_job, JobCounter* in_pCounter)
+	{
+		if (in_pCounter) { in_pCounter->m_count.fetch_add(1, std::memory_order_relaxed); }
+
+		Push({ std::move(in_job), in_pCounter });
+	}
+
+	void JobSystem::RunBlocking(tJob in_job, JobCounter* in_pCounter)
+	{
+		MEGA_ASSERT(m_blockingThread.joinable(), "Running a job before the job system is initialized");
+		if (in_pCounter) { in_pCounter->m_count.fetch_add(1, std::memory_order_relaxed); }
+
+		{
+			std::lock_guard<std::mutex> lock(m_blockingMutex);
+			m_blockingJobs.push_back({ std::move(in_job), in_pCounter });
+		}
+		m_blockingCondition.notify_one();
+	}
+
+	void JobSystem::RunAfter(JobCounter& in_dependency, tJob in_job, JobCounter* in_pCounter)
+	{
+		if (in_pCounter) { in_pCounter->m_count.fetch_add(1, std::memory_order_relaxed); }
+
+		{
+			// Checked under the lock so the dependency can not finish between the check and storing the continuation
+			std::lock_guard<std::mutex> lock(in_dependency.m_continuationMutex);
+			if (!in_dependency.IsDone())
+			{
+				in_dependency.m_continuations.push_back({ std::move(in_job), in_pCounter });
+				return;
+			}
+		}
+
+		Push({ std::move(in_job), in_pCounter });
+	}
+
+	void JobSystem::Wait(const JobCounter& in_counter)
+	{
+		const bool canRunJobs = HasThreadIndex();
+
+		Job job;
+		while (!in_counter.IsDone())
+		{
+			if (canRunJobs && TryPop(job))
+			{
+				Execute(job);
+			}
+			else
+			{
+				// What we are waiting on is running on another thread
+				std::this_thread::yield();
+			}
+		}
+	}
+
+	void JobSystem::ParallelFor(const uint32_t in_begin, const uint32_t in_end, const uint32_t in_grainSize, const tRangeJob& in_job)
+	{
+		if (in_begin >= in_end) { return; }
+
+		const uint32_t grainSize = std::max(in_grainSize, 1u);
+
+		// Hand out every chunk but the first, which the calling thread runs itself
+		JobCounter counter;
+		for (uint32_t begin = in_begin + grainSize; begin < in_end; begin += grainSize)
+		{
+			const uint32_t end = std::min(begin + grainSize, in_end);
+			Run([&in_job, begin, end]() { in_job(begin, end); }, &counter);
+		}
+
+		in_job(in_begin, std::min(in_begin + grainSize, in_end));
+		Wait(counter);
+	}
+
+	void JobSystem::WorkerLoop(const uint32_t in_queueIndex)
+	{
+		t_threadIndex = in_queueIndex;
+
+		const std::string name = "Worker " + std::to_string(in_queueIndex - 1);
+		Profiler::SetThreadName(name.c_str());
+		FrameAllocator::RegisterFrameThread(); // For jobs the frame waits on, loading jobs that span frames must not use it
+
+		Job job;
+		while (true)
+		{
+			if (TryPop(job))
+			{
+				Execute(job);
+				continue;
+			}
+
+			std::unique_lock<std::mutex> lock(m_sleepMutex);
+			m_sleepCondition.wait(lock, [this]() { return m_isStopping || m_queuedCount.load(std::memory_order_acquire) > 0; });
+			if (m_isStopping) { return; }
+		}
+	}
+
+	void JobSystem::BlockingLoop()
+	{
+		Profiler::SetThreadName("I/O");
+
+		// Drains the queue before stopping, whoever queued a job may be waiting on its counter
+		Job job;
+		while (true)
+		{
+			{
+				std::unique_lock<std::mutex> lock(m_blockingMutex);
+				m_blockingCondition.wait(lock, [this]() { return m_isBlockingStopping || !m_blockingJobs.empty(); });
+				if (m_blockingJobs.empty()) { return; }
+
+				job = std::move(m_blockingJobs.front());
+				m_blockingJobs.pop_front();
+			}
+
+			Execute(job);
+		}
+	}
+
+	void JobSystem::Push(Job&& in_job)
+	{
+		MEGA_ASSERT(!m_queues.empty(), "Running a job before the job system is initialized");
+
+		WorkQueue& queue = *m_queues[GetQueueIndex()];
+		{
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			queue.jobs.push_back(std::move(in_job));
+		}
+
+		// Bump the count under the sleep lock so a worker can not check it and then miss the notify
+		{
+			std::lock_guard<std::mutex> lock(m_sleepMutex);
+			m_queuedCount.fetch_add(1, std::memory_order_release);
+		}
+		m_sleepCondition.notify_one();
+	}
+
+	bool JobSystem::TryPop(Job& out_job)
+	{
+		const uint32_t queueCount = (uint32_t)m_queues.size();
+		if (queueCount == 0 || m_queuedCount.load(std::memory_order_acquire) == 0) { return false; }
+
+		// Own queue first (newest job), then steal the oldest job from everyone else
+		{
+			WorkQueue& queue = *m_queues[GetQueueIndex()];
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			if (!queue.jobs.empty())
+			{
+				out_job = std::move(queue.jobs.back());
+				queue.jobs.pop_back();
+				m_queuedCount.fetch_sub(1, std::memory_order_relaxed);
+				return true;
+			}
+		}
+
+		for (uint32_t i = 1; i < queueCount; i++)
+		{
+			WorkQueue& queue = *m_queues[(GetQueueIndex() + i) % queueCount];
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			if (!queue.jobs.empty())
+			{
+				out_job = std::move(queue.jobs.front());
+				queue.jobs.pop_front();
+				m_queuedCount.fetch_sub(1, std::memory_order_relaxed);
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	void JobSystem::Execute(Job& in_job)
+	{
+		in_job.function();
+		in_job.function = nullptr;
+
+		Finish(in_job.pCounter);
+	}
+
+	void JobSystem::Finish(JobCounter* in_pCounter)
+	{
+		if (!in_pCounter) { return; }
+
+		// Decremented under the lock so RunAfter never sees a counter between hitting zero and being drained, and so
+		// the counter's destructor waits for us to be done with it
+		std::vector<JobCounter::Continuation> continuations;
+		{
+			std::lock_guard<std::mutex> lock(in_pCounter->m_continuationMutex);
+			if (in_pCounter->m_count.fetch_sub(1, std::memory_order_acq_rel) != 1) { return; }
+
+			// Last job on this counter, release anything that was waiting for it
+			continuations.swap(in_pCounter->m_continuations);
+		}
+
+		for (JobCounter::Continuation& continuation : continuations)
+		{
+			Push({ std::move(continuation.function), continuation.pCounter });
+		}
+	}
+} // namespace Mega
\ No newline at end of file
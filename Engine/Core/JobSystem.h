@@ -0,0 +1,135 @@
+#pragma once
+
+#include <mutex>
+#include <deque>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <functional>
+#include <condition_variable>
+
+#define JOB_SYSTEM_NO_THREAD_INDEX UINT32_MAX
+
+namespace Mega
+{
+	class JobSystem;
+
+	// Counts unfinished jobs. Jobs given a counter increment it when submitted and decrement it when they finish,
+	// so waiting on a counter waits on every job attached to it. Jobs can also be queued to run once a counter
+	// reaches zero (see JobSystem::RunAfter)
+	class JobCounter
+	{
+	public:
+		friend JobSystem;
+
+		JobCounter() = default;
+		~JobCounter() { std::lock_guard<std::mutex> lock(m_continuationMutex); } // The job that finished the counter may still hold the lock
+
+		// Counters are referenced by running jobs, so they are not copyable or movable
+		JobCounter(const JobCounter&) = delete;
+		JobCounter(JobCounter&&) = delete;
+		JobCounter& operator=(const JobCounter&) = delete;
+		JobCounter& operator=(JobCounter&&) = delete;
+
+		inline bool IsDone() const { return m_count.load(std::memory_order_acquire) == 0; }
+
+	private:
+		struct Continuation
+		{
+			std::function<void()> function;
+			JobCounter* pCounter = nullptr;
+		};
+
+		std::atomic<uint32_t> m_count = 0;
+
+		std::mutex m_continuationMutex;
+		std::vector<Continuation> m_continuations;
+	};
+
+	// Work stealing job system. Every worker owns a deque it pushes and pops at the back (newest work first, keeps
+	// caches warm) while idle workers steal from the front of other deques. The main thread owns queue 0, threads
+	// outside the job system push to it as well. A thread waiting on a counter keeps running jobs instead of blocking
+	class JobSystem final
+	{
+	public:
+		using tJob = std::function<void()>;
+		using tRangeJob = std::function<void(uint32_t in_begin, uint32_t in_end)>;
+
+		JobSystem() = default;
+		~JobSystem() { Destroy(); }
+
+		// Not copyable or movable
+		JobSystem(const JobSystem&) = delete;
+		JobSystem(JobSystem&&) = delete;
+		JobSystem& operator=(const JobSystem&) = delete;
+		JobSystem& operator=(JobSystem&&) = delete;
+
+		void Initialize(const uint32_t in_workerCount);
+		void Destroy();
+
+		// Queues a job, in_pCounter (optional) is incremented now and decremented once the job has run
+		void Run(tJob in_job, JobCounter* in_pCounter = nullptr);
+
+		// Queues in_job once in_dependency reaches zero (runs it right away if it already has)
+		void RunAfter(JobCounter& in_dependency, tJob in_job, JobCounter* in_pCounter = nullptr);
+
+		// Queues a job that blocks (reads files, waits on the main thread) on the job system's I/O thread. Its queue is
+		// never popped by workers or waiting threads, so nothing that waits on a frame's jobs can pick one up and stall
+		// behind it. Jobs run one at a time, in order
+		void RunBlocking(tJob in_job, JobCounter* in_pCounter = nullptr);
+
+		// Runs other jobs on the calling thread until the counter reaches zero. Threads outside the job system (see
+		// GetThreadIndex) only wait, the jobs they would pick up may use per thread data they do not have
+		void Wait(const JobCounter& in_counter);
+
+		// Splits [in_begin, in_end) into chunks of in_grainSize and runs in_job on each chunk across all threads.
+		// Returns once every chunk is done, the calling thread works on chunks too
+		void ParallelFor(const uint32_t in_begin, const uint32_t in_end, const uint32_t in_grainSize, const tRangeJob& in_job);
+
+		inline uint32_t GetWorkerCount() const { return (uint32_t)m_threads.size(); }
+
+		// 0 for the thread that initialized the job system (the main thread), worker i gets i + 1, so per thread data
+		// can live in an array of GetWorkerCount() + 1 indexed by it. Any other thread (the scene loader, the I/O
+		// thread) gets JOB_SYSTEM_NO_THREAD_INDEX, it shares no one's slot and has none of its own
+		static uint32_t GetThreadIndex();
+		static inline bool HasThreadIndex() { return GetThreadIndex() != JOB_SYSTEM_NO_THREAD_INDEX; }
+
+	private:
+		struct Job
+		{
+			tJob function;
+			JobCounter* pCounter = nullptr;
+		};
+
+		struct WorkQueue
+		{
+			std::mutex mutex;
+			std::deque<Job> jobs;
+		};
+
+		void WorkerLoop(const uint32_t in_queueIndex);
+		void BlockingLoop();
+		void Push(Job&& in_job);
+		bool TryPop(Job& out_job);
+		void Execute(Job& in_job);
+		void Finish(JobCounter* in_pCounter);
+
+		std::vector<std::thread> m_threads;
+		std::vector<std::unique_ptr<WorkQueue>> m_queues; // [0] is the main thread's (other threads push to it too), [i + 1] belongs to worker i
+
+		// Idle workers sleep until there is queued work
+		std::mutex m_sleepMutex;
+		std::condition_variable m_sleepCondition;
+		std::atomic<uint32_t> m_queuedCount = 0;
+		bool m_isStopping = false;
+
+		// Blocking jobs, see RunBlocking
+		std::thread m_blockingThread;
+		std::mutex m_blockingMutex;
+		std::condition_variable m_blockingCondition;
+		std::deque<Job> m_blockingJobs;
+		bool m_isBlockingStopping = false;
+	};
+} // namespace Mega
\ No newline at end of file
@@ -39,4 +39,29 @@ namespace Mega
 		float v = 1 - (1 - in_weight) * (1 - in_weight) * (1 - in_weight);
 		return ((start * v) + (end * (1 - v)));
 	}
+	Mat4x4 InterpolateTransform(const Mat4x4& in_from, const Mat4x4& in_to, float in_alpha)
+	{
+		if (in_alpha >= 1.0f || in_from == in_to) { return in_to; }
+		if (in_alpha <= 0.0f) { return in_from; }
+
+		// Column lengths are the scale, what is left of the upper 3x3 once they are divided out is the rotation
+		const Vec3 fromScale = Vec3(glm::length(Vec3(in_from[0])), glm::length(Vec3(in_from[1])), glm::length(Vec3(in_from[2])));
+		const Vec3 toScale = Vec3(glm::length(Vec3(in_to[0])), glm::length(Vec3(in_to[1])), glm::length(Vec3(in_to[2])));
+
+		const glm::mat3 fromRotation = glm::mat3(Vec3(in_from[0]) / fromScale.x, Vec3(in_from[1]) / fromScale.y, Vec3(in_from[2]) / fromScale.z);
+		const glm::mat3 toRotation = glm::mat3(Vec3(in_to[0]) / toScale.x, Vec3(in_to[1]) / toScale.y, Vec3(in_to[2]) / toScale.z);
+		const glm::quat rotation = glm::slerp(glm::quat_cast(fromRotation), glm::quat_cast(toRotation), in_alpha);
+
+		const Vec3 scale = glm::mix(fromScale, toScale, in_alpha);
+		const Vec3 translation = glm::mix(Vec3(in_from[3]), Vec3(in_to[3]), in_alpha);
+
+		const glm::mat3 rotationMat = glm::mat3_cast(rotation);
+		Mat4x4 out_transform = Mat4x4(1.0f);
+		out_transform[0] = Vec4(rotationMat[0] * scale.x, 0.0f);
+		out_transform[1] = Vec4(rotationMat[1] * scale.y, 0.0f);
+		out_transform[2] = Vec4(rotationMat[2] * scale.z, 0.0f);
+		out_transform[3] = Vec4(translation, 1.0f);
+
+		return out_transform;
+	}
 }
\ No newline at end of file
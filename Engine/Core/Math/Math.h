@@ -20,4 +20,8 @@ namespace Mega
 	// ===== Interpolations ========= //
 	float SquaredAcceleration(float in_weight);
 	float CubedAcceleration(float in_weight);
+
+	// Blends two transform matrices, translation and scale are lerped and rotation slerped so nothing shears or
+	// shrinks part way through a turn. in_alpha of 0 gives in_from, 1 gives in_to
+	Mat4x4 InterpolateTransform(const Mat4x4& in_from, const Mat4x4& in_to, float in_alpha);
 }
\ No newline at end of file
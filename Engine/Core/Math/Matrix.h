@@ -9,4 +9,5 @@ namespace Mega
 {
 	using Mat4x4 = glm::mat<4, 4, tScalarPrecision, glm::packed_highp>;
 	using Mat3x3F = glm::mat<4, 4, tScalarPrecision, glm::packed_highp>;
+	using Quat = glm::qua<tScalarPrecision, glm::packed_highp>;
 }
\ No newline at end of file
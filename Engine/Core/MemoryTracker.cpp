@@ -0,0 +1,179 @@
+#include "MemoryTracker.h"
+
+#include <mutex>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <algorithm>
+#include <unordered_map>
+
+#include "Engine/Core/Debug.h"
+
+namespace Mega
+{
+	MemoryTracker::TagCounters MemoryTracker::s_counters[(size_t)eMemoryTag::Count];
+
+	namespace
+	{
+		struct TrackedHandle
+		{
+			eMemoryTag tag = eMemoryTag::Count;
+			size_t bytes = 0;
+		};
+		std::mutex g_handlesMutex;
+		std::unordered_map<uint64_t, TrackedHandle> g_handles;
+
+		// Sits right before the memory AllocateTagged hands out
+		struct TaggedHeader
+		{
+			void* pBlock = nullptr; // What malloc returned, the memory is aligned forward from it
+			size_t bytes = 0;
+			eMemoryTag tag = eMemoryTag::Count;
+		};
+
+		const char* g_tagNames[(size_t)eMemoryTag::Count] = { "Animation", "Meshes", "Physics", "Audio", "Device memory", "Frame" };
+
+		double ToMB(const int64_t in_bytes) { return in_bytes / (1024.0 * 1024.0); }
+	}
+
+	void MemoryTracker::Allocate(const eMemoryTag in_tag, const size_t in_bytes)
+	{
+		TagCounters& counters = s_counters[(size_t)in_tag];
+		const int64_t liveBytes = counters.liveBytes.fetch_add((int64_t)in_bytes, std::memory_order_relaxed) + (int64_t)in_bytes;
+		counters.allocationCount.fetch_add(1, std::memory_order_relaxed);
+		counters.frameAllocationCount.fetch_add(1, std::memory_order_relaxed);
+
+		int64_t peakBytes = counters.peakBytes.load(std::memory_order_relaxed);
+		while (liveBytes > peakBytes && !counters.peakBytes.compare_exchange_weak(peakBytes, liveBytes, std::memory_order_relaxed)) {}
+	}
+	void MemoryTracker::Free(const eMemoryTag in_tag, const size_t in_bytes)
+	{
+		s_counters[(size_t)in_tag].liveBytes.fetch_sub((int64_t)in_bytes, std::memory_order_relaxed);
+	}
+	void MemoryTracker::SetTrackedBytes(const eMemoryTag in_tag, size_t& io_trackedBytes, const size_t in_bytes)
+	{
+		if (in_bytes > io_trackedBytes) { Allocate(in_tag, in_bytes - io_trackedBytes); }
+		else if (in_bytes < io_trackedBytes) { Free(in_tag, io_trackedBytes - in_bytes); }
+		io_trackedBytes = in_bytes;
+	}
+
+	void MemoryTracker::AllocateHandle(const eMemoryTag in_tag, const uint64_t in_handle, const size_t in_bytes)
+	{
+		{
+			std::lock_guard<std::mutex> lock(g_handlesMutex);
+			const bool isNew = g_handles.insert({ in_handle, { in_tag, in_bytes } }).second;
+			MEGA_ASSERT(isNew, "Tracking a memory handle twice");
+		}
+		Allocate(in_tag, in_bytes);
+	}
+	void MemoryTracker::FreeHandle(const uint64_t in_handle)
+	{
+		TrackedHandle handle;
+		{
+			std::lock_guard<std::mutex> lock(g_handlesMutex);
+			auto it = g_handles.find(in_handle);
+			if (it == g_handles.end()) { return; }
+
+			handle = it->second;
+			g_handles.erase(it);
+		}
+		Free(handle.tag, handle.bytes);
+	}
+
+	void* MemoryTracker::AllocateTagged(const eMemoryTag in_tag, const size_t in_bytes, const size_t in_alignment)
+	{
+		MEGA_ASSERT(in_alignment > 0 && (in_alignment & (in_alignment - 1)) == 0, "Tagged allocations must be aligned to a power of two");
+		const size_t alignment = std::max(in_alignment, alignof(TaggedHeader)); // The header sits right before the memory
+
+		void* pBlock = std::malloc(in_bytes + sizeof(TaggedHeader) + alignment);
+		if (!pBlock) { return nullptr; }
+
+		const uintptr_t address = ((uintptr_t)pBlock + sizeof(TaggedHeader) + alignment - 1) & ~(uintptr_t)(alignment - 1);
+		TaggedHeader* pHeader = reinterpret_cast<TaggedHeader*>(address) - 1;
+		pHeader->pBlock = pBlock;
+		pHeader->bytes = in_bytes;
+		pHeader->tag = in_tag;
+
+		Allocate(in_tag, in_bytes);
+		return (void*)address;
+	}
+	void MemoryTracker::FreeTagged(void* in_pMemory)
+	{
+		if (!in_pMemory) { return; }
+
+		const TaggedHeader* pHeader = reinterpret_cast<const TaggedHeader*>(in_pMemory) - 1;
+		Free(pHeader->tag, pHeader->bytes);
+		std::free(pHeader->pBlock);
+	}
+
+	void MemoryTracker::SetBudget(const eMemoryTag in_tag, const size_t in_bytes)
+	{
+		s_counters[(size_t)in_tag].budgetBytes = (int64_t)in_bytes;
+	}
+
+	MemoryTracker::TagStats MemoryTracker::GetStats(const eMemoryTag in_tag)
+	{
+		const TagCounters& counters = s_counters[(size_t)in_tag];
+
+		TagStats out_stats;
+		out_stats.liveBytes = counters.liveBytes.load(std::memory_order_relaxed);
+		out_stats.peakBytes = counters.peakBytes.load(std::memory_order_relaxed);
+		out_stats.allocationCount = counters.allocationCount.load(std::memory_order_relaxed);
+		out_stats.frameAllocationCount = counters.lastFrameAllocationCount;
+		out_stats.budgetBytes = counters.budgetBytes;
+		return out_stats;
+	}
+	const char* MemoryTracker::GetTagName(const eMemoryTag in_tag)
+	{
+		return g_tagNames[(size_t)in_tag];
+	}
+
+	void MemoryTracker::EndFrame()
+	{
+		for (size_t i = 0; i < (size_t)eMemoryTag::Count; i++)
+		{
+			TagCounters& counters = s_counters[i];
+			counters.lastFrameAllocationCount = counters.frameAllocationCount.exchange(0, std::memory_order_relaxed);
+
+			const bool isOverBudget = counters.budgetBytes > 0 && counters.liveBytes.load(std::memory_order_relaxed) > counters.budgetBytes;
+			if (isOverBudget && !counters.isOverBudget)
+			{
+				const std::ios_base::fmtflags flags = std::cout.flags();
+				const std::streamsize precision = std::cout.precision();
+				std::cout << std::fixed << std::setprecision(2) << "Memory budget exceeded: " << g_tagNames[i] << " is at "
+					<< ToMB(counters.liveBytes.load(std::memory_order_relaxed)) << "MB of " << ToMB(counters.budgetBytes) << "MB" << std::endl;
+				std::cout.flags(flags);
+				std::cout.precision(precision);
+			}
+			counters.isOverBudget = isOverBudget;
+		}
+	}
+
+	void MemoryTracker::PrintReport(std::ostream& in_stream)
+	{
+		in_stream << "Memory" << "\n";
+		in_stream << std::left << std::setw(16) << "Subsystem" << std::right
+			<< std::setw(12) << "Live (MB)" << std::setw(12) << "Peak (MB)" << std::setw(12) << "Budget (MB)"
+			<< std::setw(14) << "Allocations" << std::setw(12) << "Last frame" << "\n";
+
+		const std::ios_base::fmtflags flags = in_stream.flags(); // Put back at the end, the stream is usually std::cout
+		const std::streamsize precision = in_stream.precision();
+		in_stream << std::fixed << std::setprecision(2);
+		int64_t totalLiveBytes = 0;
+		for (size_t i = 0; i < (size_t)eMemoryTag::Count; i++)
+		{
+			const TagStats stats = GetStats((eMemoryTag)i);
+			totalLiveBytes += stats.liveBytes;
+
+			in_stream << std::left << std::setw(16) << g_tagNames[i] << std::right
+				<< std::setw(12) << ToMB(stats.liveBytes) << std::setw(12) << ToMB(stats.peakBytes);
+			if (stats.budgetBytes > 0) { in_stream << std::setw(12) << ToMB(stats.budgetBytes); }
+			else { in_stream << std::setw(12) << "-"; }
+			in_stream << std::setw(14) << stats.allocationCount << std::setw(12) << stats.frameAllocationCount << "\n";
+		}
+		in_stream << std::left << std::setw(16) << "Total" << std::right << std::setw(12) << ToMB(totalLiveBytes) << std::endl;
+
+		in_stream.flags(flags);
+		in_stream.precision(precision);
+	}
+} // namespace Mega
\ No newline at end of file
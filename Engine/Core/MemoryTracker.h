@@ -0,0 +1,73 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+namespace Mega
+{
+	// Subsystems memory is tracked under. Device memory is the GPU's, everything else is CPU side
+	enum class eMemoryTag : uint32_t
+	{
+		Animation = 0, // Ozz skeletons, animations, meshes, and the sampling/skinning buffers
+		Meshes = 1, // Vertex and index data the renderer keeps on the CPU after uploading it
+		Physics = 2, // Everything Bullet allocates, the world, bodies, shapes, and BVHs
+		Audio = 3, // OpenAL buffers
+		DeviceMemory = 4, // Vulkan allocations made by the renderer (not ImGui's backend)
+		Frame = 5, // The frame allocators' blocks
+		Count = 6
+	};
+
+	// Live totals, high-water marks, and per frame allocation counts of memory owned by each subsystem, against an
+	// optional budget. Subsystems report their own allocations, either as byte deltas, as handles freed later without
+	// a size, or by routing a library's allocator through AllocateTagged (Bullet and ozz). Thread safe
+	class MemoryTracker final
+	{
+	public:
+		struct TagStats
+		{
+			int64_t liveBytes = 0;
+			int64_t peakBytes = 0;
+			uint64_t allocationCount = 0; // Since startup
+			uint32_t frameAllocationCount = 0; // In the last frame
+			int64_t budgetBytes = 0; // 0 means none
+		};
+
+		MemoryTracker() = delete;
+
+		static void Allocate(const eMemoryTag in_tag, const size_t in_bytes);
+		static void Free(const eMemoryTag in_tag, const size_t in_bytes);
+		// For containers that grow in place, applies the change from io_trackedBytes to in_bytes and stores it
+		static void SetTrackedBytes(const eMemoryTag in_tag, size_t& io_trackedBytes, const size_t in_bytes);
+
+		// For allocations whose free only knows the handle (Vulkan device memory). Untracked handles are ignored
+		static void AllocateHandle(const eMemoryTag in_tag, const uint64_t in_handle, const size_t in_bytes);
+		static void FreeHandle(const uint64_t in_handle);
+
+		// Heap memory with its size and tag stored in front of it, for library allocator hooks
+		static void* AllocateTagged(const eMemoryTag in_tag, const size_t in_bytes, const size_t in_alignment = alignof(std::max_align_t));
+		static void FreeTagged(void* in_pMemory);
+
+		static void SetBudget(const eMemoryTag in_tag, const size_t in_bytes);
+		static TagStats GetStats(const eMemoryTag in_tag);
+		static const char* GetTagName(const eMemoryTag in_tag);
+
+		// Rolls the per frame counts over and reports tags that went over budget. Call once per frame from the main thread
+		static void EndFrame();
+		static void PrintReport(std::ostream& in_stream);
+
+	private:
+		struct TagCounters
+		{
+			std::atomic<int64_t> liveBytes = 0;
+			std::atomic<int64_t> peakBytes = 0;
+			std::atomic<uint64_t> allocationCount = 0;
+			std::atomic<uint32_t> frameAllocationCount = 0;
+			uint32_t lastFrameAllocationCount = 0;
+			int64_t budgetBytes = 0;
+			bool isOverBudget = false; // Reported once each time it goes over
+		};
+		static TagCounters s_counters[(size_t)eMemoryTag::Count];
+	};
+} // namespace Mega
\ No newline at end of file
@@ -0,0 +1,330 @@
+#include "Profiler.h"
+
+#include <mutex>
+#include <memory>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <string_view>
+#include <unordered_map>
+
+#include "Engine/Core/Debug.h"
+
+namespace Mega
+{
+	namespace
+	{
+		struct ZoneEvent
+		{
+			const char* name = nullptr;
+			int64_t startNs = 0;
+			int64_t endNs = 0;
+		};
+
+		// A ring buffer slot. Its owner can overwrite it while another thread reads it, so its fields are atomics
+		// and a reader checks afterwards whether the slot was reused under it (see CopyEvents)
+		struct EventSlot
+		{
+			std::atomic<const char*> name = nullptr;
+			std::atomic<int64_t> startNs = 0;
+			std::atomic<int64_t> endNs = 0;
+		};
+
+		struct OpenZone
+		{
+			const char* name = nullptr;
+			int64_t startNs = 0;
+		};
+
+		// Only the owning thread writes events. startedCount is bumped before a slot is written and writeCount after,
+		// so readers know which events are complete and which slots may be changing
+		struct ThreadBuffer
+		{
+			uint32_t threadIndex = 0;
+			std::string name;
+
+			std::unique_ptr<EventSlot[]> pEvents;
+			std::atomic<uint64_t> startedCount = 0;
+			std::atomic<uint64_t> writeCount = 0; // Total events ever written, ring index is writeCount % capacity
+			uint64_t summarizedCount = 0; // Events already folded into the frame history by EndFrame
+
+			std::vector<OpenZone> openZones;
+		};
+
+		// Rolling window of per frame totals for one zone name
+		struct ZoneHistory
+		{
+			std::vector<int64_t> samples;
+			size_t nextSample = 0;
+		};
+
+		std::mutex g_buffersMutex;
+		std::vector<std::unique_ptr<ThreadBuffer>> g_buffers;
+		thread_local ThreadBuffer* t_pBuffer = nullptr;
+
+		std::unordered_map<std::string, ZoneHistory> g_history;
+		uint32_t g_summaryFrameCount = PROFILER_DEFAULT_SUMMARY_FRAMES;
+		int64_t g_lastFrameEndNs = 0;
+		std::vector<ZoneEvent> g_frameEvents; // EndFrame's copy of a thread's new events, kept so its memory is reused
+
+		const int64_t g_epochNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+
+		inline int64_t NowNs()
+		{
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count() - g_epochNs;
+		}
+
+		ThreadBuffer& GetThreadBuffer()
+		{
+			if (!t_pBuffer)
+			{
+				std::lock_guard<std::mutex> lock(g_buffersMutex);
+
+				auto& pBuffer = g_buffers.emplace_back(std::make_unique<ThreadBuffer>());
+				pBuffer->threadIndex = (uint32_t)g_buffers.size() - 1;
+				pBuffer->name = "Thread " + std::to_string(pBuffer->threadIndex);
+				pBuffer->pEvents = std::make_unique<EventSlot[]>(PROFILER_EVENTS_PER_THREAD);
+				pBuffer->openZones.reserve(32);
+
+				t_pBuffer = pBuffer.get();
+			}
+
+			return *t_pBuffer;
+		}
+
+		// Copies a thread's complete events from in_first on (older ones may already be overwritten) and returns the
+		// write count copied up to. Slots its owner started reusing while they were copied are dropped afterwards
+		uint64_t CopyEvents(const ThreadBuffer& in_buffer, const uint64_t in_first, std::vector<ZoneEvent>& out_events)
+		{
+			out_events.clear();
+
+			const uint64_t writeCount = in_buffer.writeCount.load(std::memory_order_acquire);
+			const uint64_t first = std::max(in_first, writeCount > PROFILER_EVENTS_PER_THREAD ? writeCount - PROFILER_EVENTS_PER_THREAD : 0);
+			for (uint64_t i = first; i < writeCount; i++)
+			{
+				const EventSlot& slot = in_buffer.pEvents[i % PROFILER_EVENTS_PER_THREAD];
+				out_events.push_back({ slot.name.load(std::memory_order_relaxed), slot.startNs.load(std::memory_order_relaxed), slot.endNs.load(std::memory_order_relaxed) });
+			}
+
+			// Event i's slot is reused by event i + capacity. Pairs with the owner's fence in EndZone, any slot read
+			// after it started being rewritten shows up in startedCount
+			std::atomic_thread_fence(std::memory_order_acquire);
+			const uint64_t startedCount = in_buffer.startedCount.load(std::memory_order_relaxed);
+			if (startedCount > first + PROFILER_EVENTS_PER_THREAD)
+			{
+				const uint64_t reusedCount = std::min<uint64_t>(startedCount - PROFILER_EVENTS_PER_THREAD - first, out_events.size());
+				out_events.erase(out_events.begin(), out_events.begin() + (ptrdiff_t)reusedCount);
+			}
+
+			return writeCount;
+		}
+
+		void PushSample(const std::string_view in_name, const int64_t in_durationNs)
+		{
+			ZoneHistory& history = g_history[std::string(in_name)];
+			if (history.samples.size() < g_summaryFrameCount)
+			{
+				history.samples.push_back(in_durationNs);
+			}
+			else
+			{
+				history.samples[history.nextSample] = in_durationNs;
+			}
+			history.nextSample = (history.nextSample + 1) % g_summaryFrameCount;
+		}
+
+		void WriteJsonString(std::ostream& in_stream, const std::string_view in_string)
+		{
+			in_stream << '"';
+			for (const char c : in_string)
+			{
+				if (c == '"' || c == '\\') { in_stream << '\\'; }
+				in_stream << c;
+			}
+			in_stream << '"';
+		}
+	}
+
+	std::atomic<bool> Profiler::s_isEnabled = false;
+
+	void Profiler::SetEnabled(const bool in_isEnabled)
+	{
+		s_isEnabled.store(in_isEnabled, std::memory_order_relaxed);
+	}
+
+	void Profiler::SetSummaryFrameCount(const uint32_t in_frameCount)
+	{
+		MEGA_ASSERT(in_frameCount > 0, "Profiler needs at least one frame to summarize");
+
+		g_summaryFrameCount = in_frameCount;
+		g_history.clear();
+	}
+
+	void Profiler::SetThreadName(const char* in_name)
+	{
+		ThreadBuffer& buffer = GetThreadBuffer();
+
+		std::lock_guard<std::mutex> lock(g_buffersMutex);
+		buffer.name = in_name;
+	}
+
+	bool Profiler::BeginZone(const char* in_name)
+	{
+		if (!IsEnabled()) { return false; }
+
+		GetThreadBuffer().openZones.push_back({ in_name, NowNs() });
+		return true;
+	}
+
+	void Profiler::EndZone()
+	{
+		// Not gated on IsEnabled(), only zones BeginZone recorded are ended so one open when the profiler is
+		// disabled still closes
+		ThreadBuffer* pBuffer = t_pBuffer;
+		MEGA_ASSERT(pBuffer && !pBuffer->openZones.empty(), "Ending a profiler zone that was not begun on this thread");
+
+		const OpenZone zone = pBuffer->openZones.back();
+		pBuffer->openZones.pop_back();
+
+		const uint64_t writeCount = pBuffer->writeCount.load(std::memory_order_relaxed);
+		pBuffer->startedCount.store(writeCount + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+
+		EventSlot& slot = pBuffer->pEvents[writeCount % PROFILER_EVENTS_PER_THREAD];
+		slot.name.store(zone.name, std::memory_order_relaxed);
+		slot.startNs.store(zone.startNs, std::memory_order_relaxed);
+		slot.endNs.store(NowNs(), std::memory_order_relaxed);
+		pBuffer->writeCount.store(writeCount + 1, std::memory_order_release);
+	}
+
+	void Profiler::EndFrame()
+	{
+		const int64_t nowNs = NowNs();
+		if (!IsEnabled())
+		{
+			g_lastFrameEndNs = nowNs;
+			return;
+		}
+
+		// Sum every zone per name (zones can run many times or on many threads in one frame)
+		std::unordered_map<std::string_view, int64_t> frameTotals;
+		{
+			std::lock_guard<std::mutex> lock(g_buffersMutex);
+			for (auto& pBuffer : g_buffers)
+			{
+				pBuffer->summarizedCount = CopyEvents(*pBuffer, pBuffer->summarizedCount, g_frameEvents);
+				for (const ZoneEvent& event : g_frameEvents)
+				{
+					frameTotals[event.name] += event.endNs - event.startNs;
+				}
+			}
+		}
+
+		for (const auto& [name, durationNs] : frameTotals)
+		{
+			PushSample(name, durationNs);
+		}
+
+		if (g_lastFrameEndNs != 0)
+		{
+			PushSample("Frame", nowNs - g_lastFrameEndNs);
+		}
+		g_lastFrameEndNs = nowNs;
+	}
+
+	bool Profiler::ExportChromeTrace(const char* in_filePath)
+	{
+		std::ofstream file(in_filePath);
+		if (!file.is_open())
+		{
+			MEGA_ERROR_MSG("Could not open profiler trace file " << in_filePath);
+			return false;
+		}
+
+		file << std::fixed << std::setprecision(3);
+		file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+		bool isFirst = true;
+		std::vector<ZoneEvent> events;
+		std::lock_guard<std::mutex> lock(g_buffersMutex);
+		for (auto& pBuffer : g_buffers)
+		{
+			if (!isFirst) { file << ","; }
+			isFirst = false;
+
+			file << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << pBuffer->threadIndex << ",\"args\":{\"name\":";
+			WriteJsonString(file, pBuffer->name);
+			file << "}}";
+
+			CopyEvents(*pBuffer, 0, events);
+			for (const ZoneEvent& event : events)
+			{
+
+				// Chrome trace times are in microseconds
+				file << ",\n{\"name\":";
+				WriteJsonString(file, event.name);
+				file << ",\"cat\":\"Mega\",\"ph\":\"X\",\"pid\":0,\"tid\":" << pBuffer->threadIndex
+					<< ",\"ts\":" << event.startNs / 1000.0 << ",\"dur\":" << (event.endNs - event.startNs) / 1000.0 << "}";
+			}
+		}
+
+		file << "\n]}";
+
+		return file.good();
+	}
+
+	std::vector<Profiler::ZoneSummary> Profiler::GetSummary()
+	{
+		std::vector<ZoneSummary> out_summary;
+		out_summary.reserve(g_history.size());
+
+		std::vector<int64_t> sorted;
+		for (const auto& [name, history] : g_history)
+		{
+			if (history.samples.empty()) { continue; }
+
+			sorted = history.samples;
+			std::sort(sorted.begin(), sorted.end());
+
+			int64_t total = 0;
+			for (const int64_t sample : sorted) { total += sample; }
+
+			const size_t p99Index = std::min(sorted.size() - 1, (size_t)(sorted.size() * 0.99));
+
+			ZoneSummary& zone = out_summary.emplace_back();
+			zone.name = name;
+			zone.frameCount = (uint32_t)sorted.size();
+			zone.minMs = sorted.front() / 1e6;
+			zone.avgMs = (double)total / sorted.size() / 1e6;
+			zone.p99Ms = sorted[p99Index] / 1e6;
+			zone.maxMs = sorted.back() / 1e6;
+		}
+
+		// Most expensive phases first
+		std::sort(out_summary.begin(), out_summary.end(), [](const ZoneSummary& a, const ZoneSummary& b) { return a.avgMs > b.avgMs; });
+
+		return out_summary;
+	}
+
+	void Profiler::PrintSummary(std::ostream& in_stream)
+	{
+		const std::vector<ZoneSummary> summary = GetSummary();
+
+		const auto flags = in_stream.flags();
+		in_stream << std::fixed << std::setprecision(3);
+		in_stream << "Profiler summary (last " << g_summaryFrameCount << " frames, ms)" << std::endl;
+		in_stream << std::left << std::setw(40) << "Zone" << std::right
+			<< std::setw(10) << "Frames" << std::setw(10) << "Min" << std::setw(10) << "Avg"
+			<< std::setw(10) << "P99" << std::setw(10) << "Max" << std::endl;
+
+		for (const ZoneSummary& zone : summary)
+		{
+			in_stream << std::left << std::setw(40) << zone.name << std::right
+				<< std::setw(10) << zone.frameCount << std::setw(10) << zone.minMs << std::setw(10) << zone.avgMs
+				<< std::setw(10) << zone.p99Ms << std::setw(10) << zone.maxMs << std::endl;
+		}
+		in_stream.flags(flags);
+	}
+} // namespace Mega
\ No newline at end of file
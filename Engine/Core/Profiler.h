@@ -0,0 +1,91 @@
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <ostream>
+
+// Scoped timing zones. Names must outlive the profiler (string literals) since only the pointer is recorded.
+// Defining MEGA_DISABLE_PROFILER compiles every zone out, otherwise a disabled profiler costs one relaxed load per zone.
+// MEGA_PROFILE_BEGIN gives whether it recorded the zone, hand that to the matching MEGA_PROFILE_END
+#ifndef MEGA_DISABLE_PROFILER
+#define MEGA_PROFILE_CONCAT_IMPL(a, b) a##b
+#define MEGA_PROFILE_CONCAT(a, b) MEGA_PROFILE_CONCAT_IMPL(a, b)
+#define MEGA_PROFILE_SCOPE(name) ::Mega::Profiler::ScopedZone MEGA_PROFILE_CONCAT(profileZone, __LINE__)(name)
+#define MEGA_PROFILE_BEGIN(name) ::Mega::Profiler::BeginZone(name)
+#define MEGA_PROFILE_END(isBegun) do { if (isBegun) { ::Mega::Profiler::EndZone(); } } while (0)
+#else
+#define MEGA_PROFILE_SCOPE(name)
+#define MEGA_PROFILE_BEGIN(name) false
+#define MEGA_PROFILE_END(isBegun) (void)(isBegun)
+#endif
+
+#define PROFILER_EVENTS_PER_THREAD (1 << 16) // Size of each thread's ring buffer, oldest zones are overwritten once full
+#define PROFILER_DEFAULT_SUMMARY_FRAMES 300
+
+namespace Mega
+{
+	// Records nested, named timing zones from any thread into per thread ring buffers. Zones are grouped into
+	// frames by EndFrame() so per phase stats can be summarized, and the raw zones can be exported as a
+	// Chrome trace (chrome://tracing or ui.perfetto.dev)
+	class Profiler final
+	{
+	public:
+		struct ZoneSummary
+		{
+			std::string name;
+			uint32_t frameCount = 0; // Number of frames (out of the summarized window) the zone ran in
+			double minMs = 0.0;
+			double avgMs = 0.0;
+			double p99Ms = 0.0;
+			double maxMs = 0.0;
+		};
+
+		// RAII helper used by MEGA_PROFILE_SCOPE
+		class ScopedZone
+		{
+		public:
+			explicit ScopedZone(const char* in_name)
+				: m_isRecording(BeginZone(in_name)) {};
+			~ScopedZone()
+			{
+				if (m_isRecording) { EndZone(); }
+			}
+
+			ScopedZone(const ScopedZone&) = delete;
+			ScopedZone& operator=(const ScopedZone&) = delete;
+
+		private:
+			bool m_isRecording;
+		};
+
+		Profiler() = delete;
+
+		static inline bool IsEnabled() { return s_isEnabled.load(std::memory_order_relaxed); }
+		static void SetEnabled(const bool in_isEnabled);
+
+		// Number of past frames the summary is computed over
+		static void SetSummaryFrameCount(const uint32_t in_frameCount);
+
+		// Names the calling thread in exported traces
+		static void SetThreadName(const char* in_name);
+
+		// Zones nest per thread. BeginZone returns whether it recorded the zone (the profiler is enabled), only those
+		// are ended, by an EndZone on the same thread. Toggling the profiler inside a zone keeps them balanced
+		static bool BeginZone(const char* in_name);
+		static void EndZone();
+
+		// Closes the current frame and folds its zones into the per phase history. Call once per frame from the
+		// main thread, other threads can keep recording (their zones that end later count in a later frame)
+		static void EndFrame();
+
+		// Both read the recorded data, call between frames
+		static bool ExportChromeTrace(const char* in_filePath);
+		static std::vector<ZoneSummary> GetSummary();
+		static void PrintSummary(std::ostream& in_stream);
+
+	private:
+		static std::atomic<bool> s_isEnabled;
+	};
+} // namespace Mega
\ No newline at end of file
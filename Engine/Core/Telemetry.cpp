@@ -0,0 +1,147 @@
+#include "Telemetry.h"
+
+#include <mutex>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <string_view>
+
+#include "Engine/Core/Debug.h"
+
+namespace Mega
+{
+	namespace
+	{
+		struct CounterInfo
+		{
+			const char* name = nullptr;
+			eCounterType type = eCounterType::Counter;
+		};
+		std::mutex g_registerMutex;
+		CounterInfo g_counters[TELEMETRY_MAX_COUNTERS];
+
+		std::ofstream g_exportFile;
+		bool g_isExportingJson = false;
+		bool g_isFirstRow = true;
+		uint32_t g_exportedCounterCount = 0; // Columns written in the CSV header
+
+		// JSON escapes quotes and backslashes, CSV doubles quotes
+		void WriteQuoted(std::ostream& in_stream, const std::string_view in_string)
+		{
+			in_stream << '"';
+			for (const char c : in_string)
+			{
+				if (c == '"') { in_stream << (g_isExportingJson ? '\\' : '"'); }
+				else if (c == '\\' && g_isExportingJson) { in_stream << '\\'; }
+				in_stream << c;
+			}
+			in_stream << '"';
+		}
+	}
+
+	std::atomic<int64_t> Telemetry::s_values[TELEMETRY_MAX_COUNTERS];
+	int64_t Telemetry::s_frameValues[TELEMETRY_MAX_COUNTERS] = {};
+	std::atomic<uint32_t> Telemetry::s_counterCount = 0;
+
+	tCounterID Telemetry::Register(const char* in_name, const eCounterType in_type)
+	{
+		std::lock_guard<std::mutex> lock(g_registerMutex);
+
+		const uint32_t counterCount = s_counterCount.load(std::memory_order_relaxed);
+		for (tCounterID id = 0; id < counterCount; id++)
+		{
+			if (std::strcmp(g_counters[id].name, in_name) == 0)
+			{
+				MEGA_ASSERT(g_counters[id].type == in_type, "Counter registered again with a different type");
+				return id;
+			}
+		}
+
+		MEGA_ASSERT(counterCount < TELEMETRY_MAX_COUNTERS, "Too many telemetry counters, raise TELEMETRY_MAX_COUNTERS");
+		g_counters[counterCount] = { in_name, in_type };
+		s_values[counterCount].store(0, std::memory_order_relaxed);
+		s_counterCount.store(counterCount + 1, std::memory_order_release);
+
+		return counterCount;
+	}
+
+	const char* Telemetry::GetName(const tCounterID in_id)
+	{
+		return g_counters[in_id].name;
+	}
+
+	bool Telemetry::StartExport(const char* in_filePath)
+	{
+		StopExport();
+
+		g_exportFile.open(in_filePath, std::ios::trunc);
+		if (!g_exportFile.is_open())
+		{
+			MEGA_ERROR_MSG("Could not open telemetry file " << in_filePath);
+			return false;
+		}
+
+		const std::string_view path = in_filePath;
+		g_isExportingJson = path.size() >= 5 && path.substr(path.size() - 5) == ".json";
+		g_isFirstRow = true;
+		g_exportedCounterCount = GetCounterCount();
+
+		g_exportFile << std::fixed << std::setprecision(3);
+		if (g_isExportingJson)
+		{
+			g_exportFile << "[";
+		}
+		else
+		{
+			g_exportFile << "tick,frameMs";
+			for (tCounterID id = 0; id < g_exportedCounterCount; id++)
+			{
+				g_exportFile << ",";
+				WriteQuoted(g_exportFile, g_counters[id].name);
+			}
+			g_exportFile << "\n";
+		}
+
+		return true;
+	}
+	void Telemetry::StopExport()
+	{
+		if (!g_exportFile.is_open()) { return; }
+
+		if (g_isExportingJson) { g_exportFile << "\n]"; }
+		g_exportFile.close();
+	}
+
+	void Telemetry::EndFrame(const uint64_t in_tick, const double in_frameMs)
+	{
+		const uint32_t counterCount = GetCounterCount();
+		for (tCounterID id = 0; id < counterCount; id++)
+		{
+			s_frameValues[id] = g_counters[id].type == eCounterType::Counter ? s_values[id].exchange(0, std::memory_order_relaxed) : s_values[id].load(std::memory_order_relaxed);
+		}
+
+		if (!g_exportFile.is_open()) { return; }
+
+		if (g_isExportingJson)
+		{
+			g_exportFile << (g_isFirstRow ? "\n" : ",\n") << "{\"tick\":" << in_tick << ",\"frameMs\":" << in_frameMs;
+			for (tCounterID id = 0; id < counterCount; id++)
+			{
+				g_exportFile << ",";
+				WriteQuoted(g_exportFile, g_counters[id].name);
+				g_exportFile << ":" << s_frameValues[id];
+			}
+			g_exportFile << "}";
+		}
+		else
+		{
+			g_exportFile << in_tick << "," << in_frameMs;
+			for (tCounterID id = 0; id < g_exportedCounterCount; id++)
+			{
+				g_exportFile << "," << s_frameValues[id];
+			}
+			g_exportFile << "\n";
+		}
+		g_isFirstRow = false;
+	}
+} // namespace Mega
\ No newline at end of file
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#define TELEMETRY_MAX_COUNTERS 128
+
+namespace Mega
+{
+	enum class eCounterType : uint32_t
+	{
+		Counter = 0, // Summed over a frame, starts the next frame at 0 (draw calls, solver iterations)
+		Gauge = 1 // Last value set, kept until set again (active bodies, instances)
+	};
+	using tCounterID = uint32_t;
+
+	// Named workload counters and gauges fed by the systems, closed once per drawn frame. The last frame's values are
+	// shown on the ImGui overlay and can be streamed, a row per frame, to a CSV or JSON file to line frame times up
+	// with the work done. Names must outlive the registry (string literals) since only the pointer is kept.
+	// Register at namespace scope in the feeding system's file, so every counter exists before an export starts
+	class Telemetry final
+	{
+	public:
+		Telemetry() = delete;
+
+		// Registering a name twice returns the first ID
+		static tCounterID Register(const char* in_name, const eCounterType in_type);
+
+		// Safe from any thread, a relaxed atomic each
+		static inline void Add(const tCounterID in_id, const int64_t in_value) { s_values[in_id].fetch_add(in_value, std::memory_order_relaxed); }
+		static inline void Set(const tCounterID in_id, const int64_t in_value) { s_values[in_id].store(in_value, std::memory_order_relaxed); }
+
+		// Of the last closed frame
+		static inline int64_t GetValue(const tCounterID in_id) { return s_frameValues[in_id]; }
+		static inline uint32_t GetCounterCount() { return s_counterCount.load(std::memory_order_acquire); }
+		static const char* GetName(const tCounterID in_id);
+
+		// Files ending in .json get an array with an object per frame, anything else is CSV with a column per counter.
+		// Counters registered after the export started are left out of CSV files
+		static bool StartExport(const char* in_filePath);
+		static void StopExport();
+
+		// Closes the frame, resetting its counters and writing its row. Call once per frame from the main thread
+		static void EndFrame(const uint64_t in_tick, const double in_frameMs);
+
+	private:
+		static std::atomic<int64_t> s_values[TELEMETRY_MAX_COUNTERS];
+		static int64_t s_frameValues[TELEMETRY_MAX_COUNTERS];
+		static std::atomic<uint32_t> s_counterCount;
+	};
+} // namespace Mega
\ No newline at end of file
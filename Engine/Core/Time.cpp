@@ -1,5 +1,17 @@
 #include "Time.h"
 
+#include <thread>
+#include <algorithm>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <timeapi.h>
+#pragma comment(lib, "winmm.lib")
+#endif
+
 namespace Mega
 {
 	tTime Time()
@@ -7,4 +19,33 @@ namespace Mega
 		//return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
 		return std::chrono::duration_cast<Mega::tMillisecond>(std::chrono::high_resolution_clock::now().time_since_epoch()).count();
 	}
+
+	void SleepUntil(const tNanosecond in_wakeTime)
+	{
+		// How early the coarse sleep wakes up, covers the usual scheduler overshoot
+		constexpr tNanosecond sleepMargin = tMillisecond(2);
+		constexpr tNanosecond shortSleep = tMicrosecond(200);
+
+		tNanosecond now = Time<tNanosecond>();
+		if (in_wakeTime - now > sleepMargin)
+		{
+			std::this_thread::sleep_for(in_wakeTime - now - sleepMargin);
+		}
+
+		// Short sleeps rather than yield(), which returns right away when nothing else wants the core and so spins
+		while ((now = Time<tNanosecond>()) < in_wakeTime)
+		{
+			std::this_thread::sleep_for(std::min(in_wakeTime - now, shortSleep));
+		}
+	}
+
+	void SetPreciseSleepEnabled(const bool in_isEnabled)
+	{
+#ifdef _WIN32
+		if (in_isEnabled) { timeBeginPeriod(1); }
+		else              { timeEndPeriod(1); }
+#else
+		(void)in_isEnabled; // Sleeps are already fine grained
+#endif
+	}
 } // namespace Mega
\ No newline at end of file
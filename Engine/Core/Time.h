@@ -20,4 +20,12 @@ namespace Mega
 	{
 		return std::chrono::duration_cast<T>(std::chrono::high_resolution_clock::now().time_since_epoch());
 	}
+
+	// Blocks until Time<tNanosecond>() reaches in_wakeTime without busy waiting. The OS sleep is only trusted up to
+	// a small margin before the target, the rest is made up with short sleeps
+	void SleepUntil(const tNanosecond in_wakeTime);
+
+	// Asks the OS for its finest sleep granularity (1ms timer resolution on Windows, which defaults to ~15.6ms).
+	// Affects the whole system so it should only be on while the engine is running
+	void SetPreciseSleepEnabled(const bool in_isEnabled);
 }
\ No newline at end of file
@@ -0,0 +1,89 @@
+#include "CommandBuffer.h"
+
+#include "Engine/Core/Profiler.h"
+#include "Engine/Core/FrameAllocator.h"
+
+namespace Mega
+{
+	void CommandBuffer::Flush(const std::vector<std::unique_ptr<CommandBuffer>>& in_buffers, entt::registry& in_registry)
+	{
+		MEGA_PROFILE_SCOPE("CommandBuffer::Flush");
+
+		const bool isEmpty = std::all_of(in_buffers.begin(), in_buffers.end(), [](const std::unique_ptr<CommandBuffer>& in_pBuffer) { return in_pBuffer->IsEmpty(); });
+		if (isEmpty) { return; }
+
+		// Creates, all of a buffer's entities in one call
+		for (const std::unique_ptr<CommandBuffer>& pBuffer : in_buffers)
+		{
+			pBuffer->m_created.resize(pBuffer->m_createCount);
+			in_registry.create(pBuffer->m_created.begin(), pBuffer->m_created.end());
+		}
+
+		// Every buffer's queues are sorted by component id, so merging them sorted by id groups each component type.
+		// Stable, so a type's commands run in buffer order
+		struct RecordedQueue
+		{
+			ComponentQueueBase* pQueue = nullptr;
+			const std::vector<entt::entity>* pCreated = nullptr; // The recording buffer's, for its deferred entities
+		};
+		tFrameVector<RecordedQueue> queues; // Both lists only live for the flush, built in frame memory
+		for (const std::unique_ptr<CommandBuffer>& pBuffer : in_buffers)
+		{
+			if (pBuffer->m_recordedQueueCount == 0) { continue; }
+			for (const std::unique_ptr<ComponentQueueBase>& pQueue : pBuffer->m_pQueues)
+			{
+				if (!pQueue->IsEmpty()) { queues.push_back({ pQueue.get(), &pBuffer->m_created }); }
+			}
+		}
+		std::stable_sort(queues.begin(), queues.end(), [](const RecordedQueue& in_a, const RecordedQueue& in_b) { return in_a.pQueue->componentID < in_b.pQueue->componentID; });
+
+		// Adds then removes, one component type at a time
+		for (size_t begin = 0; begin < queues.size();)
+		{
+			size_t end = begin;
+			size_t emplaceCount = 0;
+			for (; end < queues.size() && queues[end].pQueue->componentID == queues[begin].pQueue->componentID; end++)
+			{
+				emplaceCount += queues[end].pQueue->GetEmplaceCount();
+			}
+
+			if (emplaceCount > 0) { queues[begin].pQueue->Reserve(in_registry, emplaceCount); }
+			for (size_t i = begin; i < end; i++) { queues[i].pQueue->Emplace(in_registry, *queues[i].pCreated); }
+			for (size_t i = begin; i < end; i++) { queues[i].pQueue->Remove(in_registry); }
+
+			begin = end;
+		}
+
+		// Destroys last, entt removes the entity's components (and runs their on_destroy callbacks) itself. Sorted so
+		// duplicates (destroyed from two threads) can be skipped
+		tFrameVector<entt::entity> destroys;
+		for (const std::unique_ptr<CommandBuffer>& pBuffer : in_buffers)
+		{
+			destroys.insert(destroys.end(), pBuffer->m_destroys.begin(), pBuffer->m_destroys.end());
+		}
+		std::sort(destroys.begin(), destroys.end());
+		destroys.erase(std::unique(destroys.begin(), destroys.end()), destroys.end());
+		for (const entt::entity entity : destroys)
+		{
+			if (in_registry.valid(entity)) { in_registry.destroy(entity); }
+		}
+
+		for (const std::unique_ptr<CommandBuffer>& pBuffer : in_buffers)
+		{
+			pBuffer->Clear();
+		}
+	}
+
+	void CommandBuffer::Clear()
+	{
+		for (const std::unique_ptr<ComponentQueueBase>& pQueue : m_pQueues)
+		{
+			pQueue->Clear();
+		}
+		m_recordedQueueCount = 0;
+
+		m_createCount = 0;
+		m_created.clear();
+		m_destroys.clear();
+	}
+} // namespace Mega
\ No newline at end of file
@@ -0,0 +1,167 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+#include <type_traits>
+#include <entt/entt.hpp>
+
+#include "Engine/Core/Debug.h"
+
+namespace Mega
+{
+	// Records structural changes to the registry (creating and destroying entities, adding and removing components)
+	// so they can be made later in one batch instead of while systems are iterating. Every thread records into its
+	// own buffer (see Scene::GetCommandBuffer), the scene flushes them all once the systems are done.
+	//
+	// Destroy is meant for entities created through a command buffer, entities owned by an Entity object are
+	// destroyed through Entity::Destroy
+	class CommandBuffer final
+	{
+	public:
+		// Stands in for an entity the buffer will create, only valid in commands recorded into the same buffer
+		// before it is flushed
+		struct DeferredEntity
+		{
+			uint32_t index = UINT32_MAX;
+		};
+
+		CommandBuffer() = default;
+
+		// Queues reference the buffer's storage, so it is not copyable or movable
+		CommandBuffer(const CommandBuffer&) = delete;
+		CommandBuffer(CommandBuffer&&) = delete;
+		CommandBuffer& operator=(const CommandBuffer&) = delete;
+		CommandBuffer& operator=(CommandBuffer&&) = delete;
+
+		inline DeferredEntity Create() { return { m_createCount++ }; }
+		inline void Destroy(const entt::entity in_entity) { m_destroys.push_back(in_entity); }
+
+		// Components are constructed now and moved into the registry at the flush
+		template<typename tComponent, class... Args>
+		void Emplace(const entt::entity in_entity, Args&&... in_args)
+		{
+			GetQueue<tComponent>().emplaces.push_back({ { in_entity, UINT32_MAX }, Construct<tComponent>(std::forward<Args>(in_args)...) });
+		}
+		template<typename tComponent, class... Args>
+		void Emplace(const DeferredEntity in_entity, Args&&... in_args)
+		{
+			MEGA_ASSERT(in_entity.index < m_createCount, "Emplacing onto a deferred entity from another buffer or flush");
+			GetQueue<tComponent>().emplaces.push_back({ { entt::null, in_entity.index }, Construct<tComponent>(std::forward<Args>(in_args)...) });
+		}
+
+		template<typename tComponent>
+		void Remove(const entt::entity in_entity)
+		{
+			GetQueue<tComponent>().removes.push_back(in_entity);
+		}
+
+		inline bool IsEmpty() const { return m_createCount == 0 && m_destroys.empty() && m_recordedQueueCount == 0; }
+
+		// Makes every command recorded into in_buffers, then empties them. Creates come first, then component adds
+		// and removes one component type at a time (ascending type id, so the order does not depend on which thread
+		// recorded first), then destroys. Each component pool is grown once for everything added to it
+		static void Flush(const std::vector<std::unique_ptr<CommandBuffer>>& in_buffers, entt::registry& in_registry);
+
+		// Drops every recorded command, keeping the memory for the next frame
+		void Clear();
+
+	private:
+		struct Target
+		{
+			entt::entity entity = entt::null;
+			uint32_t deferredIndex = UINT32_MAX; // Into m_created once flushed, UINT32_MAX if entity is already real
+		};
+
+		// Everything recorded for one component type. Kept across flushes so a steady frame does not allocate
+		class ComponentQueueBase
+		{
+		public:
+			virtual ~ComponentQueueBase() = default;
+
+			virtual size_t GetEmplaceCount() const = 0;
+			virtual bool IsEmpty() const = 0;
+			virtual void Reserve(entt::registry& in_registry, const size_t in_count) = 0;
+			virtual void Emplace(entt::registry& in_registry, const std::vector<entt::entity>& in_created) = 0;
+			virtual void Remove(entt::registry& in_registry) = 0;
+			virtual void Clear() = 0;
+
+			entt::id_type componentID = 0;
+		};
+
+		template<typename tComponent>
+		class ComponentQueue final : public ComponentQueueBase
+		{
+		public:
+			size_t GetEmplaceCount() const override { return emplaces.size(); }
+			bool IsEmpty() const override { return emplaces.empty() && removes.empty(); }
+			void Reserve(entt::registry& in_registry, const size_t in_count) override
+			{
+				auto& storage = in_registry.storage<tComponent>();
+				storage.reserve(storage.size() + in_count);
+			}
+			void Emplace(entt::registry& in_registry, const std::vector<entt::entity>& in_created) override
+			{
+				for (std::pair<Target, tComponent>& emplace : emplaces)
+				{
+					const Target& target = emplace.first;
+					const entt::entity entity = target.deferredIndex == UINT32_MAX ? target.entity : in_created[target.deferredIndex];
+					if (!in_registry.valid(entity)) { continue; } // Destroyed since the command was recorded
+
+					in_registry.emplace_or_replace<tComponent>(entity, std::move(emplace.second));
+				}
+			}
+			void Remove(entt::registry& in_registry) override
+			{
+				for (const entt::entity entity : removes)
+				{
+					if (in_registry.valid(entity)) { in_registry.remove<tComponent>(entity); }
+				}
+			}
+			void Clear() override
+			{
+				emplaces.clear();
+				removes.clear();
+			}
+
+			std::vector<std::pair<Target, tComponent>> emplaces;
+			std::vector<entt::entity> removes;
+		};
+
+		template<typename tComponent, class... Args>
+		static tComponent Construct(Args&&... in_args)
+		{
+			// Same rule entt's emplace follows, aggregates are brace initialized
+			if constexpr (std::is_aggregate_v<tComponent>) { return tComponent{ std::forward<Args>(in_args)... }; }
+			else { return tComponent(std::forward<Args>(in_args)...); }
+		}
+
+		template<typename tComponent>
+		ComponentQueue<tComponent>& GetQueue()
+		{
+			const entt::id_type componentID = entt::type_hash<tComponent>::value();
+
+			// Sorted by component id so the flush can merge the buffers' queues in one pass
+			auto it = std::lower_bound(m_pQueues.begin(), m_pQueues.end(), componentID,
+				[](const std::unique_ptr<ComponentQueueBase>& in_pQueue, const entt::id_type in_id) { return in_pQueue->componentID < in_id; });
+			if (it == m_pQueues.end() || (*it)->componentID != componentID)
+			{
+				std::unique_ptr<ComponentQueueBase> pQueue = std::make_unique<ComponentQueue<tComponent>>();
+				pQueue->componentID = componentID;
+				it = m_pQueues.insert(it, std::move(pQueue));
+			}
+
+			if ((*it)->IsEmpty()) { m_recordedQueueCount++; }
+			return *static_cast<ComponentQueue<tComponent>*>(it->get());
+		}
+
+		std::vector<std::unique_ptr<ComponentQueueBase>> m_pQueues; // Sorted by componentID
+		uint32_t m_recordedQueueCount = 0; // Queues holding commands since the last flush
+
+		uint32_t m_createCount = 0;
+		std::vector<entt::entity> m_created; // Filled during the flush, indexed by DeferredEntity::index
+		std::vector<entt::entity> m_destroys;
+	};
+} // namespace Mega
\ No newline at end of file
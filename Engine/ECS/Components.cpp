@@ -1,5 +1,7 @@
 #include "Components.h"
 
+#include "Engine/Scene/Scene.h"
+
 namespace Mega
 {
 	namespace Component
@@ -15,40 +17,90 @@ namespace Mega
 			SetPosition(in_pos);
 			SetScale(in_scale);
 		}
-		void Transform::SetRotation(const Mat4x4& in_rot)
+		void Transform::SetTransform(const Mat4x4& in_transform)
 		{
-			transform = Mat4x4(1.0f);
+			const Vec3 newScale = Vec3(glm::length(Vec3(in_transform[0])), glm::length(Vec3(in_transform[1])), glm::length(Vec3(in_transform[2])));
+			const glm::mat3 newRotation = glm::mat3(Vec3(in_transform[0]) / newScale.x, Vec3(in_transform[1]) / newScale.y, Vec3(in_transform[2]) / newScale.z);
 
-			SetScale(scale);
-			transform *= in_rot;
-			SetPosition(translation);
+			translation = Vec3(in_transform[3]);
+			orientation = glm::quat_cast(newRotation);
+			scale = newScale;
+
+			// Already have the matrix, no need to rebuild it
+			transform = in_transform;
+			isMatrixDirty = false;
+			RecordChange();
+		}
+		const Mat4x4& Transform::GetTransform() const
+		{
+			if (isMatrixDirty) { RebuildMatrix(); }
+
+			return transform;
+		}
+		void Transform::SetRotation(const Mat4x4& in_rot)
+		{
+			SetOrientation(glm::quat_cast(glm::mat3(in_rot)));
 		}
 		void Transform::SetRotation(const Vec3& in_rot)
 		{
 			rotation = in_rot;
-			transform = Mat4x4(1.0f);
 
-			SetScale(scale);
-			transform = glm::rotate(transform, in_rot.x, Vec3(1, 0, 0));
-			transform = glm::rotate(transform, in_rot.y, Vec3(0, 1, 0));
-			transform = glm::rotate(transform, in_rot.z, Vec3(0, 0, 1));
-			SetPosition(translation);
+			// Same order the angles have always been applied in, X then Y then Z
+			SetOrientation(glm::angleAxis(in_rot.x, Vec3(1, 0, 0)) * glm::angleAxis(in_rot.y, Vec3(0, 1, 0)) * glm::angleAxis(in_rot.z, Vec3(0, 0, 1)));
+		}
+		void Transform::SetOrientation(const Quat& in_orientation)
+		{
+			if (in_orientation == orientation) { return; }
+
+			orientation = in_orientation;
+			MarkChanged();
 		}
 		void Transform::SetPosition(const Vec3& in_pos)
 		{
-			translation = in_pos;
+			if (in_pos == translation) { return; }
 
-			transform[3][0] = in_pos.x;
-			transform[3][1] = in_pos.y;
-			transform[3][2] = in_pos.z;
+			translation = in_pos;
+			MarkChanged();
 		}
 		void Transform::SetScale(const Vec3& in_scale)
 		{
+			if (in_scale == scale) { return; }
+
 			scale = in_scale;
+			MarkChanged();
+		}
+		void Transform::MarkChanged()
+		{
+			// Systems that only read transforms can run at the same time, a lazy rebuild from their const getters
+			// would race. The engine flushes every dirty matrix before they start, changes made meanwhile are rebuilt here
+			if (pScene && pScene->IsStructureLocked()) { RebuildMatrix(); }
+			else { isMatrixDirty = true; }
+
+			RecordChange();
+		}
+		void Transform::RecordChange()
+		{
+			if (hasChanged) { return; }
+
+			hasChanged = true;
+			if (pScene) { pScene->OnTransformChanged(entity); }
+		}
+		void Transform::RebuildMatrix() const
+		{
+			const glm::mat3 rotationMat = glm::mat3_cast(orientation);
+
+			transform[0] = Vec4(rotationMat[0] * scale.x, 0.0f);
+			transform[1] = Vec4(rotationMat[1] * scale.y, 0.0f);
+			transform[2] = Vec4(rotationMat[2] * scale.z, 0.0f);
+			transform[3] = Vec4(translation, 1.0f);
+
+			isMatrixDirty = false;
+		}
+		Mat4x4 Transform::GetInterpolatedTransform(const float in_alpha) const
+		{
+			if (!IsInterpolating()) { return GetWorldTransform(); }
 
-			transform[0][0] = in_scale.x;
-			transform[1][1] = in_scale.y;
-			transform[2][2] = in_scale.z;
+			return InterpolateTransform(previousTransform, GetWorldTransform(), in_alpha);
 		}
 	} // namespace Component
 } // namespace Mega
\ No newline at end of file
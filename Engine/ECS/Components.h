@@ -2,6 +2,7 @@
 
 #include <vector>
 #include <iostream>
+#include <entt/entt.hpp>
 
 #include <Bullet3D/LinearMath/btScalar.h>
 #include <Bullet3D/LinearMath/btVector3.h>
@@ -15,38 +16,90 @@
 #include "Engine/Sound/SoundData.h"
 #include "Engine/Sound/SoundSource.h"
 
+// Forward declarations
+namespace Mega
+{
+	class Scene;
+}
+
 namespace Mega
 {
 	namespace Component
 	{
 		struct ComponentBase {}; // Pure virtual parent class
 
+		// Tag on entities switched off with Entity::SetIsEnabled. Their bodies leave the physics world and they are not
+		// drawn or animated
+		struct Disabled : public ComponentBase {};
+
 		// Transform
+		// Stored as position, rotation, and scale relative to the owning entity's transform. The local matrix (T * R * S)
+		// is only rebuilt when it is asked for after a change (right away while systems run in parallel). The first change since the scene's last transform pass
+		// puts the transform on the scene's dirty list, and the pass walks only the subtrees under those to rebuild
+		// their matrices and propagate world matrices (see Scene::FlushTransformChanges)
 		struct Transform : public ComponentBase
 		{
 		public:
+			friend Mega::Scene;
+
 			using tScalar = Mega::tScalarPrecision;
 
 			Transform() = default;
 			Transform(const Vec3& in_pos);
 			Transform(const Vec3& in_pos, const Vec3& in_rot, const Vec3& in_scale);
 
-			void SetTransform(const Mat4x4& in_rot) { transform = in_rot; }
-			Mat4x4 GetTransform() const { return transform; }
+			void SetTransform(const Mat4x4& in_transform); // Decomposed, the matrix can not have any shear
+			const Mat4x4& GetTransform() const; // Local, relative to the owner
+			// Owner's world transform * local, as of the scene's last transform pass. Same as GetTransform() for the root
+			const Mat4x4& GetWorldTransform() const { return hasParent ? worldTransform : GetTransform(); }
 			Vec3 GetPosition() const { return translation; }
 			Vec3 GetScale() const { return scale; }
+			Quat GetOrientation() const { return orientation; }
 
-			Vec3 GetRotation() const { return rotation; }
+			Vec3 GetRotation() const { return rotation; } // Euler angles last given to SetRotation(Vec3)
 			void SetRotation(const Mat4x4& in_rot);
 			void SetRotation(const Vec3& in_rot);
+			void SetOrientation(const Quat& in_orientation);
 			void SetPosition(const Vec3& in_pos);
 			void SetScale(const Vec3& in_scale);
 
+			// True if any setter changed something since the scene's last transform pass. Setting a value a
+			// transform already has does not count
+			bool HasChanged() const { return hasChanged; }
+
+			// Render interpolation - the engine stores every transform at the start of a tick and the renderer draws
+			// somewhere between that and the current one (see Engine::GetInterpolationAlpha)
+			void StorePreviousTransform() { previousTransform = GetWorldTransform(); hasPreviousTransform = true; }
+			void ResetInterpolation() { hasPreviousTransform = false; } // Snap to the current transform, for teleports
+			// Only transforms that moved in the last tick are blended, the rest are drawn where they are
+			bool IsInterpolating() const { return hasPreviousTransform && isMoving; }
+			Mat4x4 GetInterpolatedTransform(const float in_alpha) const;
+
 		private:
-			Mat4x4 transform = Mat4x4(1.0f);
+			void MarkChanged();
+			void RecordChange(); // Onto the scene's dirty list, once per pass
+			void RebuildMatrix() const;
+
 			Vec3 translation = Vec3(0.0f);
-			Vec3 rotation = Vec3(0.0f);
+			Quat orientation = Quat(1.0f, 0.0f, 0.0f, 0.0f);
 			Vec3 scale = Vec3(1.0f);
+			Vec3 rotation = Vec3(0.0f);
+
+			mutable Mat4x4 transform = Mat4x4(1.0f);
+			mutable bool isMatrixDirty = false;
+			bool hasChanged = true; // New transforms count as changed
+
+			Mat4x4 worldTransform = Mat4x4(1.0f);
+			bool hasParent = false;
+
+			// Set by the scene when the component is added to its registry
+			Scene* pScene = nullptr;
+			entt::entity entity = entt::null;
+			uint32_t hierarchyIndex = UINT32_MAX; // Node in the scene's transform hierarchy, if it is under the root
+
+			Mat4x4 previousTransform = Mat4x4(1.0f);
+			bool hasPreviousTransform = false; // Entities created mid tick have nothing to blend from yet
+			bool isMoving = false; // Changed in the scene's last transform pass
 
 			operator glm::mat4() { return GetTransform(); }
 			operator const glm::mat4()& { return GetTransform(); }
@@ -0,0 +1,90 @@
+#include "Entity.h"
+
+#include "Engine/Scene/Scene.h"
+
+namespace Mega
+{
+	void Entity::SetIsActive(bool in_isActive)
+	{
+		m_isActiveSelf = in_isActive;
+		ApplyIsActive(in_isActive && IsEnabled());
+	}
+	void Entity::ApplyIsActive(const bool in_isActive)
+	{
+		if (m_isActive == in_isActive) { return; }
+
+		m_isActive = in_isActive;
+		if (m_pScene) { m_pScene->OnEntityActiveChanged(this); }
+	}
+
+	void Entity::SetIsEnabled(const bool in_isEnabled)
+	{
+		MEGA_ASSERT(!IsSceneStructureLocked(), "Enabling or disabling an entity while systems are running");
+
+		m_isDisabledSelf = !in_isEnabled;
+		ApplyIsEnabled(m_owner == nullptr || m_owner == this || m_owner->IsEnabled());
+	}
+	void Entity::ApplyIsEnabled(const bool in_isOwnerEnabled)
+	{
+		const bool isEnabled = in_isOwnerEnabled && !m_isDisabledSelf;
+
+		ApplyIsActive(isEnabled && m_isActiveSelf);
+		if (isEnabled) { m_pRegistry->remove<Component::Disabled>(m_enttID); }
+		else if (IsEnabled()) { m_pRegistry->emplace<Component::Disabled>(m_enttID); }
+
+		for (const tChild childHandle : m_children)
+		{
+			if (Entity* pChild = m_pScene->GetEntity(childHandle)) { pChild->ApplyIsEnabled(isEnabled); }
+		}
+	}
+
+	bool Entity::IsSceneStructureLocked() const
+	{
+		return m_pScene && m_pScene->IsStructureLocked();
+	}
+	CommandBuffer& Entity::GetSceneCommandBuffer() const
+	{
+		return m_pScene->GetCommandBuffer();
+	}
+
+	void Entity::Destroy()
+	{
+		MEGA_ASSERT(IsInitialized(), "Destroying an entity before it has been initialized");
+
+		OnDestroy();
+
+		// Remove from ownership chain
+		if (m_owner != nullptr && m_owner != this)
+		{
+			m_owner->RemoveChild(m_childIndex);
+		}
+
+		// Remove Children, each one takes itself off the back of the list as it is destroyed
+		while (!m_children.empty())
+		{
+			Entity* pChild = m_pScene->GetEntity(m_children.back());
+			if (pChild && pChild->IsInitialized())
+			{
+				pChild->Destroy();
+			}
+			else
+			{
+				m_children.pop_back();
+			}
+		}
+
+		SetIsActive(false);
+		SetLifetimeState(eEntityState::Destroyed);
+	}
+
+	void Entity::RemoveChild(const tChildIndex in_childIndex)
+	{
+		// Swap child to be removed and back of the list, then pop
+		m_children[in_childIndex] = m_children.back();
+		if (Entity* pMoved = m_pScene->GetEntity(m_children[in_childIndex]))
+		{
+			pMoved->m_childIndex = in_childIndex;
+		}
+		m_children.pop_back();
+	}
+} // namespace Mega
\ No newline at end of file
@@ -8,6 +8,9 @@
 
 #include "Engine/Core/Core.h"
 #include "Engine/ECS/Components.h"
+#include "Engine/ECS/CommandBuffer.h"
+#include "Engine/ECS/EntityType.h"
+#include "Engine/ECS/EntityHandle.h"
 #include "Engine/Physics/PhysicsComponents.h"
 
 #define ENTITY_PHYSICS const type_info& GetTypeID() const override { return typeid(this); }
@@ -16,6 +19,7 @@ namespace Mega
 {
 	// Forward declaration
 	class Scene;
+	class SceneSnapshot;
 
 	enum class eEntityState
 	{
@@ -28,14 +32,23 @@ namespace Mega
 	{
 	public:
 		friend Scene;
+		friend SceneSnapshot;
 
 		using tChildIndex = int32_t;
-		using tChild = Entity*;
+		using tChild = EntityHandle; // Resolved through the scene, see Scene::GetEntity
 		using tOwner = Entity*;
 
-		// Determines whether or not the eneity is updated every frame
-		void SetIsActive(bool in_isActive) { m_isActive = in_isActive; }
+		// Determines whether or not the eneity is updated every frame. Disabled entities never are, enabling one
+		// brings back what it was last set to here
+		void SetIsActive(bool in_isActive);
 		bool IsActive() const { return m_isActive; }
+		bool IsActiveSelf() const { return m_isActiveSelf; } // As last set, whether or not it is enabled
+
+		// Switches this entity and its children off (or back on) completely, not updated, simulated or drawn. Children
+		// that were disabled on their own stay disabled
+		void SetIsEnabled(const bool in_isEnabled);
+		bool IsEnabled() const { return !HasComponent<Component::Disabled>(); } // False if an owner is disabled too
+		bool IsEnabledSelf() const { return !m_isDisabledSelf; } // Only this entity's own SetIsEnabled
 
 		// Entity Guard
 		eEntityState GetLifetimeState() const { return m_state; }
@@ -52,30 +65,17 @@ namespace Mega
 		}
 
 		// Overwritable functions for scripting
-		virtual void OnCollision(const Entity* in_pEntity, const CollisionData& in_collisionData) {};
-		Vec3 GetPosition() const { return m_pTransformComponent->GetPosition(); }
-
-		void Destroy()
-		{
-			MEGA_ASSERT(IsInitialized(), "Destroying an entity before it has been initialized");
-
-			OnDestroy();
+		// Called after the physics step for the contact events asked for with RigidBody::SetContactEvents. in_pOther is
+		// only valid for the call, keep its GetHandle() to refer to it later. It is null for the End of a deleted entity
+		virtual void OnContact(const Entity* in_pOther, const ContactEvent& in_event) {};
+		Vec3 GetPosition() const { return m_pTransformComponent->GetPosition(); } // Relative to the owner
+		Vec3 GetWorldPosition() const { return Vec3(m_pTransformComponent->GetWorldTransform()[3]); } // As of the last tick
 
-			// Remove from ownership chain
-			if (m_owner != nullptr && m_owner != this)
-			{
-				m_owner->RemoveChild(m_childIndex);
-			}
+		// Stays valid to store, unlike the entity's address which is reused once it is deleted
+		inline EntityHandle GetHandle() const { return m_handle; }
+		inline Scene* GetScene() const { return m_pScene; }
 
-			// Remove Children
-			for (auto child : m_children)
-			{
-				child->Destroy();
-			}
-
-			SetIsActive(false);
-			SetLifetimeState(eEntityState::Destroyed);
-		};
+		void Destroy(); // Marks this entity and its children destroyed, the scene deletes them at the end of the frame
 
 	protected:
 		// Protected constructor / destructor - only Scene can create and destroy entities
@@ -105,15 +105,34 @@ namespace Mega
 			MEGA_STATIC_ASSERT(std::is_base_of<Mega::Component::ComponentBase, T>::value == true, "Structs added to Entities as components must be derived from Mega::Component!");
 			MEGA_ASSERT(m_pRegistry->valid(m_enttID), "Adding component to entity that is not valid");
 			MEGA_ASSERT(!HasComponent<T>(), "Entity already has component!");
+			MEGA_ASSERT(!IsSceneStructureLocked(), "Adding a component while systems are running, use AddComponentDeferred instead");
 			return m_pRegistry->emplace<T>(m_enttID, std::forward<Args>(args)...);
 		}
+		// Same as AddComponent, but while systems are running the component is recorded into the calling thread's
+		// command buffer and added once they are done (see Scene::GetCommandBuffer)
+		template<typename T, class... Args>
+		void AddComponentDeferred(Args&&... args)
+		{
+			MEGA_STATIC_ASSERT(std::is_base_of<Mega::Component::ComponentBase, T>::value == true, "Structs added to Entities as components must be derived from Mega::Component!");
+			if (IsSceneStructureLocked()) { GetSceneCommandBuffer().Emplace<T>(m_enttID, std::forward<Args>(args)...); }
+			else { AddComponent<T>(std::forward<Args>(args)...); }
+		}
+		// While systems are running the component stays until they are done, see AddComponentDeferred
 		template<typename T>
 		void RemoveComponent()
 		{
 			MEGA_STATIC_ASSERT(std::is_base_of<Mega::Component::ComponentBase, T>::value == true, "Removing a component not derived from Mega::Component!");
 			MEGA_ASSERT(m_pRegistry->valid(m_enttID), "Removing component from invalid entity");
 			MEGA_ASSERT(HasComponent<T>(), "Entity does not have component");
-			m_pRegistry->remove<T>(m_enttID);
+			if (IsSceneStructureLocked()) { GetSceneCommandBuffer().Remove<T>(m_enttID); }
+			else { m_pRegistry->remove<T>(m_enttID); }
+		}
+		// Components edited in place are not seen by change tracking (Scene::TrackChanges) unless marked
+		template<typename T>
+		void MarkComponentChanged()
+		{
+			MEGA_ASSERT(HasComponent<T>(), "Entity does not have component");
+			m_pRegistry->patch<T>(m_enttID);
 		}
 		template<typename T>
 		// TODO: Add move semantics
@@ -126,8 +145,8 @@ namespace Mega
 		}
 
 		// RTTI for collision interface
-		static const char* TypeOf(const Entity* in_pEntity) { return typeid(*in_pEntity).name(); }
-		template<typename T> static const char* TypeOf() { return typeid(T).name(); }
+		static tEntityTypeID TypeOf(const Entity* in_pEntity) { return in_pEntity->m_typeID; }
+		template<typename T> static tEntityTypeID TypeOf() { return EntityType::GetID<T>(); }
 
 
 		// Default transform Getters/Setters
@@ -147,6 +166,10 @@ namespace Mega
 		Entity& operator=(Entity&&) = delete;
 
 		void SetLifetimeState(eEntityState in_state) { m_state = in_state; }
+		bool IsSceneStructureLocked() const; // See Scene::GetCommandBuffer
+		CommandBuffer& GetSceneCommandBuffer() const;
+		void ApplyIsEnabled(const bool in_isOwnerEnabled); // Down the subtree, from SetIsEnabled
+		void ApplyIsActive(const bool in_isActive);
 
 		// Update Control System
 		void Initialize()
@@ -158,15 +181,17 @@ namespace Mega
 
 			MEGA_ASSERT(m_owner != nullptr, "Initializing entity without a parent");
 
-			// Add default transform component
-			m_pTransformComponent = &AddComponent<Component::Transform>();
+			// Add default transform component, instantiated entities come with theirs (see Scene::Instantiate)
+			m_pTransformComponent = HasComponent<Component::Transform>() ? &GetComponent<Component::Transform>() : &AddComponent<Component::Transform>();
 
 			OnInitialize();
 
 			if (HasComponent<Component::RigidBody>())
 			{
 				auto& body = GetComponent<Component::RigidBody>();
-				body.pPhysicsBody->setUserPointer(this);
+				// The physics system finds us again for collision callbacks through the handle, never a raw pointer
+				body.pPhysicsBody->setUserIndex((int)m_handle.index);
+				body.pPhysicsBody->setUserIndex2((int)m_handle.generation);
 			}
 
 			SetLifetimeState(eEntityState::Initialized);
@@ -183,6 +208,22 @@ namespace Mega
 
 			OnUpdatePost(in_dt);
 		}
+		// Called by the scene's per type lists with the entity's exact type, so the override is called directly
+		// instead of through the vtable
+		template<typename tEntityType>
+		void Update(const tTimestep in_dt)
+		{
+			MEGA_ASSERT(IsInitialized(), "Updating an entity in a state other than initialized");
+
+			static_cast<tEntityType*>(this)->tEntityType::OnUpdate(in_dt);
+		}
+		template<typename tEntityType>
+		void UpdatePost(const tTimestep in_dt)
+		{
+			MEGA_ASSERT(IsInitialized(), "Updating an entity in a state other than initialized");
+
+			static_cast<tEntityType*>(this)->tEntityType::OnUpdatePost(in_dt);
+		}
 
 		// Ownership System
 		void SetOwner(const tOwner in_owner)
@@ -199,21 +240,15 @@ namespace Mega
 			}
 		}
 		// Called by SetOwner
-		tChildIndex AppendChild(const tChild in_child)
+		tChildIndex AppendChild(Entity* in_pChild)
 		{
 			const tChildIndex newIndex = (tChildIndex)m_children.size();
-			in_child->m_childIndex = newIndex;
-			m_children.push_back(in_child);
+			in_pChild->m_childIndex = newIndex;
+			m_children.push_back(in_pChild->GetHandle());
 
 			return newIndex;
 		}
-		void RemoveChild(const tChildIndex in_childIndex)
-		{
-			// Swap child to be removed and back of the list, then pop
-			m_children[in_childIndex] = m_children.back();
-			m_children[in_childIndex]->m_childIndex = in_childIndex;
-			m_children.pop_back();
-		}
+		void RemoveChild(const tChildIndex in_childIndex);
 
 		// Children Entities
 		tChildIndex m_childIndex = -1;
@@ -222,6 +257,9 @@ namespace Mega
 
 		// Entity guard
 		eEntityState m_state = eEntityState::Created;
+		tEntityTypeID m_typeID = UINT32_MAX; // Set by Scene to the most derived type's id
+		EntityHandle m_handle;
+		uint32_t m_listIndex = UINT32_MAX; // Position in the scene's list for this type, UINT32_MAX until added (and for the root)
 
 		// ENTT
 		// Defailt transform componentx
@@ -231,5 +269,7 @@ namespace Mega
 		
 		Scene* m_pScene = nullptr; // the scene this entity belongs to
 		bool m_isActive = true; // Determines if entity is updated every frame / returned in Scene's Get() function
+		bool m_isActiveSelf = true; // Set by SetIsActive, m_isActive is this while the entity is enabled
+		bool m_isDisabledSelf = false; // Set by SetIsEnabled(false) on this entity, not by an owner's
 	};
 } // namespace Mega
\ No newline at end of file
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Mega
+{
+	// Refers to an entity without pointing at it. The index picks a slot in the scene's handle table and the
+	// generation has to match the slot's, slots bump their generation when the entity in them is deleted so old
+	// handles resolve to null instead of to whatever reuses the slot (see Scene::GetEntity)
+	struct EntityHandle
+	{
+		uint32_t index = UINT32_MAX;
+		uint32_t generation = 0;
+
+		inline bool IsNull() const { return index == UINT32_MAX; }
+
+		inline bool operator==(const EntityHandle& in_other) const { return index == in_other.index && generation == in_other.generation; }
+		inline bool operator!=(const EntityHandle& in_other) const { return !(*this == in_other); }
+	};
+} // namespace Mega
\ No newline at end of file
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <new>
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <utility>
+
+#include "Engine/Core/Debug.h"
+
+#define ENTITY_POOL_SLAB_SIZE 64 // Entities per slab, a new slab is only allocated once every slot is in use
+
+namespace Mega
+{
+	// Slab allocator for one entity type. Entities of a type sit next to each other in fixed size slabs and freed
+	// slots are reused by the next spawn, so spawning and despawning only touches the heap when the pool has to grow
+	template<typename tEntityType>
+	class EntityPool final
+	{
+	public:
+		EntityPool() = default;
+		~EntityPool()
+		{
+			MEGA_ASSERT(m_liveCount == 0, "Entity pool destroyed while entities are still alive");
+		}
+
+		// Slots point into the slabs, so the pool is not copyable or movable
+		EntityPool(const EntityPool&) = delete;
+		EntityPool(EntityPool&&) = delete;
+		EntityPool& operator=(const EntityPool&) = delete;
+		EntityPool& operator=(EntityPool&&) = delete;
+
+		template<class... Args>
+		tEntityType* Create(Args&&... in_args)
+		{
+			if (!m_pFreeList) { AllocateSlab(); }
+
+			Slot* pSlot = m_pFreeList;
+			m_pFreeList = pSlot->pNextFree;
+			m_liveCount++;
+
+			return new (pSlot->storage) tEntityType(std::forward<Args>(in_args)...);
+		}
+
+		void Delete(tEntityType* in_pEntity)
+		{
+			in_pEntity->~tEntityType();
+
+			Slot* pSlot = reinterpret_cast<Slot*>(in_pEntity);
+			pSlot->pNextFree = m_pFreeList;
+			m_pFreeList = pSlot;
+			m_liveCount--;
+		}
+
+		inline size_t GetSlabCount() const { return m_pSlabs.size(); }
+		inline size_t GetLiveCount() const { return m_liveCount; }
+
+	private:
+		union Slot
+		{
+			Slot() {}
+			~Slot() {}
+
+			alignas(tEntityType) unsigned char storage[sizeof(tEntityType)];
+			Slot* pNextFree;
+		};
+
+		void AllocateSlab()
+		{
+			std::unique_ptr<Slot[]>& pSlab = m_pSlabs.emplace_back(std::make_unique<Slot[]>(ENTITY_POOL_SLAB_SIZE));
+
+			// Thread the new slots onto the free list, first slot first
+			for (uint32_t i = ENTITY_POOL_SLAB_SIZE; i > 0; i--)
+			{
+				pSlab[i - 1].pNextFree = m_pFreeList;
+				m_pFreeList = &pSlab[i - 1];
+			}
+		}
+
+		std::vector<std::unique_ptr<Slot[]>> m_pSlabs;
+		Slot* m_pFreeList = nullptr;
+		size_t m_liveCount = 0;
+	};
+} // namespace Mega
\ No newline at end of file
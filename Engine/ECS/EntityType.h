@@ -0,0 +1,31 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+
+namespace Mega
+{
+	using tEntityTypeID = uint32_t;
+
+	// Hands every entity type a small sequential id the first time it is asked for, so per type data can live in
+	// plain arrays indexed by it instead of being searched for by name
+	class EntityType final
+	{
+	public:
+		template<typename tEntityType>
+		static tEntityTypeID GetID()
+		{
+			static const tEntityTypeID s_id = s_nextID.fetch_add(1, std::memory_order_relaxed);
+			return s_id;
+		}
+
+		// Number of ids handed out so far, every id is below this
+		static tEntityTypeID GetCount() { return s_nextID.load(std::memory_order_relaxed); }
+
+	private:
+		EntityType() = delete;
+
+		static inline std::atomic<tEntityTypeID> s_nextID = 0;
+	};
+} // namespace Mega
\ No newline at end of file
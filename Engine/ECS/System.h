@@ -2,6 +2,8 @@
 
 #include <entt/entt.hpp>
 #include "Engine/Core/Core.h"
+#include "Engine/Core/Profiler.h"
+#include "Engine/ECS/SystemAccess.h"
 
 #ifdef NDEBUG
 #define CHECK_SYSTEM_RESULT(func) \
@@ -16,6 +18,7 @@ namespace Mega
 {
 	class Scene;
 	class Engine;
+	class SystemScheduler;
 }
 
 namespace Mega
@@ -33,6 +36,13 @@ namespace Mega
 	{
 	public:
 		friend Engine;
+		friend SystemScheduler;
+
+		// Name used by the profiler and debug output
+		virtual const char* GetName() const { return "System"; }
+
+		// How many entities the system did work for in its last update, as reported by the system
+		inline uint32_t GetTouchedCount() const { return m_touchedCount; }
 
 	protected:
 		// Systems are only creatable and destroyable by Engine and inherited systems
@@ -49,8 +59,14 @@ namespace Mega
 		virtual eMegaResult OnDestroy() = 0;
 		virtual eMegaResult OnUpdate(const tTimestep in_dt, Scene* in_pScene) = 0;
 
+		// Declares the components and resources OnUpdate touches so the scheduler knows what can run alongside it.
+		// Systems that do not override this run on their own
+		virtual void DeclareAccess(SystemAccess& in_access) const { in_access.SetExclusive(); }
+
 		eSystemState GetState() const { return m_state; }
 
+		inline void SetTouchedCount(const uint32_t in_count) { m_touchedCount = in_count; }
+
 	private:
 		// Systems are not movable or copyable
 		System(const System & in_system) = delete;
@@ -73,6 +89,7 @@ namespace Mega
 		inline void Update(const tTimestep in_dt, Scene * in_pScene)
 		{
 			MEGA_ASSERT(IsInitialized(), "Trying to update unitialized system");
+			MEGA_PROFILE_SCOPE(GetName());
 
 			CHECK_SYSTEM_RESULT(OnUpdate(in_dt, in_pScene));
 		}
@@ -89,6 +106,7 @@ namespace Mega
 		}
 
 		eSystemState m_state = eSystemState::Created;
+		uint32_t m_touchedCount = 0;
 	};
 } // namespace Mega
 
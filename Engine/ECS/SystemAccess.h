@@ -0,0 +1,85 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <entt/entt.hpp>
+
+namespace Mega
+{
+	// Shared state that is not a component but still can not be touched by two systems at once
+	enum class eSystemResource : uint32_t
+	{
+		ImGui = 0, // The ImGui context is not thread safe, any system that calls ImGui in its update uses this. UI belongs in a DebugUI panel, an update runs zero or several times per drawn frame
+	};
+
+	// What a system touches during OnUpdate. The scheduler runs two systems at the same time only when neither
+	// writes something the other reads or writes and they share no resources
+	class SystemAccess
+	{
+	public:
+		template<typename... tComponents>
+		void Reads() { (Add<tComponents>(m_reads), ...); }
+
+		template<typename... tComponents>
+		void Writes() { (Add<tComponents>(m_writes), ...); }
+
+		void Uses(const eSystemResource in_resource) { m_resources.push_back(in_resource); }
+
+		// Conflicts with every other system, used for systems that do not declare their access
+		void SetExclusive() { m_isExclusive = true; }
+
+		bool ConflictsWith(const SystemAccess& in_other) const
+		{
+			if (m_isExclusive || in_other.m_isExclusive) { return true; }
+
+			for (const eSystemResource resource : m_resources)
+			{
+				for (const eSystemResource otherResource : in_other.m_resources)
+				{
+					if (resource == otherResource) { return true; }
+				}
+			}
+
+			return Overlaps(m_writes, in_other.m_writes) || Overlaps(m_writes, in_other.m_reads) || Overlaps(m_reads, in_other.m_writes);
+		}
+
+		// Makes sure every declared component has a storage in the registry. Views lazily create storages, which
+		// would mutate the registry from several threads at once if it happened during a parallel update
+		void PrepareStorages(entt::registry& in_registry) const
+		{
+			for (const ComponentAccess& access : m_reads)  { access.prepareStorage(in_registry); }
+			for (const ComponentAccess& access : m_writes) { access.prepareStorage(in_registry); }
+		}
+
+	private:
+		struct ComponentAccess
+		{
+			entt::id_type id;
+			void(*prepareStorage)(entt::registry&);
+		};
+
+		template<typename tComponent>
+		static void Add(std::vector<ComponentAccess>& in_list)
+		{
+			in_list.push_back({ entt::type_hash<tComponent>::value(), [](entt::registry& in_registry) { (void)in_registry.view<tComponent>(); } });
+		}
+
+		static bool Overlaps(const std::vector<ComponentAccess>& in_a, const std::vector<ComponentAccess>& in_b)
+		{
+			for (const ComponentAccess& a : in_a)
+			{
+				for (const ComponentAccess& b : in_b)
+				{
+					if (a.id == b.id) { return true; }
+				}
+			}
+
+			return false;
+		}
+
+		std::vector<ComponentAccess> m_reads;
+		std::vector<ComponentAccess> m_writes;
+		std::vector<eSystemResource> m_resources;
+		bool m_isExclusive = false;
+	};
+} // namespace Mega
\ No newline at end of file
@@ -0,0 +1,86 @@
+#include "SystemScheduler.h"
+
+#include "Engine/ECS/System.h"
+#include "Engine/Scene/Scene.h"
+
+namespace Mega
+{
+	void SystemScheduler::SetSystems(const std::vector<System*>& in_pSystems)
+	{
+		m_pSystems = in_pSystems;
+		m_isDirty = true;
+	}
+
+	void SystemScheduler::Run(const tTimestep in_dt, Scene* in_pScene, JobSystem& in_jobSystem)
+	{
+		MEGA_PROFILE_SCOPE("SystemScheduler::Run");
+
+		if (m_isDirty || in_pScene != m_pScene)
+		{
+			m_pScene = in_pScene;
+			BuildGraph(in_pScene);
+		}
+		if (m_nodes.empty()) { return; }
+
+		m_dt = in_dt;
+		for (uint32_t i = 0; i < m_nodes.size(); i++)
+		{
+			m_pendingDependencies[i].store(m_nodes[i].dependencyCount, std::memory_order_relaxed);
+		}
+
+		// Kick off everything that does not wait on anything, the rest get submitted as their dependencies finish
+		for (uint32_t i = 0; i < m_nodes.size(); i++)
+		{
+			if (m_nodes[i].dependencyCount == 0)
+			{
+				in_jobSystem.Run([this, i, &in_jobSystem]() { RunNode(i, in_jobSystem); }, &m_frameCounter);
+			}
+		}
+
+		// Dependents are added to the counter before the system they wait on finishes, so it only reaches zero
+		// once every system has run
+		in_jobSystem.Wait(m_frameCounter);
+	}
+
+	void SystemScheduler::BuildGraph(Scene* in_pScene)
+	{
+		m_nodes.clear();
+		m_nodes.resize(m_pSystems.size());
+
+		for (uint32_t i = 0; i < m_pSystems.size(); i++)
+		{
+			Node& node = m_nodes[i];
+			node.pSystem = m_pSystems[i];
+			node.pSystem->DeclareAccess(node.access);
+			node.access.PrepareStorages(in_pScene->GetRegistry());
+
+			// A system depends on every earlier system it conflicts with. Edges that are implied by other
+			// edges are kept, they only cost an extra decrement
+			for (uint32_t j = 0; j < i; j++)
+			{
+				if (node.access.ConflictsWith(m_nodes[j].access))
+				{
+					m_nodes[j].dependents.push_back(i);
+					node.dependencyCount++;
+				}
+			}
+		}
+
+		m_pendingDependencies = std::make_unique<std::atomic<uint32_t>[]>(m_nodes.size());
+		m_isDirty = false;
+	}
+
+	void SystemScheduler::RunNode(const uint32_t in_nodeIndex, JobSystem& in_jobSystem)
+	{
+		const Node& node = m_nodes[in_nodeIndex];
+		node.pSystem->Update(m_dt, m_pScene);
+
+		for (const uint32_t dependent : node.dependents)
+		{
+			if (m_pendingDependencies[dependent].fetch_sub(1, std::memory_order_acq_rel) == 1)
+			{
+				in_jobSystem.Run([this, dependent, &in_jobSystem]() { RunNode(dependent, in_jobSystem); }, &m_frameCounter);
+			}
+		}
+	}
+} // namespace Mega
\ No newline at end of file
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "Engine/Core/Core.h"
+#include "Engine/Core/JobSystem.h"
+#include "Engine/ECS/SystemAccess.h"
+
+// Forward Declarations
+namespace Mega
+{
+	class Scene;
+	class System;
+}
+
+namespace Mega
+{
+	// Runs a list of systems each frame, in parallel wherever their declared access allows. Systems that conflict
+	// keep the order they were given in
+	class SystemScheduler final
+	{
+	public:
+		void SetSystems(const std::vector<System*>& in_pSystems);
+		void Run(const tTimestep in_dt, Scene* in_pScene, JobSystem& in_jobSystem);
+
+	private:
+		struct Node
+		{
+			System* pSystem = nullptr;
+			SystemAccess access;
+			std::vector<uint32_t> dependents; // Nodes that have to wait for this one
+			uint32_t dependencyCount = 0;
+		};
+
+		void BuildGraph(Scene* in_pScene);
+		void RunNode(const uint32_t in_nodeIndex, JobSystem& in_jobSystem);
+
+		std::vector<System*> m_pSystems;
+		std::vector<Node> m_nodes;
+		bool m_isDirty = true;
+
+		// Per frame state
+		std::unique_ptr<std::atomic<uint32_t>[]> m_pendingDependencies;
+		JobCounter m_frameCounter;
+		tTimestep m_dt = 0;
+		Scene* m_pScene = nullptr;
+	};
+} // namespace Mega
\ No newline at end of file
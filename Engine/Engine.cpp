@@ -2,20 +2,107 @@
 
 #include <GLFW/glfw3.h>
 #include <ctime>
+#include <thread>
+#include <iostream>
+#include <algorithm>
 #include "ImGui/Graphics/imgui_impl_glfw.h"
 #include "ImGui/Graphics/imgui_impl_vulkan.h"
 
 #include "Engine/Scene/Scene.h"
+#include "Engine/Scene/SceneSnapshot.h"
+#include "Engine/Core/FrameAllocator.h"
+#include "Engine/Core/Telemetry.h"
+#include "Engine/Core/MemoryTracker.h"
 #include "Engine/Graphics/RendererSystem.h"
+#include "Engine/Graphics/Objects/OBJLoader.h"
 
 Mega::Engine* Mega::Engine::s_instance = new Mega::Engine();
 
 namespace Mega
 {
-	eMegaResult Engine::InitializeImpl()
+	namespace
+	{
+		const tCounterID g_tickCounter = Telemetry::Register("Engine/Ticks", eCounterType::Counter);
+	}
+
+	eMegaResult Engine::InitializeImpl(const EngineSettings& in_settings)
 	{
 		srand((uint32_t)Time());
 
+		m_settings = in_settings;
+		m_mainThreadID = std::this_thread::get_id();
+
+		Profiler::SetThreadName("Main");
+		FrameAllocator::RegisterFrameThread();
+		Profiler::SetSummaryFrameCount(m_settings.profilerSummaryFrameCount);
+		Profiler::SetEnabled(m_settings.isProfilerEnabled);
+		for (uint32_t i = 0; i < (uint32_t)eMemoryTag::Count; i++)
+		{
+			MemoryTracker::SetBudget((eMemoryTag)i, m_settings.memoryBudgets[i]);
+		}
+		if (m_settings.telemetryExportPath) { Telemetry::StartExport(m_settings.telemetryExportPath); }
+
+		if (m_settings.isHeadless)
+		{
+			InitializeHeadlessImGui();
+		}
+		else
+		{
+			InitializeWindow();
+			SetPreciseSleepEnabled(true); // For the frame limiter in Run
+		}
+
+		uint32_t workerThreadCount = m_settings.workerThreadCount;
+		if (workerThreadCount == UINT32_MAX)
+		{
+			const uint32_t coreCount = std::thread::hardware_concurrency();
+			workerThreadCount = coreCount > 1 ? coreCount - 1 : 0;
+		}
+		m_jobSystem.Initialize(workerThreadCount);
+
+		// Setup systems and the default scene
+		m_pPhysicsSystem = new PhysicsSystem;
+		m_pPhysicsSystem->Initialize();
+		m_pSystems.push_back(m_pPhysicsSystem);
+
+		m_pScene = CreateSceneImpl();
+		m_pPhysicsSystem->ActivateScene(m_pScene);
+
+		m_pAnimationSystem = new AnimationSystem;
+		m_pAnimationSystem->Initialize();
+		m_pSystems.push_back(m_pAnimationSystem);
+
+		m_pWindSystem = new WindSystem;
+		m_pWindSystem->Initialize();
+		m_pSystems.push_back(m_pWindSystem);
+
+		// Headless only runs the simulation - nothing to hear or see
+		if (!m_settings.isHeadless)
+		{
+			m_pSoundSystem = new SoundSystem;
+			m_pSoundSystem->Initialize();
+			m_pSystems.push_back(m_pSoundSystem);
+
+			m_pCameraSystem = new CameraSystem;
+			m_pCameraSystem->Initialize();
+			m_pSystems.push_back(m_pCameraSystem);
+
+			m_pRendererSystem = new RendererSystem;
+			m_pRendererSystem->Initialize();
+			m_pSystems.push_back(m_pRendererSystem);
+		}
+		UpdateScheduledSystems();
+
+		MEGA_ADD_DEBUG_PANEL(this, "Engine", [this]() { BuildEngineDebugPanel(); }, true);
+		MEGA_ADD_DEBUG_PANEL(this, "Memory", [this]() { BuildMemoryDebugPanel(); });
+		MEGA_ADD_DEBUG_PANEL(this, "Counters", [this]() { BuildCountersDebugPanel(); });
+
+		m_isInitialized = true;
+
+		return eMegaResult::SUCCESS;
+	}
+	void Engine::InitializeWindow()
+	{
 		// Initialize GLFW and create our application window
 		glfwInit();
 
@@ -41,45 +128,39 @@ namespace Mega
 
 		// Input settings
 		glfwSetInputMode(m_pAppWindow, GLFW_CURSOR, GLFW_CURSOR_DISABLED); // Cursor hidden and movement unrestricted
-
-		// Setup systems and the default scene
-		m_pScene = new Scene();
-		m_pScene->Initialize();
-
-		m_pPhysicsSystem = new PhysicsSystem;
-		m_pPhysicsSystem->Initialize();
-		m_pSystems.push_back(m_pPhysicsSystem);
-
-		m_pAnimationSystem = new AnimationSystem;
-		m_pAnimationSystem->Initialize();
-		m_pSystems.push_back(m_pAnimationSystem);
-
-		m_pWindSystem = new WindSystem;
-		m_pWindSystem->Initialize();
-		m_pSystems.push_back(m_pWindSystem);
-
-		m_pSoundSystem = new SoundSystem;
-		m_pSoundSystem->Initialize();
-		m_pSystems.push_back(m_pSoundSystem);
-
-		m_pCameraSystem = new CameraSystem;
-		m_pCameraSystem->Initialize();
-		m_pSystems.push_back(m_pCameraSystem);
-
-		m_pRendererSystem = new RendererSystem;
-		m_pRendererSystem->Initialize();
-		m_pSystems.push_back(m_pRendererSystem);
-
-		m_isInitialized = true;
-
-		return eMegaResult::SUCCESS;
+	}
+	void Engine::InitializeHeadlessImGui()
+	{
+		// Entities and systems call ImGui freely during their updates, so headless still needs a context. There is no
+		// platform or renderer backend - frames are started and ended without ever building draw data
+		ImGui::CreateContext();
+
+		ImGuiIO& io = ImGui::GetIO();
+		io.DisplaySize = ImVec2(1920.0f, 1080.0f);
+		io.IniFilename = nullptr;
+
+		// NewFrame asserts the font atlas has been built, normally the Vulkan backend does this on upload
+		unsigned char* pPixels = nullptr;
+		int width, height;
+		io.Fonts->GetTexDataAsRGBA32(&pPixels, &width, &height);
 	}
 	eMegaResult Engine::DestroyImpl()
 	{
-		// Clenup our world
+		// A scene still loading may be waiting on the main thread, it is never swapped in
+		if (m_pLoadingScene)
+		{
+			WaitForSceneLoad();
+			m_pLoadingScene->Destroy();
+			delete m_pLoadingScene;
+			m_pLoadingScene = nullptr;
+		}
+
+		// Clenup our world. Before the job system, entities may wait for jobs they started as they are destroyed
 		m_pScene->Destroy();
 		delete m_pScene;
 
+		m_jobSystem.Destroy();
+
 		// Destroy and delete all systems
 		for (System* pSystem : m_pSystems)
 		{
@@ -90,6 +171,26 @@ namespace Mega
 		{
 			delete pSystem;
 		}
+		MEGA_REMOVE_DEBUG_PANELS(this);
+
+		m_headlessMeshes.clear();
+		m_loadedMeshes.clear();
+
+		if (m_settings.isProfilerEnabled)
+		{
+			Profiler::SetEnabled(false);
+			Profiler::ExportChromeTrace(m_settings.profilerTracePath);
+			Profiler::PrintSummary(std::cout);
+		}
+		Telemetry::StopExport();
+
+		if (m_settings.isHeadless)
+		{
+			ImGui::DestroyContext();
+			return eMegaResult::SUCCESS;
+		}
+
+		SetPreciseSleepEnabled(false);
 
 		// Delete our application window
 		glfwDestroyWindow(m_pAppWindow);
@@ -98,16 +199,178 @@ namespace Mega
 		return eMegaResult::SUCCESS;
 	}
 
+	void Engine::UpdateScheduledSystems()
+	{
+		std::vector<System*> pScheduledSystems;
+		for (System* pSystem : m_pSystems)
+		{
+			if (pSystem != m_pPhysicsSystem && pSystem != m_pCameraSystem) { pScheduledSystems.push_back(pSystem); }
+		}
+
+		m_systemScheduler.SetSystems(pScheduledSystems);
+	}
+
 	Scene* Engine::CreateSceneImpl()
 	{
-		m_pScene = new Scene;
-		m_pScene->Initialize();
+		Scene* out_pScene = new Scene;
+		out_pScene->Initialize(m_jobSystem.GetWorkerCount() + 1);
+		TrackSceneChanges(out_pScene);
+		m_pPhysicsSystem->ConnectScene(out_pScene);
+
+		return out_pScene;
+	}
+
+	void Engine::TrackSceneChanges(Scene* in_pScene)
+	{
+		// Before any entities are added, so the first frame sees all of them as added
+		in_pScene->TrackChanges<Component::Light>();
+		in_pScene->TrackChanges<Component::Disabled>();
+	}
+
+	// ------------------ Scene Loading -------------------- //
+	void Engine::StartSceneLoad(std::function<void(Scene*)> in_build)
+	{
+		MEGA_ASSERT(IsMainThread(), "Scenes can only be loaded from the main thread");
+		MEGA_ASSERT(!m_pLoadingScene, "Loading a scene while another one is still loading");
+
+		// Set up here, the loading thread only creates entities (and whatever they load)
+		m_pLoadingScene = CreateSceneImpl();
+		m_isSceneLoaded = false;
+
+		m_sceneLoadThread = std::thread([this, build = std::move(in_build)]()
+		{
+			Profiler::SetThreadName("Scene Loader");
+			{
+				MEGA_PROFILE_SCOPE("Engine::LoadScene");
+				build(m_pLoadingScene);
+			}
+			m_isSceneLoaded = true;
+		});
+	}
+	void Engine::SwapLoadedScene()
+	{
+		MEGA_PROFILE_SCOPE("Engine::SwapLoadedScene");
+		m_sceneLoadThread.join();
+
+		// The old scene's bodies leave the physics world as it is destroyed, so it goes first
+		m_pScene->Destroy();
+		delete m_pScene;
+
+		m_pScene = m_pLoadingScene;
+		m_pLoadingScene = nullptr;
+		m_pPhysicsSystem->ActivateScene(m_pScene);
+	}
+	void Engine::WaitForSceneLoad()
+	{
+		while (!m_isSceneLoaded)
+		{
+			RunMainThreadTasks();
+			std::this_thread::yield();
+		}
+		m_sceneLoadThread.join();
+	}
+
+	void Engine::RunOnMainThread(const std::function<void()>& in_function)
+	{
+		if (IsMainThread())
+		{
+			in_function();
+			return;
+		}
+
+		Engine* pEngine = Get();
+		std::future<void> done;
+		{
+			std::lock_guard<std::mutex> lock(pEngine->m_mainThreadTaskMutex);
+			MainThreadTask& task = pEngine->m_mainThreadTasks.emplace_back();
+			task.function = in_function;
+			done = task.done.get_future();
+			pEngine->m_mainThreadTaskCount.fetch_add(1, std::memory_order_release);
+		}
+		done.wait();
+	}
+	void Engine::WaitForJobs(const JobCounter& in_counter)
+	{
+		MEGA_ASSERT(IsMainThread(), "Only the main thread runs main thread work");
+
+		Engine* pEngine = Get();
+		while (!in_counter.IsDone())
+		{
+			pEngine->RunMainThreadTasks();
+			std::this_thread::yield();
+		}
+	}
+	void Engine::RunMainThreadTasks()
+	{
+		if (m_mainThreadTaskCount.load(std::memory_order_acquire) == 0) { return; }
+
+		std::vector<MainThreadTask> tasks;
+		{
+			std::lock_guard<std::mutex> lock(m_mainThreadTaskMutex);
+			tasks.swap(m_mainThreadTasks);
+			m_mainThreadTaskCount.store(0, std::memory_order_release);
+		}
+
+		for (MainThreadTask& task : tasks)
+		{
+			task.function();
+			task.done.set_value();
+		}
+	}
+
+	void Engine::DumpMemoryReport()
+	{
+		MemoryTracker::PrintReport(std::cout);
+	}
+
+#ifndef MEGA_DISABLE_DEBUG_UI
+	void Engine::BuildEngineDebugPanel()
+	{
+		for (const System* pSystem : m_pSystems)
+		{
+			ImGui::Text("%s touched: %u", pSystem->GetName(), pSystem->GetTouchedCount());
+		}
+		ImGui::Text("Frame memory: %.1f KB", FrameAllocator::GetTotalUsedBytes() / 1024.0f);
+	}
+	void Engine::BuildMemoryDebugPanel()
+	{
+		for (uint32_t i = 0; i < (uint32_t)eMemoryTag::Count; i++)
+		{
+			const MemoryTracker::TagStats stats = MemoryTracker::GetStats((eMemoryTag)i);
+			const bool isOverBudget = stats.budgetBytes > 0 && stats.liveBytes > stats.budgetBytes;
+			ImGui::TextColored(isOverBudget ? ImVec4(1.0f, 0.3f, 0.3f, 1.0f) : ImVec4(1.0f, 1.0f, 1.0f, 1.0f), "%s: %.2f MB (peak %.2f MB), %u allocations last frame",
+				MemoryTracker::GetTagName((eMemoryTag)i), stats.liveBytes / (1024.0f * 1024.0f), stats.peakBytes / (1024.0f * 1024.0f), stats.frameAllocationCount);
+		}
+		if (ImGui::Button("Dump memory report")) { DumpMemoryReport(); }
+	}
+	void Engine::BuildCountersDebugPanel()
+	{
+		// Last frame's
+		for (tCounterID id = 0; id < Telemetry::GetCounterCount(); id++)
+		{
+			ImGui::Text("%s: %lld", Telemetry::GetName(id), (long long)Telemetry::GetValue(id));
+		}
+	}
+#endif
+
+	bool Engine::ShouldClose()
+	{
+		const Engine* pEngine = Get();
+		if (pEngine->m_isCloseRequested) { return true; }
+
+		if (pEngine->m_settings.isHeadless)
+		{
+			return pEngine->m_settings.headlessFrameCount != 0 && pEngine->m_tickCount >= pEngine->m_settings.headlessFrameCount;
+		}
 
-		return m_pScene;
+		return glfwWindowShouldClose(pEngine->m_pAppWindow);
 	}
 
 	eMegaResult Engine::HandleInputImpl()
 	{
+		// No devices to poll, input stays at its default (nothing pressed)
+		if (m_settings.isHeadless) { return eMegaResult::SUCCESS; }
+
 		glfwPollEvents();
 
 		m_input.keyW = (glfwGetKey(m_pAppWindow, GLFW_KEY_W) == GLFW_PRESS);
@@ -135,66 +398,354 @@ namespace Mega
 
 	eMegaResult Engine::UpdateImpl(const tTimestep in_dt)
 	{
+		MEGA_PROFILE_SCOPE("Engine::Update");
+
 		m_dtSum += in_dt;
+		m_tickCount++;
+		Telemetry::Add(g_tickCounter, 1);
 
-		ImGui_ImplVulkan_NewFrame();
-		ImGui_ImplGlfw_NewFrame();
-		ImGui::NewFrame();
+		// Run opens one ImGui frame for all the ticks in a drawn frame, this is for apps calling Update themselves
+		if (!m_isImGuiFrameOpen) { BeginImGuiFrame(in_dt); }
+
+		// Snapshot where everything is before the tick moves it, the renderer blends from here to the tick's result.
+		// Only transforms that moved last tick need it, everything else already matches its snapshot
+		entt::registry& registry = m_pScene->GetRegistry();
+		for (const entt::entity entity : m_pScene->GetChangedTransforms())
+		{
+			if (!registry.valid(entity)) { continue; }
+
+			if (Component::Transform* pTransform = registry.try_get<Component::Transform>(entity)) { pTransform->StorePreviousTransform(); }
+		}
+		m_pScene->ResetChangedTransforms();
 
 		// Pre-physics update
+		m_isUpdatingScene = true;
 		m_pScene->Update(in_dt);
-		m_pPhysicsSystem->OnUpdate(in_dt, m_pScene);
+		{
+			MEGA_PROFILE_SCOPE(m_pPhysicsSystem->GetName());
+			m_pPhysicsSystem->OnUpdate(in_dt, m_pScene);
+		}
 
 		// Post-physics update
 		m_pScene->UpdatePost(in_dt);
-		for (System* pSystem : m_pSystems)
-		{
-			if (pSystem == m_pPhysicsSystem) { continue; }
-			pSystem->Update(in_dt, m_pScene);
-		}
+		m_isUpdatingScene = false;
+
+		// Systems can read transforms in parallel, so none is left dirty for a reader to rebuild
+		m_pScene->FlushTransformChanges();
+
+		// Systems run in parallel, so anything that would add or remove entities or components is recorded into
+		// command buffers and made here in one batch (physics' on_construct callbacks run here too)
+		m_pScene->m_isStructureLocked = true;
+		m_systemScheduler.Run(in_dt, m_pScene, m_jobSystem);
+		m_pScene->m_isStructureLocked = false;
+		m_pScene->FlushCommands();
+
+		m_pScene->FlushTransformChanges();
 
 		return eMegaResult::SUCCESS;
 	}
 
 	eMegaResult Engine::DisplayImpl()
 	{
-		m_pRendererSystem->DisplayScene(m_pScene, m_pCameraSystem->GetActiveCamera());
+		m_frameCount++;
+		{
+			MEGA_PROFILE_SCOPE("Engine::Display");
+			if (!m_isImGuiFrameOpen) { BeginImGuiFrame(m_frameDt); } // The renderer builds UI too
+
+#ifndef MEGA_DISABLE_DEBUG_UI
+			DebugUI::Draw();
+#endif
+
+			if (m_settings.isHeadless)
+			{
+				ImGui::EndFrame(); // Close the frame since nothing will render it
+			}
+			else
+			{
+				m_pCameraSystem->Update(m_frameDt, m_pScene);
+				m_pRendererSystem->DisplayScene(m_pScene, m_pCameraSystem->GetActiveCamera()); // Calls ImGui::Render
+			}
+			m_isImGuiFrameOpen = false;
+		}
+
+		// Everything that reads the changes has run for this frame
+		m_pScene->ClearComponentChanges();
+
+		// Between frames, loading threads and jobs get their main thread work done and a finished scene is swapped in
+		RunMainThreadTasks();
+		if (m_pLoadingScene && m_isSceneLoaded) { SwapLoadedScene(); }
+
+		// Nothing made this frame is used past here
+		FrameAllocator::ResetAll();
+		if constexpr (FrameAllocator::IsTrackingHeapAllocations())
+		{
+			const uint64_t heapAllocationCount = FrameAllocator::GetHeapAllocationCount();
+			if (m_frameCount > m_settings.heapWarmupFrameCount && heapAllocationCount > m_heapAllocationCount)
+			{
+				std::cout << "Frame " << m_frameCount << " made " << heapAllocationCount - m_heapAllocationCount << " heap allocations" << std::endl;
+			}
+			m_heapAllocationCount = FrameAllocator::GetHeapAllocationCount(); // Again, the report allocates too
+		}
+
+		// Display is the last step of a frame
+		MemoryTracker::EndFrame();
+		Telemetry::EndFrame(m_frameCount, m_frameDt);
+		Profiler::EndFrame();
 
 		return eMegaResult::SUCCESS;
 	} 
 
+	void Engine::BeginImGuiFrame(const tTimestep in_dt)
+	{
+		if (m_settings.isHeadless)
+		{
+			ImGui::GetIO().DeltaTime = std::max(in_dt, 0.001f) / 1000.0f; // Has to be positive
+		}
+		else
+		{
+			ImGui_ImplVulkan_NewFrame();
+			ImGui_ImplGlfw_NewFrame();
+		}
+		ImGui::NewFrame();
+
+		m_isImGuiFrameOpen = true;
+	}
+
+	void Engine::RunImpl()
+	{
+		const tTimestep tickDt = GetTickTimestep();
+		const tNanosecond tickDuration = tNanosecond(1000 * 1000 * 1000 / m_settings.simulationTickRate);
+		const tNanosecond frameDuration = m_settings.targetFrameRate > 0 ? tNanosecond(1000 * 1000 * 1000 / m_settings.targetFrameRate) : tNanosecond(0);
+		const uint32_t maxTicksPerFrame = std::max(m_settings.maxTicksPerFrame, 1u);
+
+		const tNanosecond runStartTime = Time<tNanosecond>();
+		tNanosecond lastFrameTime = runStartTime;
+		tNanosecond accumulator = tickDuration; // So the first frame has a tick to draw
+
+		while (!ShouldClose())
+		{
+			const tNanosecond frameStartTime = Time<tNanosecond>();
+			m_frameDt = (frameStartTime - lastFrameTime).count() / 1000.0f / 1000.0f;
+
+			// Headless is not tied to real time, every loop is exactly one tick
+			uint32_t tickCount = 1;
+			if (!m_settings.isHeadless)
+			{
+				accumulator += frameStartTime - lastFrameTime;
+				tickCount = (uint32_t)std::min<int64_t>(accumulator / tickDuration, maxTicksPerFrame);
+				accumulator -= tickDuration * tickCount;
+
+				// Still behind after the max ticks, drop the time instead of trying to make it up next frame
+				if (accumulator >= tickDuration) { accumulator %= tickDuration; }
+
+				m_interpolationAlpha = (float)accumulator.count() / (float)tickDuration.count();
+			}
+			lastFrameTime = frameStartTime;
+
+			HandleInputImpl();
+			BeginImGuiFrame(m_settings.isHeadless ? tickDt : m_frameDt);
+			for (uint32_t i = 0; i < tickCount; i++)
+			{
+				UpdateImpl(tickDt);
+			}
+			DisplayImpl(); // Builds the debug panels, once per drawn frame however many ticks ran
+
+			if (!m_settings.isHeadless && frameDuration > tNanosecond(0))
+			{
+				SleepUntil(frameStartTime + frameDuration);
+			}
+		}
+
+		if (m_settings.isHeadless)
+		{
+			const double elapsedMs = (Time<tNanosecond>() - runStartTime).count() / 1000.0 / 1000.0;
+
+			std::cout << "Headless run: " << m_tickCount << " ticks (" << m_dtSum / 1000.0f << "s simulated) in "
+				<< elapsedMs / 1000.0 << "s, " << elapsedMs / std::max<uint64_t>(m_tickCount, 1) << "ms/tick, "
+				<< m_tickCount / (elapsedMs / 1000.0) << " ticks/s" << std::endl;
+			std::cout << "Entity storage heap allocations: " << m_pScene->GetTotalEntityAllocationCount() << " total, "
+				<< m_pScene->GetEntityAllocationCount() << " in the last tick" << std::endl;
+			for (const System* pSystem : m_pSystems)
+			{
+				std::cout << pSystem->GetName() << " touched " << pSystem->GetTouchedCount() << " entities in the last tick" << std::endl;
+			}
+			MemoryTracker::PrintReport(std::cout);
+		}
+	}
+
 	// ------------------ Asset Loaders -------------------- //
 	VertexData Engine::LoadOBJ(const tFilePath in_filePath)
 	{
 		//MEGA_ASSERT(IsInitialized(), "Trying to load obj while scene is not initialized");
-		return Get()->m_pRendererSystem->LoadOBJ(in_filePath);
+		Engine* pEngine = Get();
+
+		// Parsing and uploading a mesh again for every entity that uses it would also grow the GPU buffers each time
+		{
+			std::lock_guard<std::mutex> lock(pEngine->m_loadedMeshesMutex);
+			auto it = pEngine->m_loadedMeshes.find(std::string(in_filePath));
+			if (it != pEngine->m_loadedMeshes.end())
+			{
+				if (!IsHeadless() && IsMainThread()) { pEngine->m_pRendererSystem->RefreshVertexDataPointers(it->second); }
+				return it->second; // Off the main thread the pointers are as of the main thread's last load
+			}
+		}
+
+		if (IsMainThread()) { return pEngine->AddLoadedMesh(in_filePath, nullptr, {}); }
+
+		// The loading thread parses the file itself, only adding it to the renderer's buffers waits for the main thread
+		std::unique_ptr<HeadlessMesh> pMesh = std::make_unique<HeadlessMesh>();
+		VertexData parsedData{};
+		LoadOBJVertexData(in_filePath.data(), pMesh->vertices, pMesh->indices, &parsedData);
+
+		return LoadOnMainThread<VertexData>([&]() { return pEngine->AddLoadedMesh(in_filePath, std::move(pMesh), parsedData); });
+	}
+	VertexData Engine::AddLoadedMesh(const tFilePath in_filePath, std::unique_ptr<HeadlessMesh> in_pParsedMesh, const VertexData& in_parsedData)
+	{
+		// Loaded by someone else while this one was being parsed
+		auto it = m_loadedMeshes.find(std::string(in_filePath));
+		if (it != m_loadedMeshes.end()) { return it->second; }
+
+		VertexData out_data{};
+		if (IsHeadless())
+		{
+			// Still parse the mesh so things built from the vertex data (like triangle mesh colliders) work. A mesh
+			// parsed by the loading thread already sits in buffers of its own, so it is kept as is
+			if (in_pParsedMesh)
+			{
+				m_headlessMeshes.push_back(std::move(in_pParsedMesh));
+				out_data = in_parsedData;
+			}
+			else
+			{
+				auto& pMesh = m_headlessMeshes.emplace_back(std::make_unique<HeadlessMesh>());
+				LoadOBJVertexData(in_filePath.data(), pMesh->vertices, pMesh->indices, &out_data);
+			}
+		}
+		else if (in_pParsedMesh)
+		{
+			out_data = m_pRendererSystem->AddVertexData(in_pParsedMesh->vertices, in_pParsedMesh->indices, in_parsedData);
+		}
+		else
+		{
+			out_data = m_pRendererSystem->LoadOBJ(in_filePath);
+		}
+
+		std::lock_guard<std::mutex> lock(m_loadedMeshesMutex);
+		m_loadedMeshes.emplace(std::string(in_filePath), out_data);
+
+		// Growing the buffers may have moved them, keep every cached mesh pointing at them for the loading thread
+		if (!IsHeadless())
+		{
+			for (auto& [path, data] : m_loadedMeshes) { m_pRendererSystem->RefreshVertexDataPointers(data); }
+		}
+		return out_data;
 	}
 	AnimatedMesh Engine::LoadAnimatedMesh(const tFilePath in_filePath)
 	{
+		if (!IsMainThread()) { return LoadOnMainThread<AnimatedMesh>([&]() { return LoadAnimatedMesh(in_filePath); }); }
+
 		SKINNING_MAT_INDEX_T skinningMatsIndiceStart = (int32_t)Get()->m_pAnimationSystem->m_glmModels.size();
 
 		AnimatedMesh out_mesh = Get()->m_pAnimationSystem->LoadAnimatedMesh(in_filePath);
 
 		out_mesh.skinningMatsIndiceStart = skinningMatsIndiceStart;
-		out_mesh.vertexData = Get()->m_pRendererSystem->LoadOzzMesh(Get()->m_pAnimationSystem->m_meshes[out_mesh.meshIndex]);
+		if (!IsHeadless()) // Skinning still runs headless, there just aren't any GPU buffers to fill
+		{
+			out_mesh.vertexData = Get()->m_pRendererSystem->LoadOzzMesh(Get()->m_pAnimationSystem->m_meshes[out_mesh.meshIndex]);
+		}
 
+		Get()->RecordAssetPath(eAssetType::AnimatedMesh, out_mesh.meshIndex, in_filePath);
 		return out_mesh;
 	}
 	AnimatedSkeleton Engine::LoadAnimatedSkeleton(const tFilePath in_filePath)
 	{
-		return Get()->m_pAnimationSystem->LoadAnimatedSkeleton(in_filePath);
+		if (!IsMainThread()) { return LoadOnMainThread<AnimatedSkeleton>([&]() { return LoadAnimatedSkeleton(in_filePath); }); }
+
+		const AnimatedSkeleton out_skeleton = Get()->m_pAnimationSystem->LoadAnimatedSkeleton(in_filePath);
+		Get()->RecordAssetPath(eAssetType::Skeleton, out_skeleton.skeletonIndex, in_filePath);
+		return out_skeleton;
 	}
 	Animation Engine::LoadAnimation(const tFilePath in_filePath)
 	{
-		return Get()->m_pAnimationSystem->LoadAnimation(in_filePath);
+		if (!IsMainThread()) { return LoadOnMainThread<Animation>([&]() { return LoadAnimation(in_filePath); }); }
+
+		const Animation out_animation = Get()->m_pAnimationSystem->LoadAnimation(in_filePath);
+		Get()->RecordAssetPath(eAssetType::Animation, out_animation.animationIndex, in_filePath);
+		return out_animation;
 	}
 	TextureData Engine::LoadTexture(const tFilePath in_filePath)
 	{
-		return Get()->m_pRendererSystem->LoadTexture(in_filePath);
+		if (IsHeadless()) { return TextureData{}; } // No texture
+		if (!IsMainThread()) { return LoadOnMainThread<TextureData>([&]() { return LoadTexture(in_filePath); }); }
+
+		const TextureData out_texture = Get()->m_pRendererSystem->LoadTexture(in_filePath);
+		Get()->RecordAssetPath(eAssetType::Texture, out_texture.index, in_filePath);
+		return out_texture;
 	}
 	SoundData Engine::LoadSound(const tFilePath in_filePath)
 	{
-		return Get()->m_pSoundSystem->LoadSound(in_filePath);
+		// AL's null buffer name (0) is a valid id, so sound players can still be set up and played as silence
+		if (IsHeadless()) { return SoundData{ 0, 0.0f }; }
+		if (!IsMainThread()) { return LoadOnMainThread<SoundData>([&]() { return LoadSound(in_filePath); }); }
+
+		const SoundData out_sound = Get()->m_pSoundSystem->LoadSound(in_filePath);
+		Get()->RecordAssetPath(eAssetType::Sound, out_sound.soundID, in_filePath);
+		return out_sound;
 	}
 
+	// ------------------ Asset Paths -------------------- //
+	std::string Engine::FindAssetPath(const VertexData& in_vertexData)
+	{
+		Engine* pEngine = Get();
+		std::lock_guard<std::mutex> lock(pEngine->m_loadedMeshesMutex);
+
+		// Meshes share the renderer's buffers and differ by their range in them. Headless ones all start at 0 but
+		// each have buffers of their own
+		for (const auto& [path, data] : pEngine->m_loadedMeshes)
+		{
+			const bool isSameRange = data.indices[0] == in_vertexData.indices[0] && data.indices[1] == in_vertexData.indices[1];
+			if (isSameRange && (!IsHeadless() || data.pVertexData == in_vertexData.pVertexData)) { return path; }
+		}
+
+		return {};
+	}
+	std::string Engine::FindAssetPath(const TextureData& in_textureData) { return Get()->FindAssetPath(eAssetType::Texture, in_textureData.index); }
+	std::string Engine::FindAssetPath(const SoundData& in_soundData) { return Get()->FindAssetPath(eAssetType::Sound, in_soundData.soundID); }
+	std::string Engine::FindAssetPath(const AnimatedMesh& in_mesh) { return Get()->FindAssetPath(eAssetType::AnimatedMesh, in_mesh.meshIndex); }
+	std::string Engine::FindAssetPath(const AnimatedSkeleton& in_skeleton) { return Get()->FindAssetPath(eAssetType::Skeleton, in_skeleton.skeletonIndex); }
+	std::string Engine::FindAssetPath(const Animation& in_animation) { return Get()->FindAssetPath(eAssetType::Animation, in_animation.animationIndex); }
+
+	void Engine::RecordAssetPath(const eAssetType in_type, const int64_t in_handle, const tFilePath in_filePath)
+	{
+		std::lock_guard<std::mutex> lock(m_assetPathsMutex);
+		m_assetPaths[(size_t)in_type][in_handle] = std::string(in_filePath);
+	}
+	std::string Engine::FindAssetPath(const eAssetType in_type, const int64_t in_handle)
+	{
+		std::lock_guard<std::mutex> lock(m_assetPathsMutex);
+
+		const std::unordered_map<int64_t, std::string>& paths = m_assetPaths[(size_t)in_type];
+		auto it = paths.find(in_handle);
+		return it != paths.end() ? it->second : std::string();
+	}
+
+	// ------------------ Scene Snapshots -------------------- //
+	bool Engine::SaveSnapshot(const Entity* in_pRoot, const tFilePath in_filePath)
+	{
+		return SceneSnapshot::Save(in_pRoot, in_filePath);
+	}
+	Entity* Engine::LoadSnapshot(Entity* in_owner, const tFilePath in_filePath)
+	{
+		SceneSnapshot snapshot;
+		if (!snapshot.Read(in_filePath)) { return nullptr; }
+
+		// A scene that is still loading adds all of its bodies when it is swapped in anyway
+		Engine* pEngine = Get();
+		const bool isActiveScene = in_owner->GetScene() == pEngine->m_pScene;
+		if (isActiveScene) { pEngine->m_pPhysicsSystem->BeginBodyBatch(); }
+		Entity* out_pRoot = snapshot.Instantiate(in_owner);
+		if (isActiveScene) { pEngine->m_pPhysicsSystem->EndBodyBatch(); }
+
+		return out_pRoot;
+	}
 } // namespace Mega
\ No newline at end of file
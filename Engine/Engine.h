@@ -1,11 +1,23 @@
 #pragma once
 
+#include <mutex>
+#include <tuple>
+#include <atomic>
+#include <future>
+#include <string>
+#include <memory>
+#include <thread>
+#include <functional>
+#include <unordered_map>
 #include <GLFW/glfw3.h>
 
 #include "ImGui/imgui.h"
+#include "Engine/EngineSettings.h"
 #include "Engine/ECS/ECS.h"
 #include "Engine/Wind/Wind.h"
 #include "Engine/Core/Core.h"
+#include "Engine/Core/JobSystem.h"
+#include "Engine/ECS/SystemScheduler.h"
 #include "Engine/Sound/Sound.h"
 #include "Engine/Scene/Scene.h"
 #include "Engine/Camera/Camera.h"
@@ -45,12 +57,23 @@ namespace Mega
 		inline static Engine* Get() { return s_instance; }
 
 		// ------------- Creation and Update Functions ------------ //
-		inline static eMegaResult Initialize() { return Get()->InitializeImpl();  }
+		inline static eMegaResult Initialize(const EngineSettings& in_settings = {}) { return Get()->InitializeImpl(in_settings); }
 		inline static eMegaResult Destroy()    { return Get()->DestroyImpl();     }
 		inline static eMegaResult HandleInput() { return Get()->HandleInputImpl(); }
 		inline static eMegaResult Update(const tTimestep in_dt) { return Get()->UpdateImpl(in_dt); }
 		inline static eMegaResult Display() { return Get()->DisplayImpl(); }
 
+		// Runs the frame loop until ShouldClose(), see EngineSettings for the tick and frame rates. HandleInput,
+		// Update, and Display can still be called directly by apps that want their own loop
+		inline static void Run() { Get()->RunImpl(); }
+
+		// ------------ Jobs --------------- //
+		// Splits [in_begin, in_end) into chunks of in_grainSize run across every core, see JobSystem
+		inline static void ParallelFor(const uint32_t in_begin, const uint32_t in_end, const uint32_t in_grainSize, const JobSystem::tRangeJob& in_job)
+		{
+			Get()->m_jobSystem.ParallelFor(in_begin, in_end, in_grainSize, in_job);
+		}
+
 		// ------------ ECS --------------- //
 		template<typename tSystem, class... Args> // Allows users to add custom systems
 		tSystem* AddSystem(Args&&... in_args)
@@ -62,55 +85,162 @@ namespace Mega
 			tSystem* out_system = new tSystem(std::forward<Args>(in_args)...);
 			MEGA_ASSERT(out_system, "System could not be allocated");
 
-			out_system->Initialize(this);
+			out_system->Initialize();
 			m_pSystems.push_back(out_system);
+			UpdateScheduledSystems();
 
 			return out_system;
 		}
 
-		// Adds a child entity to the scene - TODO: this is a hack to inherited entitie's dont have to use Scene to do this
+		// Adds a child entity to the owner's scene - TODO: this is a hack to inherited entitie's dont have to use Scene to do this
 		template<typename tEntityType, class... Args>
 		inline static tEntityType* AddChildEntity(Entity* in_owner, Args&&... in_args)
 		{
-			return Get()->m_pScene->AddEntity<tEntityType>(std::forward<Args>(in_args)...);
+			return in_owner->GetScene()->AddEntity<tEntityType>(in_owner, std::forward<Args>(in_args)...);
 		}
 
+		// Spawns one entity per instance, all starting with the prefab's components, in a single batch (see
+		// Scene::Instantiate). Their rigid bodies join the physics world together. Any extra arguments are passed to
+		// every entity's constructor
+		template<typename tEntityType = PrefabEntity, class... Args>
+		inline static void Instantiate(Entity* in_owner, const Prefab& in_prefab, const std::vector<Prefab::Instance>& in_instances, std::vector<tEntityType*>* out_pEntities = nullptr, const Args&... in_args)
+		{
+			Engine* pEngine = Get();
+			Scene* pScene = in_owner->GetScene();
+
+			// A scene that is still loading adds all of its bodies when it is swapped in anyway
+			const bool isActiveScene = pScene == pEngine->m_pScene;
+			if (isActiveScene) { pEngine->m_pPhysicsSystem->BeginBodyBatch(); }
+			pScene->Instantiate<tEntityType>(in_owner, in_prefab, in_instances, out_pEntities, in_args...);
+			if (isActiveScene) { pEngine->m_pPhysicsSystem->EndBodyBatch(); }
+		}
+
+		// Entity::SetIsEnabled, with every rigid body it brings back joining the physics world together
+		inline static void SetEntityEnabled(Entity* in_pEntity, const bool in_isEnabled)
+		{
+			Engine* pEngine = Get();
+
+			const bool isActiveScene = in_pEntity->GetScene() == pEngine->m_pScene;
+			if (isActiveScene) { pEngine->m_pPhysicsSystem->BeginBodyBatch(); }
+			in_pEntity->SetIsEnabled(in_isEnabled);
+			if (isActiveScene) { pEngine->m_pPhysicsSystem->EndBodyBatch(); }
+		}
+
+		// ------------ Scene Loading --------------- //
+		// Builds a new scene rooted at a tRootEntity on a background thread while the current scene keeps running, then
+		// swaps it in at the end of the frame it finishes in (destroying the current one). Only one scene loads at a time
+		template<typename tRootEntity, class... Args>
+		inline static void LoadSceneAsync(Args&&... in_args)
+		{
+			Get()->StartSceneLoad([args = std::make_tuple(std::forward<Args>(in_args)...)](Scene* in_pScene) mutable
+			{
+				std::apply([in_pScene](auto&&... in_rootArgs) { in_pScene->CreateRootEntity<tRootEntity>(std::move(in_rootArgs)...); }, std::move(args));
+			});
+		}
+		static inline bool IsLoadingScene() { return Get()->m_pLoadingScene != nullptr; }
+
+		// Loaders that need the renderer, audio device or animation system use this when called from the loading
+		// thread. The function runs at the end of the current frame and the caller waits for it, on the main thread
+		// it just runs
+		static void RunOnMainThread(const std::function<void()>& in_function);
+		static inline bool IsMainThread() { return std::this_thread::get_id() == Get()->m_mainThreadID; }
+		// True while entities update on the main thread, anything they make for the tick can live in frame memory
+		static inline bool IsUpdatingScene() { return Get()->m_isUpdatingScene && IsMainThread(); }
+		// Waits on the main thread for jobs that may be loading assets, running their main thread work meanwhile
+		static void WaitForJobs(const JobCounter& in_counter);
+
 		// -------------- Public Asset Loaders ------------------- //
 		// Loaders TODO: modulate and make a asset manager?
-		static VertexData LoadOBJ(const tFilePath in_filePath); // TODO: string_view?
+		static VertexData LoadOBJ(const tFilePath in_filePath); // Each file is only loaded once, later calls share its mesh
 		static AnimatedMesh LoadAnimatedMesh(const tFilePath in_filePath);
 		static AnimatedSkeleton LoadAnimatedSkeleton(const tFilePath in_filePath);
 		static Animation LoadAnimation(const tFilePath in_filePath);
 		static TextureData LoadTexture(const tFilePath in_filePath);
 		static SoundData LoadSound(const tFilePath in_filePath);
 
+		// The file a loaded asset came from, empty if it was not loaded from one (generated meshes, or textures and
+		// sounds while headless). Lets snapshots refer to assets by path instead of by runtime handle
+		static std::string FindAssetPath(const VertexData& in_vertexData);
+		static std::string FindAssetPath(const TextureData& in_textureData);
+		static std::string FindAssetPath(const SoundData& in_soundData);
+		static std::string FindAssetPath(const AnimatedMesh& in_mesh);
+		static std::string FindAssetPath(const AnimatedSkeleton& in_skeleton);
+		static std::string FindAssetPath(const Animation& in_animation);
+
+		// ------------ Scene Snapshots --------------- //
+		// Writes in_pRoot and everything under it to a binary snapshot (see SceneSnapshot)
+		static bool SaveSnapshot(const Entity* in_pRoot, const tFilePath in_filePath);
+		// Recreates a snapshot's entities under in_owner, their rigid bodies joining the physics world together.
+		// Returns the snapshot's root, or null if the file is missing or was written by another version
+		static Entity* LoadSnapshot(Entity* in_owner, const tFilePath in_filePath);
+
 		// ---------- Public Getters ---------- //
 		static inline Scene* GetScene() { return Get()->m_pScene; } // TODO: remove
 		static inline const Input& GetInput() { return Get()->m_input; }
 		static inline GLFWwindow* GetAppWindow() { return Get()->m_pAppWindow; }
+		static inline JobSystem& GetJobSystem() { return Get()->m_jobSystem; }
 		static inline tTimestep Runtime() { return Get()->m_dtSum; } // TODO: should be dt sum or real world runtime?
 
 		static inline void SetWindSimulationCenter(const Vec3& in_center) { Get()->m_pWindSystem->SetWindSimulationCenter(in_center); }
 
-		static inline bool ShouldClose() { return glfwWindowShouldClose(GetAppWindow()); }
+		static inline const EngineSettings& GetSettings() { return Get()->m_settings; }
+		static inline bool IsHeadless() { return Get()->m_settings.isHeadless; }
+		static inline uint64_t GetFrameCount() { return Get()->m_frameCount; } // Drawn frames, each runs zero or more ticks
+		// Prints every subsystem's live and peak memory against its budget, see MemoryTracker. Also on the ImGui overlay
+		static void DumpMemoryReport();
+
+		// Fixed dt (millis) handed to every update by Run
+		static inline tTimestep GetTickTimestep() { return 1000.0f / (tTimestep)Get()->m_settings.simulationTickRate; }
+		// How far the frame being drawn is between the previous tick and the latest one, 0 to 1
+		static inline float GetInterpolationAlpha() { return Get()->m_interpolationAlpha; }
+
+		static bool ShouldClose();
+		static inline void RequestClose() { Get()->m_isCloseRequested = true; }
 		static inline bool IsInitialized() { return Get()->m_isInitialized; }
 
 		// ------------- Physics Helpers --------------- // // TODO: should not be necessary
 		[[nodiscard]] inline static Vec3 PerformRayTestPosition(const Vec3& in_from, const Vec3& in_to)  { return Get()->m_pPhysicsSystem->PerformRayTestPosition(in_from, in_to);  }
 		[[nodiscard]] inline static Vec3 PerformRayTestNormal(const Vec3& in_from, const Vec3& in_to)    { return Get()->m_pPhysicsSystem->PerformRayTestNormal(in_from, in_to);    }
 		[[nodiscard]] inline static bool PerformRayTestCollision(const Vec3& in_from, const Vec3& in_to) { return Get()->m_pPhysicsSystem->PerformRayTestCollision(in_from, in_to); }
+		static inline bool IsPhysicsMultithreaded() { return Get()->m_pPhysicsSystem->IsMultithreaded(); }
+		// Any number of rays and sphere casts in one call, see PhysicsSystem::PerformQueries
+		inline static void PerformQueries(const RayQuery* in_pQueries, RayHit* out_pHits, const uint32_t in_count) { Get()->m_pPhysicsSystem->PerformQueries(in_pQueries, out_pHits, in_count); }
 
 	private:
 		static Engine* s_instance;
 
 		// ---------- Implemented Functions ------------ //
 		Engine() = default;
-		eMegaResult InitializeImpl();
+		eMegaResult InitializeImpl(const EngineSettings& in_settings);
+		void InitializeWindow();
+		void InitializeHeadlessImGui();
 		eMegaResult DestroyImpl();
 		eMegaResult HandleInputImpl();
 		eMegaResult UpdateImpl(const tTimestep in_dt);
 		eMegaResult DisplayImpl();
-		Scene* CreateSceneImpl();
+		void RunImpl();
+		void BeginImGuiFrame(const tTimestep in_dt);
+		Scene* CreateSceneImpl(); // Initialized and connected to the systems, not yet active
+		void UpdateScheduledSystems();
+		void TrackSceneChanges(Scene* in_pScene); // Component types the engine's systems read changes of, see Scene::TrackChanges
+#ifndef MEGA_DISABLE_DEBUG_UI
+		void BuildEngineDebugPanel();
+		void BuildMemoryDebugPanel();
+		void BuildCountersDebugPanel();
+#endif
+
+		void StartSceneLoad(std::function<void(Scene*)> in_build);
+		void SwapLoadedScene();
+		void WaitForSceneLoad(); // Keeps running main thread work for the loading thread until it is done
+		void RunMainThreadTasks();
+
+		template<typename tResult, typename tLoad>
+		static tResult LoadOnMainThread(const tLoad& in_load)
+		{
+			tResult out_result{};
+			RunOnMainThread([&]() { out_result = in_load(); });
+			return out_result;
+		}
 
 		// --------------- Systems -------------- //
 		std::vector<System*> m_pSystems;
@@ -121,11 +251,71 @@ namespace Mega
 		WindSystem* m_pWindSystem = nullptr;
 		SoundSystem* m_pSoundSystem = nullptr;
 
+		// Every system but physics (which has to run between the scene's update and post update) and the camera (which
+		// follows interpolated transforms once per drawn frame) goes through the scheduler
+		SystemScheduler m_systemScheduler;
+		JobSystem m_jobSystem;
+
 		// ------------ Member Variables ---------- //
+		EngineSettings m_settings;
 		Input m_input;
 		tTimestep m_dtSum = 0;
+		uint64_t m_frameCount = 0; // Displayed
+		uint64_t m_tickCount = 0; // Updated, see Run
+		tTimestep m_frameDt = 0; // Real time (millis) since the last drawn frame
+		float m_interpolationAlpha = 1.0f;
+		bool m_isImGuiFrameOpen = false;
+		bool m_isUpdatingScene = false;
+		uint64_t m_heapAllocationCount = 0; // At the end of the last drawn frame, see EngineSettings::heapWarmupFrameCount
+
+		// CPU-side buffers for meshes loaded while headless (normally the renderer owns these). Each mesh gets its
+		// own buffers so the pointers handed out in VertexData are never invalidated by a later load
+		struct HeadlessMesh
+		{
+			std::vector<Vertex> vertices;
+			std::vector<INDEX_TYPE> indices;
+		};
+		std::vector<std::unique_ptr<HeadlessMesh>> m_headlessMeshes;
+
+		// Adds a mesh to the cache (and the renderer's buffers), in_pParsedMesh is the file already parsed by the
+		// loading thread (in_parsedData is what the parse returned) or null to parse it here. Main thread only
+		VertexData AddLoadedMesh(const tFilePath in_filePath, std::unique_ptr<HeadlessMesh> in_pParsedMesh, const VertexData& in_parsedData);
+
+		std::unordered_map<std::string, VertexData> m_loadedMeshes; // By file path, see LoadOBJ
+		std::mutex m_loadedMeshesMutex; // Written by the main thread, also read by the loading thread
+
+		// Paths of the other loaded assets by their handle (texture index, sound id, ozz data index), see FindAssetPath
+		enum class eAssetType
+		{
+			Texture = 0,
+			Sound = 1,
+			AnimatedMesh = 2,
+			Skeleton = 3,
+			Animation = 4,
+			Count = 5
+		};
+		void RecordAssetPath(const eAssetType in_type, const int64_t in_handle, const tFilePath in_filePath);
+		std::string FindAssetPath(const eAssetType in_type, const int64_t in_handle);
+		std::unordered_map<int64_t, std::string> m_assetPaths[(size_t)eAssetType::Count];
+		std::mutex m_assetPathsMutex;
+
+		// ------------ Scene Loading ---------- //
+		struct MainThreadTask
+		{
+			std::function<void()> function;
+			std::promise<void> done;
+		};
+		std::thread::id m_mainThreadID;
+		std::mutex m_mainThreadTaskMutex;
+		std::vector<MainThreadTask> m_mainThreadTasks;
+		std::atomic<uint32_t> m_mainThreadTaskCount = 0; // So frames without any skip the lock
+
+		Scene* m_pLoadingScene = nullptr;
+		std::thread m_sceneLoadThread;
+		std::atomic<bool> m_isSceneLoaded = false;
 
 		bool m_isInitialized = false;
+		bool m_isCloseRequested = false;
 		Scene* m_pScene = nullptr;
 		GLFWwindow* m_pAppWindow = nullptr;
 	};
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+
+#include "Engine/Core/Time.h"
+#include "Engine/Core/Profiler.h"
+#include "Engine/Core/MemoryTracker.h"
+
+namespace Mega
+{
+	// Options given to Engine::Initialize that change how the engine boots
+	struct EngineSettings
+	{
+		// ------------ Headless ------------ //
+		// No window, renderer, camera, audio device, or ImGui backend. Only the simulation systems (physics, animation,
+		// wind) are created and asset loaders that would need the GPU/audio device return CPU-side stand-ins
+		bool isHeadless = false;
+		uint64_t headlessFrameCount = 0; // ShouldClose() returns true after this many updates, 0 means run until RequestClose()
+
+		// ------------ Frame Loop ------------ //
+		// Engine::Run updates the simulation in fixed ticks and draws as often as targetFrameRate allows, blending
+		// transforms between the last two ticks. Headless runs one tick per loop as fast as it can
+		uint32_t simulationTickRate = 30; // Ticks per second, every update gets a dt of 1000 / simulationTickRate millis
+		uint32_t maxTicksPerFrame = 5; // Catch up limit, time past it is dropped so one slow frame can not snowball
+		uint32_t targetFrameRate = 60; // 0 means uncapped
+
+		// ------------ Physics ------------ //
+		// Bullet steps at its own fixed rate, as many times as fit in each tick (carrying the remainder over to the
+		// next). Bodies' motion states are interpolated to the end of the tick, so rates that do not divide the tick
+		// rate still move smoothly. Cost follows simulated time, not the frame rate
+		uint32_t physicsStepRate = 60; // Steps per second
+		uint32_t maxPhysicsSubsteps = 4; // Per tick, must cover a whole tick or simulated time is dropped every tick
+		// Runs Bullet's narrowphase, island solving, and integration on the job system (btDiscreteDynamicsWorldMt).
+		// Needs Bullet built with BT_THREADSAFE, the single threaded world is used otherwise
+		bool isPhysicsMultithreaded = false;
+
+		// ------------ Threading ------------ //
+		uint32_t workerThreadCount = UINT32_MAX; // Job system worker threads, UINT32_MAX means one per core minus the main thread
+
+		// ------------ Memory ------------ //
+		// Built with MEGA_TRACK_HEAP_ALLOCATIONS, every drawn frame after this many ticks that still calls operator new
+		// is reported. Transient allocations should come from the FrameAllocator instead
+		uint64_t heapWarmupFrameCount = 120;
+		// Bytes each MemoryTracker tag may use, indexed by eMemoryTag, 0 for no budget. Going over is printed once each
+		// time it happens and shown in red on the memory overlay
+		size_t memoryBudgets[(size_t)eMemoryTag::Count] = {};
+
+		// ------------ Profiler ------------ //
+		// When enabled the trace is written to profilerTracePath and the per zone summary printed on Engine::Destroy
+		bool isProfilerEnabled = false;
+		uint32_t profilerSummaryFrameCount = PROFILER_DEFAULT_SUMMARY_FRAMES;
+		const char* profilerTracePath = "MegaProfile.json";
+
+		// ------------ Telemetry ------------ //
+		// When set every drawn frame's counters (see Telemetry) are streamed here, .json for JSON, anything else CSV
+		const char* telemetryExportPath = nullptr;
+	};
+} // namespace Mega
\ No newline at end of file
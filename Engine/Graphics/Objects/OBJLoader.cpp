@@ -0,0 +1,99 @@
+#include "OBJLoader.h"
+
+#include <iostream>
+#include <algorithm>
+#include <stdexcept>
+#include <unordered_map>
+
+#define TINYOBJLOADER_IMPLEMENTATION
+#include <TinyObjLoader/tiny_obj_loader.h>
+
+namespace Mega
+{
+	void LoadOBJVertexData(const char* in_objPath, std::vector<Vertex>& in_vertices, std::vector<INDEX_TYPE>& in_indices,
+		VertexData* in_pVertexData, const char* in_MTLDir)
+	{
+		std::vector<INDEX_TYPE>& indices = in_indices;
+		std::vector<Vertex>& vertices = in_vertices;
+
+		tinyobj::attrib_t attrib;
+		std::vector<tinyobj::shape_t> shapes;
+		std::vector<tinyobj::material_t> materials;
+		std::string warning, error;
+
+		bool result = tinyobj::LoadObj(&attrib, &shapes, &materials, &warning, &error, in_objPath, in_MTLDir);
+		if (!result) {
+			std::cout << "Failed to load OBJ" << std::endl;
+			std::cout << error << std::endl;
+			throw std::exception(error.c_str());
+			return;
+		};
+
+		// Set vertex data indices start
+		in_pVertexData->indices[0] = static_cast<uint32_t>(indices.size());
+
+		// Fill it into are format
+		uint32_t vertexCount = 0;
+		std::unordered_map<Vertex, INDEX_TYPE> uniqueVertices;
+		for (const auto& shape : shapes) {
+			for (const auto& index : shape.mesh.indices) {
+				Vertex vertex{};
+
+				//shape.mesh.material_ids[]
+
+				// Positon
+				if (index.vertex_index >= 0) {
+					int in = 3 * index.vertex_index;
+					vertex.pos = {
+						attrib.vertices[(size_t)in + 0],
+						attrib.vertices[(size_t)in + 1],
+						attrib.vertices[(size_t)in + 2]
+					};
+
+					in_pVertexData->max.x = std::max(in_pVertexData->max.x, vertex.pos.x);
+					in_pVertexData->max.y = std::max(in_pVertexData->max.y, vertex.pos.y);
+					in_pVertexData->max.z = std::max(in_pVertexData->max.z, vertex.pos.z);
+				}
+
+				// Texture Coordinate
+				if (index.texcoord_index >= 0) {
+					vertex.texCoord = {
+						attrib.texcoords[(size_t)2 * index.texcoord_index + 0],
+						1.0f - attrib.texcoords[(size_t)(2 * index.texcoord_index + 1)]
+					};
+				}
+
+				// Normal
+				if (index.normal_index >= 0) {
+					float nx = attrib.normals[3 * index.normal_index + 0];
+					float ny = attrib.normals[3 * index.normal_index + 1];
+					float nz = attrib.normals[3 * index.normal_index + 2];
+
+					vertex.normal = glm::normalize(glm::vec3(nx, ny, nz));
+				}
+
+				// Colors
+				float cx = attrib.colors[3 * index.vertex_index + 0];
+				float cy = attrib.colors[3 * index.vertex_index + 1];
+				float cz = attrib.colors[3 * index.vertex_index + 2];
+
+				vertex.color = glm::vec4(cx, cy, cz, 1.0f);
+
+				// Unique Indices
+				if (uniqueVertices.count(vertex) == 0) {
+					uniqueVertices[vertex] = static_cast<INDEX_TYPE>(vertices.size());
+					vertices.push_back(vertex);
+					vertexCount++;
+				}
+
+				indices.push_back(uniqueVertices[vertex]);
+			}
+		}
+
+		// Set the rest of the vertex data
+		in_pVertexData->indices[1] = static_cast<uint32_t>(indices.size());
+		in_pVertexData->pIndexData = indices.data();
+		in_pVertexData->pVertexData = vertices.data();
+		in_pVertexData->vertexCount = vertexCount;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <vector>
+
+#include "Engine/Graphics/Objects/Model.h"
+#include "Engine/Graphics/Objects/Vertex.h"
+
+namespace Mega
+{
+	// Parses an obj file and appends its (deduplicated) vertices and indices onto the given buffers. in_pVertexData
+	// is filled with the index range and pointers needed to access the data once it is in those buffers. Does not
+	// touch the GPU so it is shared by the renderer and headless mode
+	void LoadOBJVertexData(const char* in_objPath, std::vector<Vertex>& in_vertices, std::vector<INDEX_TYPE>& in_indices,
+		VertexData* in_pVertexData, const char* in_MTLDir = MTL_BASE_DIR);
+}
\ No newline at end of file
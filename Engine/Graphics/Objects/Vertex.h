@@ -2,6 +2,8 @@
 
 #include <array>
 
+#include <GLM/gtx/hash.hpp>
+
 #include "Engine/Core/Math/Math.h"
 #include "../Vulkan/VulkanDefines.h"
 
@@ -60,3 +62,13 @@ namespace Mega
 		}
 	};
 }
+
+namespace std {
+	template<> struct hash<Mega::Vertex> {
+		size_t operator()(Mega::Vertex const& vertex) const {
+			return ((hash<glm::vec3>()(vertex.pos) ^
+				(hash<Mega::Vec3>()(vertex.color) << 1)) >> 1) ^
+				(hash<Mega::Vec2>()(vertex.texCoord) << 1);
+		}
+	};
+}
\ No newline at end of file
@@ -39,11 +39,20 @@ namespace Mega
 		return eMegaResult::SUCCESS;
 	}
 
+	void RendererSystem::DeclareAccess(SystemAccess& in_access) const
+	{
+		// What DisplayScene draws from. OnUpdate is empty, but declaring them keeps anything moved into it from
+		// running next to a system that writes them
+		in_access.Reads<Component::Model, Component::AnimatedModel, Component::Water, Component::Light>();
+		in_access.Reads<Component::Transform, Component::Disabled>();
+	}
+
 	void RendererSystem::DisplayScene(const Scene* in_pScene) {
 		MEGA_ASSERT(IsInitialized(), "Trying to display scene with unitialized renderer");
 		MEGA_ASSERT(in_pScene != nullptr, "Trying to display null scene");
 
 		m_pVulkanInstance->DrawFrame(in_pScene);
+		SetTouchedCount(m_pVulkanInstance->m_touchedCount);
 	}
 
 	void RendererSystem::DisplayScene(const Scene* in_pScene, const EulerCamera* in_pCamera) {
@@ -52,6 +61,7 @@ namespace Mega
 
 		m_pVulkanInstance->SetCamera(in_pCamera);
 		m_pVulkanInstance->DrawFrame(in_pScene);
+		SetTouchedCount(m_pVulkanInstance->m_touchedCount);
 	}
 
 	VertexData RendererSystem::LoadOBJ(const tFilePath in_filepath)
@@ -66,6 +76,22 @@ namespace Mega
 
 		return out_vertexData;
 	}
+	VertexData RendererSystem::AddVertexData(const std::vector<Vertex>& in_vertices, const std::vector<INDEX_TYPE>& in_indices, const VertexData& in_parsedData)
+	{
+		MEGA_ASSERT(IsInitialized(), "Trying to add vertex data while renderer is not initialized");
+
+		VertexData out_vertexData = in_parsedData;
+		m_pVulkanInstance->AppendVertexData(in_vertices, in_indices, &out_vertexData);
+
+		Vulkan::VertexBuffer<Vertex>::UpdateData(m_pVulkanInstance->m_vertexBuffer);
+		Vulkan::IndexBuffer::UpdateData(m_pVulkanInstance->m_indexBuffer);
+
+		return out_vertexData;
+	}
+	void RendererSystem::RefreshVertexDataPointers(VertexData& in_vertexData) const
+	{
+		m_pVulkanInstance->RefreshVertexDataPointers(&in_vertexData);
+	}
 
 	AnimatedVertexData RendererSystem::LoadOzzMesh(const ozz::vector<ozz::sample::Mesh>& in_meshes)
 	{
@@ -29,10 +29,15 @@ namespace Mega
 		eMegaResult OnInitialize() override;
 		eMegaResult OnDestroy() override;
 		eMegaResult OnUpdate(const tTimestep in_dt, Scene* in_pScene) override;
+		const char* GetName() const override { return "RendererSystem"; }
+		void DeclareAccess(SystemAccess& in_access) const override;
 
 		void DisplayScene(const Scene* in_pScene);
 		void DisplayScene(const Scene* in_pScene, const EulerCamera* in_pCamera);
 		VertexData LoadOBJ(const tFilePath in_filepath);
+		// Appends a mesh parsed elsewhere (by LoadOBJVertexData into empty buffers) and uploads it
+		VertexData AddVertexData(const std::vector<Vertex>& in_vertices, const std::vector<INDEX_TYPE>& in_indices, const VertexData& in_parsedData);
+		void RefreshVertexDataPointers(VertexData& in_vertexData) const; // The buffers move as more meshes are loaded
 		AnimatedVertexData LoadOzzMesh(const ozz::vector<ozz::sample::Mesh>& in_meshes);
 		TextureData LoadTexture(const tFilePath in_filepath);
 
@@ -18,9 +18,11 @@
 #include "VulkanDefines.h"
 #include "ShaderCompiler.h"
 #include "VulkanImgui.h"
+#include "Engine/Core/Telemetry.h"
 #include "Engine/Scene/Scene.h"
 #include "Engine/ECS/Components.h"
 #include "Engine/Graphics/Objects/Objects.h"
+#include "Engine/Graphics/Objects/OBJLoader.h"
 #include "Engine/Graphics/RendererSystem.h"
 #include "Engine/Wind/WindSystem.h"
 #include "Engine/Engine.h"
@@ -30,9 +32,6 @@
 
 #include <STB/stb_image.h>
 
-#define TINYOBJLOADER_IMPLEMENTATION
-#include <TinyObjLoader/tiny_obj_loader.h>
-
 #ifdef NDEBUG
 const bool g_enableValidationLayers = false;
 const bool g_isDebugMode = false;
@@ -95,6 +94,21 @@ void* g_mappedMemory;
 
 namespace Mega
 {
+	namespace
+	{
+		const tCounterID g_drawCallCounter = Telemetry::Register("Renderer/Draw calls", eCounterType::Counter);
+		const tCounterID g_triangleCounter = Telemetry::Register("Renderer/Triangles", eCounterType::Counter);
+		const tCounterID g_grassInstanceCounter = Telemetry::Register("Renderer/Grass instances", eCounterType::Counter);
+
+		// Every scene draw goes through here so it is counted
+		void DrawIndexed(VkCommandBuffer in_commandBuffer, const uint32_t in_indexCount, const uint32_t in_instanceCount, const uint32_t in_firstIndex)
+		{
+			Telemetry::Add(g_drawCallCounter, 1);
+			Telemetry::Add(g_triangleCounter, (int64_t)(in_indexCount / 3) * in_instanceCount);
+			vkCmdDrawIndexed(in_commandBuffer, in_indexCount, in_instanceCount, in_firstIndex, 0, 0);
+		}
+	}
+
 	static void framebufferResizeCallback(GLFWwindow* window, int width, int height) {
 		auto app = reinterpret_cast<Vulkan*>(glfwGetWindowUserPointer(window));
 		app->m_frameBufferResized = true;
@@ -245,10 +259,17 @@ namespace Mega
 		vkMapMemory(m_device, g_stagingBufferMemory, 0, 4, 0, &g_mappedMemory);
 
 		m_startTime = Mega::Time();
+
+		MEGA_ADD_DEBUG_PANEL(this, "Renderer", []()
+		{
+			ImGui::Text("High Def Grass Blade Count: %d", g_grassBladeCount);
+			ImGui::DragFloat3("Clear Color", &g_clearColor.x, 0.001f);
+		});
 	}
 	void Vulkan::Destroy()
 	{
 		vkDeviceWaitIdle(m_device);
+		MEGA_REMOVE_DEBUG_PANELS(this);
 
 		// ============= ImGui ============= //
 		ImGui_ImplVulkan_Shutdown();
@@ -325,15 +346,15 @@ namespace Mega
 		vkUnmapMemory(m_device, m_animStagingBufferMemory);
 		for (size_t i = 0; i < m_swapchainImages.size(); i++) {
 			vkDestroyBuffer(m_device, m_uniformBuffersVert[i], nullptr);
-			vkFreeMemory(m_device, m_uniformBuffersMemoryVert[i], nullptr);
+			FreeDeviceMemory(m_device, m_uniformBuffersMemoryVert[i]);
 			vkDestroyBuffer(m_device, m_uniformBuffersFrag[i], nullptr);
-			vkFreeMemory(m_device, m_uniformBuffersMemoryFrag[i], nullptr);
+			FreeDeviceMemory(m_device, m_uniformBuffersMemoryFrag[i]);
 			vkDestroyBuffer(m_device, m_ssboAnimation[i], nullptr);
-			vkFreeMemory(m_device, m_ssboAnimationMemory[i], nullptr);
+			FreeDeviceMemory(m_device, m_ssboAnimationMemory[i]);
 			vkDestroyBuffer(m_device, m_ssboWindData[i], nullptr);
-			vkFreeMemory(m_device, m_ssboWindDataMemory[i], nullptr);
+			FreeDeviceMemory(m_device, m_ssboWindDataMemory[i]);
 			vkDestroyBuffer(m_device, m_uboGrassCompute[i], nullptr);
-			vkFreeMemory(m_device, m_uboGrassComputeMemory[i], nullptr);
+			FreeDeviceMemory(m_device, m_uboGrassComputeMemory[i]);
 		}
 
 		// Bloom
@@ -341,15 +362,15 @@ namespace Mega
 
 
 		vkDestroyBuffer(m_device, m_ssboGrassCompute, nullptr);
-		vkFreeMemory(m_device, m_ssboGrassComputeMemory, nullptr);
+		FreeDeviceMemory(m_device, m_ssboGrassComputeMemory);
 		vkDestroyBuffer(m_device, m_ssboGrassLowCompute, nullptr);
-		vkFreeMemory(m_device, m_ssboGrassLowComputeMemory, nullptr);
+		FreeDeviceMemory(m_device, m_ssboGrassLowComputeMemory);
 		vkDestroyBuffer(m_device, m_ssboGrassFlowerCompute, nullptr);
-		vkFreeMemory(m_device, m_ssboGrassFlowerComputeMemory, nullptr);
+		FreeDeviceMemory(m_device, m_ssboGrassFlowerComputeMemory);
 
 		// Animation SSBO Staging Buffer
 		vkDestroyBuffer(m_device, m_animStagingBuffer, nullptr);
-		vkFreeMemory(m_device, m_animStagingBufferMemory, nullptr);
+		FreeDeviceMemory(m_device, m_animStagingBufferMemory);
 
 		vkDestroyDescriptorPool(m_device, m_descriptorPool, nullptr);
 
@@ -363,18 +384,14 @@ namespace Mega
 
 	void Vulkan::DrawFrame(const Scene* in_pScene)
 	{
+		MEGA_PROFILE_SCOPE("Vulkan::DrawFrame");
+
+		m_touchedCount = 0;
+		GatherLights(in_pScene);
+
 		////////////////////////////////////////////////////////////////////////////////
 		// Shadow for first directional light
-		Vec3 lightDirection = { 0, 0, 0 };
-		auto view = in_pScene->GetRegistry().view<const Component::Light>();
-		for (const auto& [entity, l] : view.each())
-		{
-			if (l.lightData.type == eLightTypes::Directional)
-			{
-				lightDirection = l.lightData.direction;
-				break;
-			}
-		}
+		const Vec3 lightDirection = m_directionalLightDirection;
 
 		//ImGui::DragFloat("Size", &g_size);
 		//ImGui::DragFloat("Far", &g_far);
@@ -386,10 +403,16 @@ namespace Mega
 		g_lightSpaceMat = light_projection * lightView;
 		////////////////////////////////////////////////////////////////////////////////
 
-		const auto& viewModels = in_pScene->GetRegistry().view<const Component::Model, const Component::Transform>();
-		const auto& viewAnimatedModels = in_pScene->GetRegistry().view<const Component::AnimatedModel, const Component::Transform>();
-		const auto& viewWaterModels = in_pScene->GetRegistry().view<const Component::Water, const Component::Transform>();
+		// Disabled entities (deactivated world cells) are not drawn
+		const auto& viewModels = in_pScene->GetRegistry().view<const Component::Model, const Component::Transform>(entt::exclude<Component::Disabled>);
+		const auto& viewAnimatedModels = in_pScene->GetRegistry().view<const Component::AnimatedModel, const Component::Transform>(entt::exclude<Component::Disabled>);
+		const auto& viewWaterModels = in_pScene->GetRegistry().view<const Component::Water, const Component::Transform>(entt::exclude<Component::Disabled>);
+
+		// Static and water models are drawn between their last two ticks. Animated models are not, their skinning
+		// matrices already have the tick's world transform baked in by the animation system
+		const float interpolationAlpha = Engine::GetInterpolationAlpha();
 
+		const bool isProfilingAcquire = MEGA_PROFILE_BEGIN("Vulkan::AcquireImage");
 		vkWaitForFences(m_device, 1, &m_inFlightFences[m_currentFrame], VK_TRUE, UINT64_MAX);
 		vkResetFences(m_device, 1, &m_inFlightFences[m_currentFrame]);
 
@@ -408,17 +431,19 @@ namespace Mega
 			assert((result == VK_SUCCESS || result == VK_SUBOPTIMAL_KHR) && "ERROR: Failed to acquire swapchain image");
 		}
 
+		MEGA_PROFILE_END(isProfilingAcquire);
+
 		// Compute submission        
+		const bool isProfilingGrass = MEGA_PROFILE_BEGIN("Vulkan::GrassCompute");
 		VK_CHECK_RESULT(vkWaitForFences(m_device, 1, &m_computeInFlightFences[m_currentFrame], VK_TRUE, UINT64_MAX));
 		VK_CHECK_RESULT(vkResetFences(m_device, 1, &m_computeInFlightFences[m_currentFrame]));
 		VK_CHECK_RESULT(vkResetCommandBuffer(m_grassComputeCommandBuffers[m_currentFrame], 0));
 
-		ImGui::DragInt("High Def Grass Blade Count", &g_grassBladeCount, 0, GRASS_MAX_INSTANCE_COUNT);
-
-		ImGui::DragFloat3("Clear Color", &g_clearColor.x, 0.001f);
-
 		UpdateUniformBuffer(imageIndex, in_pScene);
-		ImGui::Render();
+		{
+			MEGA_PROFILE_SCOPE("ImGui::Render");
+			ImGui::Render();
+		}
 
 		VkCommandBufferBeginInfo computeBeginInfo{};
 		computeBeginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
@@ -453,11 +478,15 @@ namespace Mega
 
 		// =================================== //
 
+		MEGA_PROFILE_END(isProfilingGrass);
+
 		// Mark the image as now being in use by this frame
 		m_imagesInFlight[imageIndex] = m_inFlightFences[m_currentFrame];
 
 		// ============== SHADOW MAPPING ===================== //
 		{
+			MEGA_PROFILE_SCOPE("Vulkan::ShadowPass");
+
 			auto* commandBuffer = &m_shadowMapCommandBuffers[imageIndex];
 
 			VkCommandBufferBeginInfo beginInfo{};
@@ -494,7 +523,7 @@ namespace Mega
 			for (const auto& [entity, m, t] : viewModels.each())
 			{
 				// Push constants
-				pushData.transform = t.GetTransform();
+				pushData.transform = t.GetInterpolatedTransform(interpolationAlpha);
 
 				// TODO: offset this so we dont update g_lightSpaceMat every time
 				vkCmdPushConstants(*commandBuffer, m_shadowMapPipeline.layout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(ShadowMap::PushConstant), &pushData);
@@ -503,7 +532,7 @@ namespace Mega
 				uint32_t s = (uint32_t)m.vertexData.indices[0];
 				uint32_t e = (uint32_t)m.vertexData.indices[1];
 
-				vkCmdDrawIndexed(*commandBuffer, e - s, 1, s, 0, 0);
+				DrawIndexed(*commandBuffer, e - s, 1, s);
 			}
 
 			// ANIMATED MODELS
@@ -520,7 +549,7 @@ namespace Mega
 				{
 					// Push constants
 					pushData.skinningMatsIndiceStart = a.mesh.skinningMatsIndiceStart;
-					pushData.transform = t.GetTransform();
+					pushData.transform = t.GetInterpolatedTransform(interpolationAlpha);
 
 					vkCmdPushConstants(*commandBuffer, m_shadowMapAnimationPipeline.layout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(ShadowMapAnimation::PushConstant), &pushData);
 
@@ -528,7 +557,7 @@ namespace Mega
 					uint32_t s = a.mesh.vertexData.indices[0];
 					uint32_t e = a.mesh.vertexData.indices[1];
 
-					vkCmdDrawIndexed(*commandBuffer, e - s, 1, s, 0, 0);
+					DrawIndexed(*commandBuffer, e - s, 1, s);
 				}
 			}
 
@@ -553,6 +582,7 @@ namespace Mega
 		// =================================================== //
 
 		// ======================= Draw =============== //
+		const bool isProfilingMainPass = MEGA_PROFILE_BEGIN("Vulkan::MainPass");
 		auto* commandBuffer = &m_drawCommandBuffers[imageIndex];
 
 		// Multiple colors for the depth and image attachment
@@ -603,6 +633,7 @@ namespace Mega
 				CopyBuffer(g_stagingBuffer, m_ssboGrassCompute, 4);
 
 				// DRAW
+				Telemetry::Add(g_grassInstanceCounter, grassBladeRenderCount);
 				if (grassBladeRenderCount > 0)
 				{
 					grassPushData.grassType = 0; // High poly grass
@@ -611,7 +642,7 @@ namespace Mega
 
 					uint32_t s = (uint32_t)g_grassBlade.indices[0];
 					uint32_t e = (uint32_t)g_grassBlade.indices[1];
-					vkCmdDrawIndexed(*commandBuffer, e - s, grassBladeRenderCount, s, 0, 0);
+					DrawIndexed(*commandBuffer, e - s, grassBladeRenderCount, s);
 				}
 			}
 
@@ -628,6 +659,7 @@ namespace Mega
 				CopyBuffer(g_stagingBuffer, m_ssboGrassFlowerCompute, 4);
 
 				// DRAW
+				Telemetry::Add(g_grassInstanceCounter, flowerRenderCount);
 				if (flowerRenderCount > 0)
 				{
 					grassPushData.grassType = 2; // Flowers
@@ -636,7 +668,7 @@ namespace Mega
 
 					uint32_t s = (uint32_t)g_flower.indices[0];
 					uint32_t e = (uint32_t)g_flower.indices[1];
-					vkCmdDrawIndexed(*commandBuffer, e - s, flowerRenderCount, s, 0, 0);
+					DrawIndexed(*commandBuffer, e - s, flowerRenderCount, s);
 				}
 			}
 
@@ -653,6 +685,7 @@ namespace Mega
 				CopyBuffer(g_stagingBuffer, m_ssboGrassLowCompute, 4);
 
 				// DRAW
+				Telemetry::Add(g_grassInstanceCounter, grassBladeRenderCountLow);
 				if (grassBladeRenderCountLow > 0)
 				{
 					grassPushData.grassType = 1; // Low poly grass
@@ -661,7 +694,7 @@ namespace Mega
 
 					uint32_t s = (uint32_t)g_grassBladeLow.indices[0];
 					uint32_t e = (uint32_t)g_grassBladeLow.indices[1];
-					vkCmdDrawIndexed(*commandBuffer, e - s, grassBladeRenderCountLow, s, 0, 0);
+					DrawIndexed(*commandBuffer, e - s, grassBladeRenderCountLow, s);
 				}
 			}
 		}
@@ -674,7 +707,8 @@ namespace Mega
 		for (const auto& [entity, m, t] : viewModels.each())
 		{
 			// Push constants
-			pushData.transform = t.GetTransform();
+			if (t.IsInterpolating()) { m_touchedCount++; }
+			pushData.transform = t.GetInterpolatedTransform(interpolationAlpha);
 			pushData.textureIndex = m.textureData.index;
 			m.materialData.SetValues(&pushData.materialValues);
 
@@ -684,7 +718,7 @@ namespace Mega
 			uint32_t s = (uint32_t)m.vertexData.indices[0];
 			uint32_t e = (uint32_t)m.vertexData.indices[1];
 
-			vkCmdDrawIndexed(*commandBuffer, e - s, 1, s, 0, 0);
+			DrawIndexed(*commandBuffer, e - s, 1, s);
 		}
 
 		// ========================= Water ======================================= //
@@ -696,7 +730,7 @@ namespace Mega
 			{
 				// Push constants
 				Water::PushConstant pushData;
-				pushData.transform = t.GetTransform();
+				pushData.transform = t.GetInterpolatedTransform(interpolationAlpha);
 				pushData.textureIndex = w.textureData.index;
 				pushData.time = currentRuntime;
 				w.materialData.SetValues(&pushData.materialValues);
@@ -707,14 +741,14 @@ namespace Mega
 				uint32_t s = w.vertexData.indices[0];
 				uint32_t e = w.vertexData.indices[1];
 
-				vkCmdDrawIndexed(*commandBuffer, e - s, 1, s, 0, 0);
+				DrawIndexed(*commandBuffer, e - s, 1, s);
 			}
 		}
 
 		// ============= Draw Our Skeleton Animation Models ============== //
 		if (viewAnimatedModels.size_hint() > 0)
 		{
-			std::vector<VkDescriptorSet> sets = { m_descriptorSets[imageIndex], m_descriptorSetsAnimation[imageIndex] };
+			const std::array<VkDescriptorSet, 2> sets = { m_descriptorSets[imageIndex], m_descriptorSetsAnimation[imageIndex] };
 			VertexBuffer<AnimatedVertex>::Bind(m_animatedVertexBuffer, commandBuffer);
 			Pipeline::Bind(m_animationPipeline, commandBuffer, imageIndex);
 			vkCmdBindDescriptorSets(*commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_animationPipeline.layout, 0, (uint32_t)sets.size(), sets.data(), 0, nullptr);
@@ -724,7 +758,7 @@ namespace Mega
 			{
 				// Push constants
 				pushData.skinningMatsIndiceStart = a.mesh.skinningMatsIndiceStart;
-				pushData.transform = t.GetTransform();
+				pushData.transform = t.GetInterpolatedTransform(interpolationAlpha);
 				pushData.textureIndex = a.mesh.textureData.index;
 				a.mesh.materialData.SetValues(&pushData.materialValues);
 
@@ -734,7 +768,7 @@ namespace Mega
 				uint32_t s = a.mesh.vertexData.indices[0];
 				uint32_t e = a.mesh.vertexData.indices[1];
 
-				vkCmdDrawIndexed(*commandBuffer, e - s, 1, s, 0, 0);
+				DrawIndexed(*commandBuffer, e - s, 1, s);
 			}
 		}
 		// ==================================================================== //
@@ -743,10 +777,13 @@ namespace Mega
 		vkCmdEndRenderPass(*commandBuffer);
 		result = vkEndCommandBuffer(*commandBuffer);
 		CHECK_VULKAN_RESULT(result, "vkEndCommandBuffer");
+		MEGA_PROFILE_END(isProfilingMainPass);
 
 		// ===================== ImGui =========================== //
 		// Rebuild command buffers
 		{
+			MEGA_PROFILE_SCOPE("Vulkan::ImGuiPass");
+
 			VkResult result;
 
 			result = vkResetCommandPool(m_device, m_imguiObject.m_commandPool, 0);
@@ -781,6 +818,7 @@ namespace Mega
 		}
 
 		// ===================== Submit ============================ //
+		const bool isProfilingSubmit = MEGA_PROFILE_BEGIN("Vulkan::Submit");
 
 		std::vector<VkCommandBuffer> submitCommands = {
 			*commandBuffer,
@@ -811,9 +849,12 @@ namespace Mega
 		result = vkQueueSubmit(m_graphicsQueue, 1, &submitInfo, m_inFlightFences[m_currentFrame]);
 		//std::cout << "Result: " << result << std::endl;
 		assert(result == VK_SUCCESS && "ERROR: vkQueueSubmit() did not return succes");
+		MEGA_PROFILE_END(isProfilingSubmit);
 
 		// ================== Bloom Compute Pass ==================== //
 		{
+			MEGA_PROFILE_SCOPE("Vulkan::PostPass");
+
 			auto* computeCommandBuffer = &m_bloomComputeCommandBuffers[m_currentFrame];
 
 			VK_CHECK_RESULT(vkBeginCommandBuffer(*computeCommandBuffer, &computeBeginInfo));
@@ -939,6 +980,7 @@ namespace Mega
 			VK_CHECK_RESULT(vkQueueSubmit(m_computeQueue, 1, &computeSubmitInfo, VK_NULL_HANDLE));
 		}
 
+		const bool isProfilingPresent = MEGA_PROFILE_BEGIN("Vulkan::Present");
 		VkSwapchainKHR swapChains[] = { m_swapchain };
 
 		VkPresentInfoKHR presentInfo{};
@@ -963,6 +1005,7 @@ namespace Mega
 		else {
 			assert((result == VK_SUCCESS) && "ERROR: Failed to acquire swapchain image");
 		}
+		MEGA_PROFILE_END(isProfilingPresent);
 
 		m_currentFrame = (m_currentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
 	};
@@ -1022,7 +1065,7 @@ namespace Mega
 
 		// Cleanup
 		vkDestroyBuffer(m_device, stagingBuffer, nullptr);
-		vkFreeMemory(m_device, stagingBufferMemory, nullptr);
+		FreeDeviceMemory(m_device, stagingBufferMemory);
 	}
 	void Vulkan::LoadTextureData(const char* in_texPath, TextureData* in_pTextureData) {
 		uint32_t index = m_loadedTextureCount;
@@ -1073,88 +1116,31 @@ namespace Mega
 	{
 		// Loads and stores data into vertex and index buffer given a customobj file and
 		// fills in_pVertexData with proper data to access the data stored in those buffers
-		std::vector<INDEX_TYPE>& indices = m_indexBuffer.indices;
-		std::vector<Vertex>& vertices = m_vertexBuffer.vertices;
-
-		tinyobj::attrib_t attrib;
-		std::vector<tinyobj::shape_t> shapes;
-		std::vector<tinyobj::material_t> materials;
-		std::string warning, error;
-
-		bool result = tinyobj::LoadObj(&attrib, &shapes, &materials, &warning, &error, in_objPath, in_MTLDir);
-		if (!result) {
-			std::cout << "Failed to load OBJ" << std::endl;
-			std::cout << error << std::endl;
-			throw std::exception(error.c_str());
-			return;
-		};
-
-		// Set vertex data indices start
-		in_pVertexData->indices[0] = static_cast<uint32_t>(indices.size());
-
-		// Fill it into are format
-		uint32_t vertexCount = 0;
-		std::unordered_map<Vertex, INDEX_TYPE> uniqueVertices;
-		for (const auto& shape : shapes) {
-			for (const auto& index : shape.mesh.indices) {
-				Vertex vertex{};
-
-				//shape.mesh.material_ids[]
-
-				// Positon
-				if (index.vertex_index >= 0) {
-					int in = 3 * index.vertex_index;
-					vertex.pos = {
-						attrib.vertices[(size_t)in + 0],
-						attrib.vertices[(size_t)in + 1],
-						attrib.vertices[(size_t)in + 2]
-					};
-
-					in_pVertexData->max.x = max(in_pVertexData->max.x, vertex.pos.x);
-					in_pVertexData->max.y = max(in_pVertexData->max.y, vertex.pos.y);
-					in_pVertexData->max.z = max(in_pVertexData->max.z, vertex.pos.z);
-				}
-
-				// Texture Coordinate
-				if (index.texcoord_index >= 0) {
-					vertex.texCoord = {
-						attrib.texcoords[(size_t)2 * index.texcoord_index + 0],
-						1.0f - attrib.texcoords[(size_t)(2 * index.texcoord_index + 1)]
-					};
-				}
-
-				// Normal
-				if (index.normal_index >= 0) {
-					float nx = attrib.normals[3 * index.normal_index + 0];
-					float ny = attrib.normals[3 * index.normal_index + 1];
-					float nz = attrib.normals[3 * index.normal_index + 2];
-
-					vertex.normal = glm::normalize(glm::vec3(nx, ny, nz));
-				}
-
-				// Colors
-				float cx = attrib.colors[3 * index.vertex_index + 0];
-				float cy = attrib.colors[3 * index.vertex_index + 1];
-				float cz = attrib.colors[3 * index.vertex_index + 2];
-
-				vertex.color = glm::vec4(cx, cy, cz, 1.0f);
-
-				// Unique Indices
-				if (uniqueVertices.count(vertex) == 0) {
-					uniqueVertices[vertex] = static_cast<INDEX_TYPE>(vertices.size());
-					vertices.push_back(vertex);
-					vertexCount++;
-				}
+		LoadOBJVertexData(in_objPath, m_vertexBuffer.vertices, m_indexBuffer.indices, in_pVertexData, in_MTLDir);
+		TrackMeshMemory();
+	}
+	void Vulkan::RefreshVertexDataPointers(VertexData* in_pVertexData) const
+	{
+		in_pVertexData->pIndexData = m_indexBuffer.indices.data();
+		in_pVertexData->pVertexData = m_vertexBuffer.vertices.data();
+	}
+	void Vulkan::AppendVertexData(const std::vector<Vertex>& in_vertices, const std::vector<INDEX_TYPE>& in_indices, VertexData* in_pVertexData)
+	{
+		// Indices point at vertices, which now start after everything already in the buffer
+		const INDEX_TYPE vertexOffset = static_cast<INDEX_TYPE>(m_vertexBuffer.vertices.size());
+		const uint32_t indexOffset = static_cast<uint32_t>(m_indexBuffer.indices.size());
 
-				indices.push_back(uniqueVertices[vertex]);
-			}
+		m_vertexBuffer.vertices.insert(m_vertexBuffer.vertices.end(), in_vertices.begin(), in_vertices.end());
+		m_indexBuffer.indices.reserve(m_indexBuffer.indices.size() + in_indices.size());
+		for (const INDEX_TYPE index : in_indices)
+		{
+			m_indexBuffer.indices.push_back(index + vertexOffset);
 		}
 
-		// Set the rest of the vertex data
-		in_pVertexData->indices[1] = static_cast<uint32_t>(indices.size());
-		in_pVertexData->pIndexData = indices.data();
-		in_pVertexData->pVertexData = vertices.data();
-		in_pVertexData->vertexCount = vertexCount;
+		in_pVertexData->indices[0] += indexOffset;
+		in_pVertexData->indices[1] += indexOffset;
+		RefreshVertexDataPointers(in_pVertexData);
+		TrackMeshMemory();
 	}
 
 	void Vulkan::LoadOzzMeshData(const ozz::vector<ozz::sample::Mesh>& in_meshes, AnimatedVertexData* in_pVertexData)
@@ -1288,6 +1274,13 @@ namespace Mega
 		in_pVertexData->pIndexData = indices.data();
 		in_pVertexData->pVertexData = vertices.data();
 		in_pVertexData->vertexCount = static_cast<uint32_t>(vertexCount);
+		TrackMeshMemory();
+	}
+	void Vulkan::TrackMeshMemory()
+	{
+		const size_t bytes = m_vertexBuffer.vertices.capacity() * sizeof(Vertex) + m_animatedVertexBuffer.vertices.capacity() * sizeof(AnimatedVertex)
+			+ m_indexBuffer.indices.capacity() * sizeof(INDEX_TYPE);
+		MemoryTracker::SetTrackedBytes(eMemoryTag::Meshes, m_trackedMeshBytes, bytes);
 	}
 
 	// ================================ Private Functions ============================= //
@@ -2373,7 +2366,7 @@ namespace Mega
 		CopyBuffer(stagingBuffer, in_buffer, bufferSize);
 
 		vkDestroyBuffer(m_device, stagingBuffer, nullptr);
-		vkFreeMemory(m_device, stagingBufferMemory, nullptr);
+		FreeDeviceMemory(m_device, stagingBufferMemory);
 	}
 
 	void Vulkan::UpdateLoadedIndexData(std::vector<INDEX_TYPE>& in_indices, VkBuffer& in_buffer, VkDeviceMemory& in_memory)
@@ -2390,13 +2383,13 @@ namespace Mega
 		vkUnmapMemory(m_device, stagingBufferMemory);
 
 		vkDestroyBuffer(m_device, in_buffer, nullptr);
-		vkFreeMemory(m_device, in_memory, nullptr);
+		FreeDeviceMemory(m_device, in_memory);
 		CreateBuffer(bufferSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, in_buffer, in_memory);
 
 		CopyBuffer(stagingBuffer, in_buffer, bufferSize);
 
 		vkDestroyBuffer(m_device, stagingBuffer, nullptr);
-		vkFreeMemory(m_device, stagingBufferMemory, nullptr);
+		FreeDeviceMemory(m_device, stagingBufferMemory);
 	}
 	void Vulkan::UpdateLoadedTextureData()
 	{
@@ -2432,8 +2425,42 @@ namespace Mega
 				VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, m_uboGrassCompute[i], m_uboGrassComputeMemory[i]);
 		}
 	}
+	void Vulkan::GatherLights(const Scene* in_pScene)
+	{
+		// Lights in cells being enabled or disabled change the list too
+		const Scene::ComponentChanges& changes = in_pScene->GetComponentChanges<Component::Light>();
+		const Scene::ComponentChanges& disabledChanges = in_pScene->GetComponentChanges<Component::Disabled>();
+		if (in_pScene == m_pLightScene && changes.IsEmpty() && disabledChanges.IsEmpty()) { return; }
+		m_pLightScene = in_pScene;
+
+		MEGA_PROFILE_SCOPE("Vulkan::GatherLights");
+
+		m_lightData.clear();
+		bool hasDirectionalLight = false;
+		m_directionalLightDirection = Vec3(0, 0, 0);
+
+		auto view = in_pScene->GetRegistry().view<const Component::Light>(entt::exclude<Component::Disabled>);
+		uint32_t lightCount = 0;
+		for (const auto& [entity, l] : view.each())
+		{
+			lightCount++;
+
+			if (!hasDirectionalLight && l.lightData.type == eLightTypes::Directional)
+			{
+				m_directionalLightDirection = l.lightData.direction;
+				hasDirectionalLight = true;
+			}
+
+			MEGA_ASSERT(m_lightData.size() < MAX_LIGHT_COUNT, "More lights in the scene than the shaders can take");
+			if (m_lightData.size() < MAX_LIGHT_COUNT) { m_lightData.push_back(l.lightData); }
+		}
+		m_touchedCount += lightCount;
+	}
+
 	void Vulkan::UpdateUniformBuffer(uint32_t in_imageIndex, const Scene* in_pScene)
 	{
+		MEGA_PROFILE_SCOPE("Vulkan::UpdateUniformBuffer");
+
 		static auto startTime = std::chrono::high_resolution_clock::now();
 
 		auto currentTime = std::chrono::high_resolution_clock::now();
@@ -2462,14 +2489,8 @@ namespace Mega
 		uboFrag.viewPos = m_pCamera->GetPosition();
 
 		// Lights
-		int count = 0;
-		auto view = in_pScene->GetRegistry().view<const Component::Light>();
-		for (const auto& [entity, l] : view.each())
-		{
-			uboFrag.lights[count] = l.lightData;
-			count++;
-		}
-		uboFrag.lightCount = count;
+		std::copy(m_lightData.begin(), m_lightData.end(), uboFrag.lights);
+		uboFrag.lightCount = (uint32_t)m_lightData.size();
 
 		void* dataFrag;
 		vkMapMemory(m_device, m_uniformBuffersMemoryFrag[in_imageIndex], 0, VK_WHOLE_SIZE, 0, &dataFrag);
@@ -3308,7 +3329,7 @@ namespace Mega
 		allocInfo.allocationSize = memRequirements.size;
 		allocInfo.memoryTypeIndex = FindMemoryType(memRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
 
-		if (vkAllocateMemory(m_device, &allocInfo, nullptr, &m_shadowMapObject.memory) != VK_SUCCESS) {
+		if (AllocateDeviceMemory(m_device, allocInfo, m_shadowMapObject.memory) != VK_SUCCESS) {
 			throw std::runtime_error("failed to allocate image memory!");
 		}
 
@@ -3481,7 +3502,7 @@ namespace Mega
 		allocInfo.allocationSize = memRequirements.size;
 		allocInfo.memoryTypeIndex = FindMemoryType(memRequirements.memoryTypeBits, in_properties);
 
-		result = vkAllocateMemory(m_device, &allocInfo, nullptr, &in_imageMemory);
+		result = AllocateDeviceMemory(m_device, allocInfo, in_imageMemory);
 		assert(result == VK_SUCCESS && "vkAllocateMemory() did not return success");
 
 		vkBindImageMemory(m_device, in_image, in_imageMemory, 0);
@@ -3515,7 +3536,7 @@ namespace Mega
 		allocInfo.allocationSize = memRequirements.size;
 		allocInfo.memoryTypeIndex = FindMemoryType(memRequirements.memoryTypeBits, properties);
 
-		if (vkAllocateMemory(m_device, &allocInfo, nullptr, &imageMemory) != VK_SUCCESS) {
+		if (AllocateDeviceMemory(m_device, allocInfo, imageMemory) != VK_SUCCESS) {
 			throw std::runtime_error("failed to allocate image memory!");
 		}
 
@@ -3738,7 +3759,7 @@ namespace Mega
 		allocInfo.allocationSize = memRequirements.size;
 		allocInfo.memoryTypeIndex = FindMemoryType(memRequirements.memoryTypeBits, in_props);
 
-		result = vkAllocateMemory(m_device, &allocInfo, nullptr, &in_bufferMemory);
+		result = AllocateDeviceMemory(m_device, allocInfo, in_bufferMemory);
 		assert(result == VK_SUCCESS && "ERROR: vkAllocateMemory() in Vulkan::CreateBuffer() did not return success");
 		result = vkBindBufferMemory(m_device, in_buffer, in_bufferMemory, 0);
 		assert(result == VK_SUCCESS && "ERROR: vkBindBufferMemory() did not return success");
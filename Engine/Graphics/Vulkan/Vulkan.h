@@ -29,16 +29,6 @@ namespace Mega
 	struct TextureData;
 }
 
-namespace std {
-	template<> struct hash<Mega::Vertex> {
-		size_t operator()(Mega::Vertex const& vertex) const {
-			return ((hash<glm::vec3>()(vertex.pos) ^
-				(hash<Mega::Vec3>()(vertex.color) << 1)) >> 1) ^
-				(hash<Mega::Vec2>()(vertex.texCoord) << 1);
-		}
-	};
-}
-
 namespace Mega
 {
 	enum class eVulkanInitState {
@@ -59,11 +49,15 @@ namespace Mega
 		void CleanupSwapchain(VkSwapchainKHR* in_pSwapchain);
 
 		void DrawFrame(const Scene* in_pScene);
+		void GatherLights(const Scene* in_pScene); // Only rebuilds m_lightData when a light changed
 
 		void SetCamera(const EulerCamera* in_pCamera);
 
 		void LoadVertexData(const char* in_objPath, VertexData* in_pVertexData, const char* in_MTLDir = MTL_BASE_DIR);
+		void RefreshVertexDataPointers(VertexData* in_pVertexData) const; // Points already loaded data at the buffers' current storage
+		void AppendVertexData(const std::vector<Vertex>& in_vertices, const std::vector<INDEX_TYPE>& in_indices, VertexData* in_pVertexData); // Offsets in_pVertexData's range to where it lands
 		void LoadOzzMeshData(const ozz::vector<ozz::sample::Mesh>& in_meshes, AnimatedVertexData* in_pVertexData);
+		void TrackMeshMemory(); // Reports the CPU copies of the vertex and index buffers to the MemoryTracker
 		void LoadTextureData(const char* in_texPath, TextureData* in_pTextureData);
 
 		void CreateIndexBuffer(std::vector<INDEX_TYPE>& in_indices, VkBuffer& in_buffer, VkDeviceMemory& in_memory);
@@ -89,7 +83,7 @@ namespace Mega
 			CopyBuffer(stagingBuffer, in_buffer, bufferSize);
 
 			vkDestroyBuffer(m_device, stagingBuffer, nullptr);
-			vkFreeMemory(m_device, stagingBufferMemory, nullptr);
+			FreeDeviceMemory(m_device, stagingBufferMemory);
 		}
 		void UpdateLoadedIndexData(std::vector<INDEX_TYPE>& in_indices, VkBuffer& in_buffer, VkDeviceMemory& in_memory);
 		template<typename T>
@@ -108,13 +102,13 @@ namespace Mega
 			vkUnmapMemory(m_device, stagingBufferMemory);
 
 			vkDestroyBuffer(m_device, in_buffer, nullptr);
-			vkFreeMemory(m_device, in_memory, nullptr);
+			FreeDeviceMemory(m_device, in_memory);
 			CreateBuffer(bufferSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, in_buffer, in_memory);
 
 			CopyBuffer(stagingBuffer, in_buffer, bufferSize);
 
 			vkDestroyBuffer(m_device, stagingBuffer, nullptr);
-			vkFreeMemory(m_device, stagingBufferMemory, nullptr);
+			FreeDeviceMemory(m_device, stagingBufferMemory);
 		}
 		void UpdateLoadedTextureData();
 		void UpdateUniformBuffer(uint32_t in_imageIndex, const Scene* in_pScene);
@@ -136,7 +130,7 @@ namespace Mega
 			{
 				assert(in_vib.pVulkanInstance != nullptr);
 				vkDestroyBuffer(in_vib.pVulkanInstance->m_device, in_vib.vertexBuffer, nullptr);
-				vkFreeMemory(in_vib.pVulkanInstance->m_device, in_vib.vertexBufferMemory, nullptr);
+				FreeDeviceMemory(in_vib.pVulkanInstance->m_device, in_vib.vertexBufferMemory);
 			}
 			static void UpdateData(VertexBuffer<T>& in_vib)
 			{
@@ -181,7 +175,7 @@ namespace Mega
 				assert(in_ib.pVulkanInstance != nullptr);
 
 				vkDestroyBuffer(in_ib.pVulkanInstance->m_device, in_ib.indexBuffer, nullptr);
-				vkFreeMemory(in_ib.pVulkanInstance->m_device, in_ib.indexBufferMemory, nullptr);
+				FreeDeviceMemory(in_ib.pVulkanInstance->m_device, in_ib.indexBufferMemory);
 			}
 			static void UpdateData(IndexBuffer& in_ib)
 			{
@@ -207,6 +201,7 @@ namespace Mega
 		VertexBuffer<Mega::Vertex> m_vertexBuffer;
 		VertexBuffer<Mega::AnimatedVertex> m_animatedVertexBuffer;
 		IndexBuffer m_indexBuffer;
+		size_t m_trackedMeshBytes = 0;
 
 	private:
 		struct Pipeline
@@ -401,6 +396,13 @@ namespace Mega
 		RendererSystem* m_pRenderer;
 		const EulerCamera* m_pCamera = nullptr;
 
+		// Lights as of the last frame any of them changed in
+		std::vector<LightData> m_lightData;
+		Vec3 m_directionalLightDirection = Vec3(0, 0, 0); // First directional light's, it casts the shadows
+		const Scene* m_pLightScene = nullptr; // Scene m_lightData was gathered from, a new scene is gathered in full
+
+		uint32_t m_touchedCount = 0; // Models drawn interpolated and lights gathered in the last frame
+
 		// GLFW member variables
 		GLFWwindow* m_pWindow;
 
@@ -4,10 +4,26 @@
 #include <optional>
 
 #include "Engine/Core/Math/Math.h"
+#include "Engine/Core/MemoryTracker.h"
 #include "Engine/Graphics/Objects/Light.h"
 #include "Engine/Graphics/Vulkan/VulkanInclude.h"
 #include "vulkan/vulkan_core.h"
 
+#define MAX_LIGHT_COUNT 99 // Size of the fragment shader's light array
+
+// The renderer's device memory goes through these so it is counted by the MemoryTracker
+inline VkResult AllocateDeviceMemory(VkDevice in_device, const VkMemoryAllocateInfo& in_allocInfo, VkDeviceMemory& out_memory)
+{
+	const VkResult result = vkAllocateMemory(in_device, &in_allocInfo, nullptr, &out_memory);
+	if (result == VK_SUCCESS) { Mega::MemoryTracker::AllocateHandle(Mega::eMemoryTag::DeviceMemory, (uint64_t)out_memory, in_allocInfo.allocationSize); }
+	return result;
+}
+inline void FreeDeviceMemory(VkDevice in_device, VkDeviceMemory in_memory)
+{
+	Mega::MemoryTracker::FreeHandle((uint64_t)in_memory);
+	vkFreeMemory(in_device, in_memory, nullptr);
+}
+
 struct UBOBlurParams {
 	float blurScale = 1.0f;
 	float blurStrength = 1.5f;
@@ -57,7 +73,7 @@ struct UniformBufferObjectFrag {
 
 	glScalarUI lightCount;
 
-	Mega::LightData lights[99];
+	Mega::LightData lights[MAX_LIGHT_COUNT];
 };
 struct UniformBufferObjectFragPost {
 	using glScalarF = float;
@@ -89,7 +105,7 @@ struct ImageObject {
 	{
 		vkDestroyImage(*in_pDevice, in_pImage->image, nullptr);
 		vkDestroyImageView(*in_pDevice, in_pImage->view, nullptr);
-		vkFreeMemory(*in_pDevice, in_pImage->memory, nullptr);
+		FreeDeviceMemory(*in_pDevice, in_pImage->memory);
 	}
 
 	VkImage image;
@@ -23,14 +23,10 @@ namespace Mega
 			SetPosition({ 0, 0, 0 }); // Setting ENTITY position
 		}
 
-		void OnUpdate(const tTimestep in_dt) override
-		{
-			m_pLightData->direction = GetLightDirection();
-		}
-
-		void SetLightDirection(const Mega::Vec3& in_dir) { m_direction = in_dir; m_pLightData->direction = in_dir; }
+		void SetLightDirection(const Mega::Vec3& in_dir) { m_direction = in_dir; m_pLightData->direction = in_dir; MarkLightChanged(); }
 		Mega::Vec3 GetLightDirection() const { return m_direction; }
 		LightData* GetLightData() { return m_pLightData; }
+		void MarkLightChanged() { MarkComponentChanged<Component::Light>(); } // After editing GetLightData() in place
 
 	private:
 		LightData* m_pLightData = nullptr;
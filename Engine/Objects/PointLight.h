@@ -23,14 +23,10 @@ namespace Mega
 			SetLightPosition(m_position);
 		}
 
-		void OnUpdate(const tTimestep in_dt) override
-		{
-			m_pLightData->position = GetLightPosition();
-		}
-
-		void SetLightPosition(const Mega::Vec3& in_pos) { m_position = in_pos; m_pLightData->position = in_pos; SetPosition(m_position); }
+		void SetLightPosition(const Mega::Vec3& in_pos) { m_position = in_pos; m_pLightData->position = in_pos; SetPosition(m_position); MarkLightChanged(); }
 		Mega::Vec3 GetLightPosition() const { return m_position; }
 		LightData* GetLightData() { return m_pLightData; }
+		void MarkLightChanged() { MarkComponentChanged<Component::Light>(); } // After editing GetLightData() in place
 
 	private:
 		LightData* m_pLightData = nullptr;
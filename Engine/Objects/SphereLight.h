@@ -30,10 +30,15 @@ namespace Mega
 
 		void OnUpdate(const tTimestep in_dt) override
 		{
+			// Follows the entity, only worth re-uploading when it moved
+			if (m_pLightData->position == GetPosition()) { return; }
+
 			m_pLightData->position = GetPosition();
+			MarkLightChanged();
 		}
 
 		LightData* GetLightData() { return m_pLightData; }
+		void MarkLightChanged() { MarkComponentChanged<Component::Light>(); } // After editing GetLightData() in place
 
 	private:
 		LightData* m_pLightData = nullptr;
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+
+#include "Engine/Core/Math/Math.h"
+#include "Engine/ECS/EntityHandle.h"
+
+// Contact events an entity asks for (RigidBody::SetContactEvents), a bit per eContactEvent. Bodies start with none
+#define CONTACT_EVENTS_NONE 0u
+#define CONTACT_EVENTS_ALL 0x7u
+
+namespace Mega
+{
+	enum class eContactEvent : uint32_t
+	{
+		Begin = 0, // The pair touches in this tick but did not in the last
+		Stay = 1, // Touches in both
+		End = 2, // Touched in the last tick only, also sent when one of the bodies left the world
+		Count = 3
+	};
+	constexpr inline uint32_t ContactEventBit(const eContactEvent in_event) { return 1u << (uint32_t)in_event; }
+
+	// A touching pair of entities in a tick, as seen by the entity it is given to (see Entity::OnContact)
+	struct ContactEvent
+	{
+		eContactEvent type = eContactEvent::Begin;
+		EntityHandle entity{}; // The one receiving the event
+		EntityHandle other{};
+		Vec3 position = { 0, 0, 0 }; // World space, of the deepest contact point
+		Vec3 normal = { 0, 0, 0 }; // Points from the other entity into this one
+		float impulse = 0.0f; // Applied by the solver over all the pair's contact points in the last step, 0 for End
+	};
+} // namespace Mega
\ No newline at end of file
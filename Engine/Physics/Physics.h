@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Engine/Physics/RayTest.h"
+#include "Engine/Physics/ContactEvent.h"
 #include "Engine/Physics/PhysicsSystem.h"
 #include "Engine/Physics/PhysicsComponents.h"
 
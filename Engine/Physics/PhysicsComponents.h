@@ -32,9 +32,14 @@ namespace Mega
 			Vec3 GetMotionStatePosition() const;
 			Vec3 GetLinearVelocity() const;
 			tScalar GetGravity() const { return gravity; }
-			void SetLinearVelocity(const Vec3& in_velocity) { pPhysicsBody->setLinearVelocity({ in_velocity.x, in_velocity.y, in_velocity.z }); }
-			void SetGravity(tScalar in_gravity) { pPhysicsBody->setGravity({ 0, in_gravity, 0 }); gravity = in_gravity; }
+			// Bodies at rest sleep, anything that should move them wakes them first
+			void SetLinearVelocity(const Vec3& in_velocity) { pPhysicsBody->activate(); pPhysicsBody->setLinearVelocity({ in_velocity.x, in_velocity.y, in_velocity.z }); }
+			void SetGravity(tScalar in_gravity) { pPhysicsBody->activate(); pPhysicsBody->setGravity({ 0, in_gravity, 0 }); gravity = in_gravity; }
+			void ApplyCentralForce(const Vec3& in_force) { pPhysicsBody->activate(); pPhysicsBody->applyCentralForce({ in_force.x, in_force.y, in_force.z }); }
+			void ApplyCentralImpulse(const Vec3& in_impulse) { pPhysicsBody->activate(); pPhysicsBody->applyCentralImpulse({ in_impulse.x, in_impulse.y, in_impulse.z }); }
 			void SyncRotation(bool in_bool);
+			// CONTACT_EVENTS_NONE by default, ContactEventBit(eContactEvent::...) for each event wanted (see Entity::OnContact)
+			void SetContactEvents(uint32_t in_events) { contactEvents = in_events; pPhysicsBody->setUserIndex3((int)in_events); }
 
 			eRigidBodyType type = eRigidBodyType::Dynamic;
 			tScalar mass = 1.0;
@@ -43,10 +48,10 @@ namespace Mega
 			tScalar gravity = -9.8f;
 
 			bool syncRot = true;
+			uint32_t contactEvents = CONTACT_EVENTS_NONE;
 
-			btPersistentManifold* pCollisionManifoldData = nullptr;
 			btRigidBody* pPhysicsBody = nullptr;
-			btDefaultMotionState* pMotionState = nullptr;
+			PhysicsSystem::MotionState* pMotionState = nullptr;
 			Vec3 localOffset = { 0, 0, 0 };
 		};
 
@@ -1,32 +1,146 @@
 #include "PhysicsSystem.h"
 
+#include <iostream>
+#include <algorithm>
+#include <Bullet3D/LinearMath/btThreads.h>
 #include <Bullet3D/LinearMath/btQuickprof.h>
+#include <Bullet3D/LinearMath/btAlignedAllocator.h>
 #include <Bullet3D/BulletCollision/NarrowPhaseCollision/btRaycastCallback.h>
+#include <Bullet3D/BulletCollision/CollisionDispatch/btCollisionDispatcherMt.h>
+#include <Bullet3D/BulletDynamics/ConstraintSolver/btSequentialImpulseConstraintSolverMt.h>
 #include "Bullet3D/Bullet3Collision/NarrowPhaseCollision/b3RaycastInfo.h"
 
 #include "Engine/Engine.h"
 #include "Engine/ECS/Entity.h"
 #include "Engine/Scene/Scene.h"
 #include "Engine/Core/Math/Math.h"
+#include "Engine/Core/Telemetry.h"
+#include "Engine/Core/FrameAllocator.h"
+#include "Engine/Core/MemoryTracker.h"
 #include "Engine/Physics/PhysicsComponents.h"
 
+#include "ImGui/imgui.h"
+
 namespace Mega
 {
+	namespace
+	{
+		const tCounterID g_movedBodyCounter = Telemetry::Register("Physics/Moved bodies", eCounterType::Gauge);
+		const tCounterID g_manifoldCounter = Telemetry::Register("Physics/Contact manifolds", eCounterType::Gauge);
+		const tCounterID g_queryCounter = Telemetry::Register("Physics/Queries", eCounterType::Counter);
+		const tCounterID g_stepCounter = Telemetry::Register("Physics/Steps", eCounterType::Counter);
+		const tCounterID g_stepTimeCounter = Telemetry::Register("Physics/Step time (us)", eCounterType::Counter);
+		const tCounterID g_slowestStepCounter = Telemetry::Register("Physics/Slowest step (us)", eCounterType::Gauge); // Of the last tick
+		const tCounterID g_contactEventCounter = Telemetry::Register("Physics/Contact events", eCounterType::Counter);
+
+		// Bodies carry their entity's handle in the user indices (see Entity::Initialize)
+		EntityHandle GetBodyEntity(const btCollisionObject* in_pBody)
+		{
+			return { (uint32_t)in_pBody->getUserIndex(), (uint32_t)in_pBody->getUserIndex2() };
+		}
+		uint64_t PackHandle(const EntityHandle& in_handle)
+		{
+			return ((uint64_t)in_handle.index << 32) | in_handle.generation;
+		}
+
+		// Hands Bullet's parallel loops to the engine's job system, so the multithreaded world shares the worker
+		// threads with everything else instead of starting its own pool
+		class JobSystemTaskScheduler final : public btITaskScheduler
+		{
+		public:
+			JobSystemTaskScheduler()
+				: btITaskScheduler("JobSystem") {};
+
+			int getMaxNumThreads() const override { return (int)Engine::GetJobSystem().GetWorkerCount() + 1; }
+			int getNumThreads() const override { return getMaxNumThreads(); }
+			void setNumThreads(int in_threadCount) override {} // Sized by EngineSettings::workerThreadCount
+
+			void parallelFor(int in_begin, int in_end, int in_grainSize, const btIParallelForBody& in_body) override
+			{
+				Engine::ParallelFor((uint32_t)in_begin, (uint32_t)in_end, (uint32_t)in_grainSize, [&in_body](const uint32_t in_chunkBegin, const uint32_t in_chunkEnd)
+				{
+					in_body.forLoop((int)in_chunkBegin, (int)in_chunkEnd);
+				});
+			}
+			btScalar parallelSum(int in_begin, int in_end, int in_grainSize, const btIParallelSumBody& in_body) override
+			{
+				if (in_begin >= in_end) { return 0; }
+
+				// A sum per chunk, added up in order afterwards so the result does not depend on which thread ran what
+				const uint32_t grainSize = (uint32_t)std::max(in_grainSize, 1);
+				tFrameVector<btScalar> chunkSums(((uint32_t)(in_end - in_begin) + grainSize - 1) / grainSize, 0);
+				Engine::ParallelFor((uint32_t)in_begin, (uint32_t)in_end, grainSize, [&](const uint32_t in_chunkBegin, const uint32_t in_chunkEnd)
+				{
+					chunkSums[(in_chunkBegin - in_begin) / grainSize] = in_body.sumLoop((int)in_chunkBegin, (int)in_chunkEnd);
+				});
+
+				btScalar out_sum = 0;
+				for (const btScalar sum : chunkSums) { out_sum += sum; }
+				return out_sum;
+			}
+		};
+		JobSystemTaskScheduler g_taskScheduler;
+	}
+
 	eMegaResult PhysicsSystem::OnInitialize()
 	{
 		// Initialize Bullet 3D //
-		m_collisionConfiguration = new btDefaultCollisionConfiguration();
+		// Everything Bullet allocates goes through here, so it is counted under physics. Set before anything is made
+		btAlignedAllocSetCustom([](size_t in_size) { return MemoryTracker::AllocateTagged(eMemoryTag::Physics, in_size); }, [](void* in_pMemory) { MemoryTracker::FreeTagged(in_pMemory); });
 
-		m_dispatcher = new btCollisionDispatcher(m_collisionConfiguration);
-		m_overlappingPairCache = new btDbvtBroadphase();
-		m_solver = new btSequentialImpulseConstraintSolver;
+		const EngineSettings& settings = Engine::GetSettings();
+#if BT_THREADSAFE
+		m_isMultithreaded = settings.isPhysicsMultithreaded;
+#else
+		if (settings.isPhysicsMultithreaded) { std::cout << "Bullet was not built with BT_THREADSAFE, physics runs single threaded" << std::endl; }
+#endif
 
-		m_pPhysicsWorld = new btDiscreteDynamicsWorld(m_dispatcher, m_overlappingPairCache, m_solver, m_collisionConfiguration);
+		m_overlappingPairCache = new btDbvtBroadphase();
+		if (m_isMultithreaded)
+		{
+			// Bullet numbers threads as they first call into it and treats thread 0 as the main thread, so claim it
+			// before a worker can
+			btGetCurrentThreadIndex();
+			MEGA_ASSERT(Engine::GetJobSystem().GetWorkerCount() + 1 <= BT_MAX_THREAD_COUNT, "More threads than Bullet can tell apart, lower EngineSettings::workerThreadCount");
+			btSetTaskScheduler(&g_taskScheduler);
+
+			// Contacts are made from several threads at once, so the pools are sized up front instead of growing
+			btDefaultCollisionConstructionInfo constructionInfo;
+			constructionInfo.m_defaultMaxPersistentManifoldPoolSize = 80000;
+			constructionInfo.m_defaultMaxCollisionAlgorithmPoolSize = 80000;
+			m_collisionConfiguration = new btDefaultCollisionConfiguration(constructionInfo);
+
+			m_dispatcher = new btCollisionDispatcherMt(m_collisionConfiguration);
+			m_solver = new btSequentialImpulseConstraintSolverMt;
+			m_pSolverPool = new btConstraintSolverPoolMt(g_taskScheduler.getNumThreads());
+			m_pPhysicsWorld = new btDiscreteDynamicsWorldMt(m_dispatcher, m_overlappingPairCache, m_pSolverPool, m_solver, m_collisionConfiguration);
+		}
+		else
+		{
+			m_collisionConfiguration = new btDefaultCollisionConfiguration();
+			m_dispatcher = new btCollisionDispatcher(m_collisionConfiguration);
+			m_solver = new btSequentialImpulseConstraintSolver;
+			m_pPhysicsWorld = new btDiscreteDynamicsWorld(m_dispatcher, m_overlappingPairCache, m_solver, m_collisionConfiguration);
+		}
 		m_pPhysicsWorld->setGravity(btVector3(0.0f, m_globalGravity, 0.0f));
 		//m_pPhysicsWorld->getDebugDrawer()->setDebugMode(btIDebugDraw::DBG_NoDebug);
 
+		m_fixedStep = 1.0f / (btScalar)std::max(settings.physicsStepRate, 1u);
+		m_maxSubsteps = (int)std::max(settings.maxPhysicsSubsteps, 1u);
+		MEGA_ASSERT(m_maxSubsteps * m_fixedStep * 1000.0f >= Engine::GetTickTimestep(), "maxPhysicsSubsteps can not cover a tick at physicsStepRate, simulated time would be dropped every tick");
+
+		m_pPhysicsWorld->setInternalTickCallback(&PhysicsSystem::OnPreStep, this, true);
+		m_pPhysicsWorld->setInternalTickCallback(&PhysicsSystem::OnPostStep, this, false);
+
+		MEGA_ADD_DEBUG_PANEL(this, "Physics", [this]() { BuildDebugPanel(); });
+
+		return eMegaResult::SUCCESS;
+	};
+
+	void PhysicsSystem::ConnectScene(Scene* in_pScene)
+	{
 		// Connect the creation callbacks for each physics component so they can be added to the world during creation
-		auto& registry = Engine::GetScene()->GetRegistry();
+		auto& registry = in_pScene->GetRegistry();
 		registry.on_construct<Component::CollisionBox>().connect<&PhysicsSystem::OnConstructCollisionBoxComponent>(this);
 		registry.on_destroy<Component::CollisionBox>().connect<&PhysicsSystem::OnDestroyCollisionBoxComponent>(this);
 		registry.on_construct<Component::CollisionSphere>().connect<&PhysicsSystem::OnConstructCollisionSphereComponent>(this);
@@ -39,18 +153,39 @@ namespace Mega
 		registry.on_destroy<Component::CollisionTriangleMesh>().connect<&PhysicsSystem::OnDestroyCollisionTriangleMeshComponent>(this);
 		registry.on_construct<Component::RigidBody>().connect<&PhysicsSystem::OnConstructRigidBodyComponent>(this);
 		registry.on_destroy<Component::RigidBody>().connect<&PhysicsSystem::OnDestroyRigidBodyComponent>(this);
+		registry.on_construct<Component::Disabled>().connect<&PhysicsSystem::OnConstructDisabledComponent>(this);
+		registry.on_destroy<Component::Disabled>().connect<&PhysicsSystem::OnDestroyDisabledComponent>(this);
+	}
+	void PhysicsSystem::ActivateScene(Scene* in_pScene)
+	{
+		m_pActiveRegistry = &in_pScene->GetRegistry();
 
-		return eMegaResult::SUCCESS;
-	};
+		// Handles are per scene, the last scene's pairs would resolve to this one's entities. They end unannounced
+		m_contactPairs.clear();
+
+		std::lock_guard<std::mutex> lock(m_loadingBodiesMutex);
+		BeginBodyBatch();
+		for (btRigidBody* pBody : m_pLoadingBodies)
+		{
+			AddInitializedRigidBody(pBody);
+		}
+		m_pLoadingBodies.clear();
+		EndBodyBatch();
+	}
 
 	eMegaResult PhysicsSystem::OnDestroy()
 	{
+		MEGA_ASSERT(m_sharedShapeKeys.empty(), "Physics system destroyed while colliders still use shared shapes");
+		MEGA_REMOVE_DEBUG_PANELS(this);
+
 		// Cleanup Bullet3D //
 		delete m_pPhysicsWorld;
+		delete m_pSolverPool;
 		delete m_solver;
 		delete m_overlappingPairCache;
 		delete m_dispatcher;
 		delete m_collisionConfiguration;
+		if (m_isMultithreaded) { btSetTaskScheduler(btGetSequentialTaskScheduler()); } // Ours runs on the job system, which is gone by now
 
 		return eMegaResult::SUCCESS;
 	};
@@ -58,75 +193,360 @@ namespace Mega
 	eMegaResult PhysicsSystem::OnUpdate(const tTimestep in_dt, Scene* in_pScene)
 	{
 		// Update Bullet 3D world //
-		m_pPhysicsWorld->stepSimulation(in_dt, 1, 0.033333f);
+		// Bullet takes seconds. It runs as many fixed steps as fit in the tick and keeps the remainder for the next,
+		// so the same ticks always give the same steps. Motion states are interpolated by that remainder
+		const btScalar dtSeconds = in_dt / 1000.0f;
+		m_slowestStepMicroseconds = 0;
+		m_pPhysicsWorld->stepSimulation(dtSeconds, m_maxSubsteps, m_fixedStep);
+		Telemetry::Set(g_slowestStepCounter, m_slowestStepMicroseconds);
+
+		// Connect entity's transform and rigid body, for the bodies that moved (their motion state has the
+		// interpolated transform). Bodies are in world space and written as the local transform, so body owners have
+		// to sit at the origin (true for anything owned directly by the root)
+		auto& registry = in_pScene->GetRegistry();
+		for (MotionState* pMotionState : m_pMovedStates)
+		{
+			pMotionState->m_isMoved = false;
+
+			// Destroyed bodies take their state off the list, so the entity is always valid
+			auto [t, r] = registry.get<Component::Transform, Component::RigidBody>(pMotionState->GetEntity());
 
-		// Connect entity's transform and rigid body
-		auto view2 = in_pScene->GetRegistry().view<Component::Transform, Component::RigidBody>();
-		for (const auto& [entity, t, r] : view2.each())
+			btTransform worldTransform;
+			pMotionState->getWorldTransform(worldTransform);
+
+			if (r.syncRot)
+			{
+				const btQuaternion rotation = worldTransform.getRotation();
+				t.SetOrientation(Quat(rotation.w(), rotation.x(), rotation.y(), rotation.z()));
+			}
+
+			const btVector3& origin = worldTransform.getOrigin();
+			t.SetPosition(Vec3(origin.x(), origin.y(), origin.z()) - r.localOffset);
+		}
+		SetTouchedCount((uint32_t)m_pMovedStates.size());
+		Telemetry::Set(g_movedBodyCounter, (int64_t)m_pMovedStates.size());
+		m_pMovedStates.clear();
+
+		// Contacts
+		GatherContactEvents();
+		DispatchContactEvents(in_pScene);
+
+		return eMegaResult::SUCCESS;
+	};
+
+	void PhysicsSystem::MotionState::setWorldTransform(const btTransform& in_transform)
+	{
+		if (in_transform == m_graphicsWorldTrans) { return; }
+
+		m_graphicsWorldTrans = in_transform;
+		if (!m_isMoved)
 		{
-			// TODO: skip in active / sleeping objects
-			if (r.syncRot) { t.SetRotation(r.GetMotionStateTransform()); }
-			t.SetPosition(r.GetMotionStatePosition() - r.localOffset);
+			m_isMoved = true;
+			m_pSystem->m_pMovedStates.push_back(this);
 		}
+	}
+
+	void PhysicsSystem::OnPreStep(btDynamicsWorld* in_pWorld, btScalar in_timeStep)
+	{
+		PhysicsSystem* pSystem = static_cast<PhysicsSystem*>(in_pWorld->getWorldUserInfo());
+		pSystem->m_isProfilingStep = MEGA_PROFILE_BEGIN("PhysicsSystem::Step");
+		pSystem->m_stepStartTime = Time<tNanosecond>();
+	}
+	void PhysicsSystem::OnPostStep(btDynamicsWorld* in_pWorld, btScalar in_timeStep)
+	{
+		PhysicsSystem* pSystem = static_cast<PhysicsSystem*>(in_pWorld->getWorldUserInfo());
+		const int64_t stepMicroseconds = std::chrono::duration_cast<tMicrosecond>(Time<tNanosecond>() - pSystem->m_stepStartTime).count();
+		MEGA_PROFILE_END(pSystem->m_isProfilingStep);
+
+		Telemetry::Add(g_stepCounter, 1);
+		Telemetry::Add(g_stepTimeCounter, stepMicroseconds);
+		pSystem->m_slowestStepMicroseconds = std::max(pSystem->m_slowestStepMicroseconds, stepMicroseconds);
+	}
 
-		// Handle collisions
-		int manifoldCount = m_pPhysicsWorld->getDispatcher()->getNumManifolds();
+	void PhysicsSystem::GatherContactEvents()
+	{
+		MEGA_PROFILE_SCOPE("PhysicsSystem::GatherContactEvents");
+
+		std::swap(m_lastContactPairs, m_contactPairs);
+		m_contactPairs.clear();
+
+		// Manifolds are kept for every pair whose bounds overlap, only the ones with points actually touch. They are
+		// the last step's, so a tick without a step sees the same contacts again
+		btDispatcher* pDispatcher = m_pPhysicsWorld->getDispatcher();
+		const int manifoldCount = pDispatcher->getNumManifolds();
+		Telemetry::Set(g_manifoldCounter, manifoldCount);
 		for (int i = 0; i < manifoldCount; i++)
 		{
-			btPersistentManifold* contactManifold = m_pPhysicsWorld->getDispatcher()->getManifoldByIndexInternal(i);
-			const btRigidBody* body0 = static_cast<const btRigidBody*>(contactManifold->getBody0());
-			const btRigidBody* body1 = static_cast<const btRigidBody*>(contactManifold->getBody1());
+			const btPersistentManifold* pManifold = pDispatcher->getManifoldByIndexInternal(i);
+			if (pManifold->getNumContacts() == 0) { continue; }
+
+			const btCollisionObject* pBody0 = pManifold->getBody0();
+			const btCollisionObject* pBody1 = pManifold->getBody1();
+			ContactPair pair;
+			pair.eventMasks[0] = (uint32_t)pBody0->getUserIndex3();
+			pair.eventMasks[1] = (uint32_t)pBody1->getUserIndex3();
+			if ((pair.eventMasks[0] | pair.eventMasks[1]) == CONTACT_EVENTS_NONE) { continue; }
+
+			pair.contact.entity = GetBodyEntity(pBody0);
+			pair.contact.other = GetBodyEntity(pBody1);
+			if (pair.contact.entity.IsNull() || pair.contact.other.IsNull()) { continue; }
+
+			int deepestIndex = 0;
+			for (int j = 0; j < pManifold->getNumContacts(); j++)
+			{
+				const btManifoldPoint& point = pManifold->getContactPoint(j);
+				pair.contact.impulse += point.getAppliedImpulse();
+				if (point.getDistance() < pManifold->getContactPoint(deepestIndex).getDistance()) { deepestIndex = j; }
+			}
+
+			// Bullet's normal is on body 1, pointing into body 0
+			const btManifoldPoint& deepest = pManifold->getContactPoint(deepestIndex);
+			const btVector3& position = deepest.getPositionWorldOnB();
+			const btVector3& normal = deepest.m_normalWorldOnB;
+			pair.contact.position = Vec3(position.x(), position.y(), position.z());
+			pair.contact.normal = Vec3(normal.x(), normal.y(), normal.z());
+
+			pair.keys[0] = PackHandle(pair.contact.entity);
+			pair.keys[1] = PackHandle(pair.contact.other);
+			if (pair.keys[1] < pair.keys[0])
+			{
+				std::swap(pair.keys[0], pair.keys[1]);
+				std::swap(pair.eventMasks[0], pair.eventMasks[1]);
+				std::swap(pair.contact.entity, pair.contact.other);
+				pair.contact.normal = -pair.contact.normal;
+			}
+			m_contactPairs.push_back(pair);
+		}
+		std::sort(m_contactPairs.begin(), m_contactPairs.end());
 
-			MEGA_ASSERT(body0->getUserPointer(), "User pointer is null");
-			MEGA_ASSERT(body1->getUserPointer(), "User pointer is null");
+		// Compound shapes can give a pair more than one manifold, those are merged into the first
+		if (!m_contactPairs.empty())
+		{
+			size_t pairCount = 1;
+			for (size_t i = 1; i < m_contactPairs.size(); i++)
+			{
+				ContactPair& lastPair = m_contactPairs[pairCount - 1];
+				if (m_contactPairs[i].IsSamePair(lastPair)) { lastPair.contact.impulse += m_contactPairs[i].contact.impulse; }
+				else { m_contactPairs[pairCount++] = m_contactPairs[i]; }
+			}
+			m_contactPairs.resize(pairCount);
+		}
 
-			// Pointer magic to get the entity involved in the collision
-			// https://www.youtube.com/watch?v=l2VemFmfkG4
-			Entity* e0 = static_cast<Entity*>(body0->getUserPointer());
-			Entity* e1 = static_cast<Entity*>(body1->getUserPointer());
+		// Both lists are sorted, a pair only in this tick's began and one only in the last's ended
+		for (std::vector<ContactPair>& events : m_contactEvents) { events.clear(); }
+		const auto addEvent = [this](const eContactEvent in_type, const ContactPair& in_pair)
+		{
+			if (((in_pair.eventMasks[0] | in_pair.eventMasks[1]) & ContactEventBit(in_type)) == 0) { return; }
+
+			ContactPair& event = m_contactEvents[(size_t)in_type].emplace_back(in_pair);
+			event.contact.type = in_type;
+			if (in_type == eContactEvent::End) { event.contact.impulse = 0.0f; }
+		};
+		size_t pairIndex = 0;
+		size_t lastPairIndex = 0;
+		while (pairIndex < m_contactPairs.size() || lastPairIndex < m_lastContactPairs.size())
+		{
+			if (lastPairIndex == m_lastContactPairs.size() || (pairIndex < m_contactPairs.size() && m_contactPairs[pairIndex] < m_lastContactPairs[lastPairIndex]))
+			{
+				addEvent(eContactEvent::Begin, m_contactPairs[pairIndex++]);
+			}
+			else if (pairIndex == m_contactPairs.size() || m_lastContactPairs[lastPairIndex] < m_contactPairs[pairIndex])
+			{
+				addEvent(eContactEvent::End, m_lastContactPairs[lastPairIndex++]);
+			}
+			else
+			{
+				addEvent(eContactEvent::Stay, m_contactPairs[pairIndex++]);
+				lastPairIndex++;
+			}
+		}
+	}
+
+	void PhysicsSystem::DispatchContactEvents(Scene* in_pScene)
+	{
+		MEGA_PROFILE_SCOPE("PhysicsSystem::DispatchContactEvents");
 
-			e0->OnCollision(e1, { contactManifold });
-			e1->OnCollision(e0, { contactManifold });
+		int64_t dispatchedCount = 0;
+		for (size_t type = 0; type < (size_t)eContactEvent::Count; type++)
+		{
+			const uint32_t eventBit = ContactEventBit((eContactEvent)type);
+			const bool isEnd = (eContactEvent)type == eContactEvent::End;
+			for (const ContactPair& pair : m_contactEvents[type])
+			{
+				// An entity deleted since resolves to null. Its partner is still told the contact ended, with no entity
+				Entity* pEntity = in_pScene->GetEntity(pair.contact.entity);
+				Entity* pOther = in_pScene->GetEntity(pair.contact.other);
+				if (!isEnd && (!pEntity || !pOther)) { continue; }
+
+				if (pEntity && (pair.eventMasks[0] & eventBit))
+				{
+					pEntity->OnContact(pOther, pair.contact);
+					dispatchedCount++;
+				}
+				if (pOther && (pair.eventMasks[1] & eventBit))
+				{
+					ContactEvent otherContact = pair.contact;
+					std::swap(otherContact.entity, otherContact.other);
+					otherContact.normal = -otherContact.normal;
+					pOther->OnContact(pEntity, otherContact);
+					dispatchedCount++;
+				}
+			}
 		}
+		Telemetry::Add(g_contactEventCounter, dispatchedCount);
+	}
 
-		return eMegaResult::SUCCESS;
-	};
+#ifndef MEGA_DISABLE_DEBUG_UI
+	void PhysicsSystem::BuildDebugPanel()
+	{
+		ImGui::Text("Fixed step: %.2f ms, up to %d per tick, %s", m_fixedStep * 1000.0f, m_maxSubsteps, m_isMultithreaded ? "multithreaded" : "single threaded");
+
+		// Last frame's
+		const int64_t stepCount = Telemetry::GetValue(g_stepCounter);
+		const int64_t stepMicroseconds = Telemetry::GetValue(g_stepTimeCounter);
+		ImGui::Text("Steps: %lld, %.3f ms each on average, slowest %.3f ms", (long long)stepCount,
+			stepCount > 0 ? stepMicroseconds / 1000.0 / stepCount : 0.0, Telemetry::GetValue(g_slowestStepCounter) / 1000.0);
+		ImGui::Text("Contact events: %zu begun, %zu staying, %zu ended", m_contactEvents[(size_t)eContactEvent::Begin].size(),
+			m_contactEvents[(size_t)eContactEvent::Stay].size(), m_contactEvents[(size_t)eContactEvent::End].size());
+	}
+#endif
 
-	Mega::Vec3 PhysicsSystem::PerformRayTestPosition(const Vec3& in_from, const Vec3& in_to) const
+	void PhysicsSystem::PerformQueries(const RayQuery* in_pQueries, RayHit* out_pHits, const uint32_t in_count) const
 	{
-		if (length(in_from + in_to) <= 0) { return { 0, 0, 0 }; }
+		MEGA_PROFILE_SCOPE("PhysicsSystem::PerformQueries");
+
+		const auto performRange = [&](const uint32_t in_begin, const uint32_t in_end)
+		{
+			for (uint32_t i = in_begin; i < in_end; i++) { out_pHits[i] = PerformQuery(in_pQueries[i]); }
+		};
+
+#if BT_THREADSAFE
+		if (in_count > PHYSICS_QUERY_GRAIN_SIZE)
+		{
+			Engine::ParallelFor(0, in_count, PHYSICS_QUERY_GRAIN_SIZE, performRange);
+			return;
+		}
+#endif
+		performRange(0, in_count);
+	}
+
+	RayHit PhysicsSystem::PerformQuery(const RayQuery& in_query) const
+	{
+		Telemetry::Add(g_queryCounter, 1);
+
+		const btVector3 from = { in_query.from.x, in_query.from.y, in_query.from.z };
+		const btVector3 to = { in_query.to.x, in_query.to.y, in_query.to.z };
+
+		RayHit out_hit;
+		const btCollisionObject* pHitObject = nullptr;
+		if (in_query.radius > 0)
+		{
+			btCollisionWorld::ClosestConvexResultCallback results(from, to);
+			results.m_collisionFilterMask = in_query.mask;
+
+			const btSphereShape sphere(in_query.radius);
+			m_pPhysicsWorld->convexSweepTest(&sphere, btTransform(btQuaternion::getIdentity(), from), btTransform(btQuaternion::getIdentity(), to), results);
+			if (!results.hasHit()) { return out_hit; }
+
+			out_hit.position = Vec3(results.m_hitPointWorld.x(), results.m_hitPointWorld.y(), results.m_hitPointWorld.z());
+			out_hit.normal = Vec3(results.m_hitNormalWorld.x(), results.m_hitNormalWorld.y(), results.m_hitNormalWorld.z());
+			out_hit.fraction = results.m_closestHitFraction;
+			pHitObject = results.m_hitCollisionObject;
+		}
+		else
+		{
+			btCollisionWorld::ClosestRayResultCallback results(from, to);
+			results.m_collisionFilterMask = in_query.mask;
+			if (in_query.isFilteringBackfaces) { results.m_flags |= btTriangleRaycastCallback::kF_FilterBackfaces; }
 
-		btCollisionWorld::ClosestRayResultCallback closestResults({ in_from.x, in_from.y, in_from.z }, { in_to.x, in_to.y, in_to.z });
-		closestResults.m_flags |= btTriangleRaycastCallback::kF_FilterBackfaces;
+			m_pPhysicsWorld->rayTest(from, to, results);
+			if (!results.hasHit()) { return out_hit; }
 
-		m_pPhysicsWorld->rayTest({ in_from.x, in_from.y, in_from.z }, { in_to.x, in_to.y, in_to.z }, closestResults);
+			out_hit.position = Vec3(results.m_hitPointWorld.x(), results.m_hitPointWorld.y(), results.m_hitPointWorld.z());
+			out_hit.normal = Vec3(results.m_hitNormalWorld.x(), results.m_hitNormalWorld.y(), results.m_hitNormalWorld.z());
+			out_hit.fraction = results.m_closestHitFraction;
+			pHitObject = results.m_collisionObject;
+		}
 
-		// For now just two seperate functions
-		return { closestResults.m_hitPointWorld.x(), closestResults.m_hitPointWorld.y(), closestResults.m_hitPointWorld.z() };
+		// Bodies carry their entity's handle (see Entity::Initialize), the rest keep Bullet's default of -1 (null)
+		out_hit.hasHit = true;
+		out_hit.entity = { (uint32_t)pHitObject->getUserIndex(), (uint32_t)pHitObject->getUserIndex2() };
+		return out_hit;
 	}
 
+	Mega::Vec3 PhysicsSystem::PerformRayTestPosition(const Vec3& in_from, const Vec3& in_to) const
+	{
+		return PerformQuery({ in_from, in_to }).position;
+	}
 	Mega::Vec3 PhysicsSystem::PerformRayTestNormal(const Vec3& in_from, const Vec3& in_to) const
 	{
-		if (length(in_from + in_to) <= 0) { return { 0, 0, 0 }; }
+		return PerformQuery({ in_from, in_to }).normal;
+	}
+	bool PhysicsSystem::PerformRayTestCollision(const Vec3& in_from, const Vec3& in_to) const
+	{
+		return PerformQuery({ in_from, in_to }).hasHit;
+	}
 
-		btCollisionWorld::ClosestRayResultCallback closestResults({ in_from.x, in_from.y, in_from.z }, { in_to.x, in_to.y, in_to.z });
-		closestResults.m_flags |= btTriangleRaycastCallback::kF_FilterBackfaces;
+	void PhysicsSystem::AddInitializedRigidBody(btRigidBody* in_pBody)
+	{
+		if (m_isBatchingBodies)
+		{
+			m_pBatchedBodies.push_back(in_pBody);
+			return;
+		}
 
-		m_pPhysicsWorld->rayTest({ in_from.x, in_from.y, in_from.z }, { in_to.x, in_to.y, in_to.z }, closestResults);
+		m_pPhysicsWorld->addRigidBody(in_pBody);
+	}
+	void PhysicsSystem::RemoveRigidBody(btRigidBody* in_pBody)
+	{
+		// Destroyed before its batch was added to the world
+		if (m_isBatchingBodies)
+		{
+			auto it = std::find(m_pBatchedBodies.begin(), m_pBatchedBodies.end(), in_pBody);
+			if (it != m_pBatchedBodies.end())
+			{
+				m_pBatchedBodies.erase(it);
+				return;
+			}
+		}
 
-		// For now just returning the normal
-		return { closestResults.m_hitNormalWorld.x(), closestResults.m_hitNormalWorld.y(), closestResults.m_hitNormalWorld.z() };
+		m_pPhysicsWorld->removeRigidBody(in_pBody);
 	}
 
-	bool PhysicsSystem::PerformRayTestCollision(const Vec3& in_from, const Vec3& in_to) const
+	void PhysicsSystem::BeginBodyBatch()
+	{
+		MEGA_ASSERT(!m_isBatchingBodies, "Rigid body batches can not be nested");
+		m_isBatchingBodies = true;
+	}
+	void PhysicsSystem::EndBodyBatch()
 	{
-		btCollisionWorld::ClosestRayResultCallback closestResults({ in_from.x, in_from.y, in_from.z }, { in_to.x, in_to.y, in_to.z });
-		closestResults.m_flags |= btTriangleRaycastCallback::kF_FilterBackfaces;
+		MEGA_ASSERT(m_isBatchingBodies, "Ending a rigid body batch that was never begun");
+		m_isBatchingBodies = false;
+
+		if (m_pBatchedBodies.empty()) { return; }
+		for (btRigidBody* pBody : m_pBatchedBodies)
+		{
+			m_pPhysicsWorld->addRigidBody(pBody);
+		}
+		m_pBatchedBodies.clear();
+
+		// Inserting one by one leaves the tree in whatever shape the insert order gave it
+		static_cast<btDbvtBroadphase*>(m_overlappingPairCache)->optimize();
+	}
+
+	void PhysicsSystem::ReleaseShape(btCollisionShape* in_pShape)
+	{
+		std::lock_guard<std::mutex> lock(m_sharedShapeMutex);
+
+		auto keyIt = m_sharedShapeKeys.find(in_pShape);
+		MEGA_ASSERT(keyIt != m_sharedShapeKeys.end(), "Releasing a collision shape that is not shared");
 
-		m_pPhysicsWorld->rayTest({ in_from.x, in_from.y, in_from.z }, { in_to.x, in_to.y, in_to.z }, closestResults);
+		auto shapeIt = m_sharedShapes.find(keyIt->second);
+		if (--shapeIt->second.refCount > 0) { return; }
 
-		// For now just returning the normal
-		return closestResults.hasHit();
+		delete in_pShape;
+		m_sharedShapes.erase(shapeIt);
+		m_sharedShapeKeys.erase(keyIt);
 	}
 
 	// ----------------------- ECS Component Callbacks --------------------------- //
@@ -161,7 +581,7 @@ namespace Mega
 		btQuaternion quat;
 		quat.setEulerZYX(r.x, r.y, r.z);
 		btTransform transform = btTransform(quat, btVector3(t.x, t.y, t.z));
-		bodyComponent.pMotionState = new btDefaultMotionState(transform);
+		bodyComponent.pMotionState = new MotionState(this, in_entityID, transform);
 
 		// Create Bullet3D body
 		btVector3 inertia = btVector3(0.5f, 0.5f, 0.5f);
@@ -174,19 +594,59 @@ namespace Mega
 
 		bodyComponent.pPhysicsBody = new btRigidBody(rigidBodyInfo);
 		bodyComponent.pPhysicsBody->setCollisionFlags(bodyComponent.pPhysicsBody->getCollisionFlags() | btCollisionObject::CollisionFlags::CF_CUSTOM_MATERIAL_CALLBACK);
-		bodyComponent.pPhysicsBody->setActivationState(DISABLE_DEACTIVATION);
-		AddInitializedRigidBody(bodyComponent.pPhysicsBody);
+		bodyComponent.pPhysicsBody->setUserIndex3((int)bodyComponent.contactEvents); // Bullet's default (-1) would ask for every event
+
+		if (in_registry.all_of<Component::Disabled>(in_entityID)) { return; } // Joins when the entity is enabled
+		AddSceneBody(in_registry, bodyComponent.pPhysicsBody);
 	};
 	void PhysicsSystem::OnDestroyRigidBodyComponent(entt::registry& in_registry, entt::entity in_entityID)
 	{
 		Component::RigidBody& bodyComponent = in_registry.get<Component::RigidBody>(in_entityID);
 
-		RemoveRigidBody(bodyComponent.pPhysicsBody);
+		if (!in_registry.all_of<Component::Disabled>(in_entityID)) { RemoveSceneBody(in_registry, bodyComponent.pPhysicsBody); }
 
+		if (bodyComponent.pMotionState->m_isMoved)
+		{
+			m_pMovedStates.erase(std::find(m_pMovedStates.begin(), m_pMovedStates.end(), bodyComponent.pMotionState));
+		}
 		delete bodyComponent.pMotionState;
 		delete bodyComponent.pPhysicsBody;
 	};
 
+	// ============ Disabled ============ //
+	void PhysicsSystem::OnConstructDisabledComponent(entt::registry& in_registry, entt::entity in_entityID)
+	{
+		if (Component::RigidBody* pBody = in_registry.try_get<Component::RigidBody>(in_entityID)) { RemoveSceneBody(in_registry, pBody->pPhysicsBody); }
+	}
+	void PhysicsSystem::OnDestroyDisabledComponent(entt::registry& in_registry, entt::entity in_entityID)
+	{
+		if (Component::RigidBody* pBody = in_registry.try_get<Component::RigidBody>(in_entityID)) { AddSceneBody(in_registry, pBody->pPhysicsBody); }
+	}
+
+	void PhysicsSystem::AddSceneBody(const entt::registry& in_registry, btRigidBody* in_pBody)
+	{
+		// Not in the active scene (it is being loaded), joins the world when its scene is activated
+		if (&in_registry != m_pActiveRegistry)
+		{
+			std::lock_guard<std::mutex> lock(m_loadingBodiesMutex);
+			m_pLoadingBodies.push_back(in_pBody);
+			return;
+		}
+
+		AddInitializedRigidBody(in_pBody);
+	}
+	void PhysicsSystem::RemoveSceneBody(const entt::registry& in_registry, btRigidBody* in_pBody)
+	{
+		if (&in_registry != m_pActiveRegistry)
+		{
+			std::lock_guard<std::mutex> lock(m_loadingBodiesMutex);
+			m_pLoadingBodies.erase(std::remove(m_pLoadingBodies.begin(), m_pLoadingBodies.end(), in_pBody), m_pLoadingBodies.end());
+			return;
+		}
+
+		RemoveRigidBody(in_pBody);
+	}
+
 	// ======== Collision Box ============ //
 	void PhysicsSystem::OnConstructCollisionBoxComponent(entt::registry& in_registry, entt::entity in_entityID)
 	{
@@ -196,16 +656,19 @@ namespace Mega
 		Component::CollisionBox& boxComponent = in_registry.get<Component::CollisionBox>(in_entityID);
 		btVector3 halfDim = btVector3(boxComponent.dimensions.x / 2.0f, boxComponent.dimensions.y / 2.0f, boxComponent.dimensions.z / 2.0f);
 
-		boxComponent.pBox = new btBoxShape(halfDim);
-		boxComponent.pBox->setImplicitShapeDimensions(halfDim);
-
-		btTransform  localTransform;
+		const ShapeKey key = { eShapeType::Box, { halfDim.x(), halfDim.y(), halfDim.z() } };
+		boxComponent.pBox = static_cast<btBoxShape*>(AcquireShape(key, [&halfDim]()
+		{
+			btBoxShape* pBox = new btBoxShape(halfDim);
+			pBox->setImplicitShapeDimensions(halfDim);
+			return pBox;
+		}));
 	};
 	void PhysicsSystem::OnDestroyCollisionBoxComponent(entt::registry& in_registry, entt::entity in_entityID)
 	{
 		Component::CollisionBox& boxComponent = in_registry.get<Component::CollisionBox>(in_entityID);
 
-		delete boxComponent.pBox;
+		ReleaseShape(boxComponent.pBox);
 	};
 
 	// ================ Collision Triangle Mesh ============== //
@@ -273,17 +736,20 @@ namespace Mega
 		Component::CollisionSphere& sphereComponent = in_registry.get<Component::CollisionSphere>(in_entityID);
 		float rad = sphereComponent.radius;
 
-		sphereComponent.pSphere = new btSphereShape(rad);
-		sphereComponent.pSphere->setImplicitShapeDimensions(btVector3(rad, rad, rad));
-
-		btTransform  localTransform;
+		const ShapeKey key = { eShapeType::Sphere, { rad, 0, 0 } };
+		sphereComponent.pSphere = static_cast<btSphereShape*>(AcquireShape(key, [rad]()
+		{
+			btSphereShape* pSphere = new btSphereShape(rad);
+			pSphere->setImplicitShapeDimensions(btVector3(rad, rad, rad));
+			return pSphere;
+		}));
 	};
 
 	void PhysicsSystem::OnDestroyCollisionSphereComponent(entt::registry& in_registry, entt::entity in_entityID)
 	{
 		Component::CollisionSphere& sphereComponent = in_registry.get<Component::CollisionSphere>(in_entityID);
 
-		delete sphereComponent.pSphere;
+		ReleaseShape(sphereComponent.pSphere);
 	};
 
 	// ---------------- Collision Capsule ------------------- //
@@ -293,16 +759,18 @@ namespace Mega
 
 		Component::CollisionCapsule& capsule = in_registry.get<Component::CollisionCapsule>(in_entityID);
 
-		capsule.pCapsule = new btCapsuleShape(capsule.radius, capsule.height / static_cast<tScalar>(2.0));
-
-		btTransform  localTransform;
+		const ShapeKey key = { eShapeType::Capsule, { capsule.radius, capsule.height, 0 } };
+		capsule.pCapsule = static_cast<btCapsuleShape*>(AcquireShape(key, [&capsule]()
+		{
+			return new btCapsuleShape(capsule.radius, capsule.height / static_cast<tScalar>(2.0));
+		}));
 	};
 
 	void PhysicsSystem::OnDestroyCollisionCapsuleComponent(entt::registry& in_registry, entt::entity in_entityID)
 	{
 		Component::CollisionCapsule& capsule = in_registry.get<Component::CollisionCapsule>(in_entityID);
 
-		delete capsule.pCapsule;
+		ReleaseShape(capsule.pCapsule);
 	};
 
 
@@ -1,11 +1,16 @@
 #pragma once
 
+#include <mutex>
+#include <vector>
+#include <unordered_map>
 #include <Bullet3D/btBulletCollisionCommon.h>
 #include <Bullet3D/btBulletDynamicsCommon.h>
 #include <Bullet3D/BulletCollision/CollisionShapes/btHeightfieldTerrainShape.h>
+#include <Bullet3D/BulletDynamics/Dynamics/btDiscreteDynamicsWorldMt.h>
 
 #include "Engine/ECS/System.h"
 #include "Engine/Physics/RayTest.h"
+#include "Engine/Physics/ContactEvent.h"
 
 // Forward Declarations
 namespace Mega
@@ -33,19 +38,91 @@ namespace Mega
 		eMegaResult OnInitialize() override;
 		eMegaResult OnDestroy() override;
 		eMegaResult OnUpdate(const tTimestep in_dt, Scene* in_pScene) override;
+		const char* GetName() const override { return "PhysicsSystem"; }
 
 		// ------- Public Helpers ------- //
+		// Casts every query against the world and writes its closest hit to the same index of out_pHits. Batches
+		// bigger than a grain are spread over the job system when Bullet is built thread safe (BT_THREADSAFE), its
+		// broadphase shares one traversal stack between threads otherwise. Only reads the world, so queries can run
+		// from any system but not while the world is stepped
+		void PerformQueries(const RayQuery* in_pQueries, RayHit* out_pHits, const uint32_t in_count) const;
+		RayHit PerformQuery(const RayQuery& in_query) const;
+
+		// Single ray shorthands, a query gives all three at once
 		Mega::Vec3 PerformRayTestPosition(const Vec3& in_from, const Vec3& in_to) const;
 		Mega::Vec3 PerformRayTestNormal(const Vec3& in_from, const Vec3& in_to) const;
 		bool PerformRayTestCollision(const Vec3& in_from, const Vec3& in_to) const;
 
-		inline void AddInitializedRigidBody(btRigidBody* in_pBody) { m_pPhysicsWorld->addRigidBody(in_pBody); }
-		inline void RemoveRigidBody(btRigidBody* in_pBody) { m_pPhysicsWorld->removeRigidBody(in_pBody); }
+		void AddInitializedRigidBody(btRigidBody* in_pBody);
+		void RemoveRigidBody(btRigidBody* in_pBody);
+
+		// Bodies created between these are added to the world together at the end, then the broadphase tree is
+		// rebuilt once instead of being rebalanced a little on every insert. Used for bulk spawns (Engine::Instantiate)
+		void BeginBodyBatch();
+		void EndBodyBatch();
+
+		// Physics components of a connected scene get their Bullet objects as they are added. Only the active scene's
+		// bodies are in the world, a scene being loaded in the background holds its bodies back until it is activated
+		// (they are added as one batch). The previous scene has to be destroyed before the next one is activated
+		void ConnectScene(Scene* in_pScene);
+		void ActivateScene(Scene* in_pScene);
+
+		// Bullet only writes the transforms of awake bodies. This one also puts its body on the system's moved list when
+		// the transform written is not the one it already had, so the transform sync after a step only visits bodies
+		// that actually moved and resting or sleeping bodies cost nothing. Motion states are written by the stepping
+		// thread, in the multithreaded world too
+		class MotionState final : public btDefaultMotionState
+		{
+		public:
+			MotionState(PhysicsSystem* in_pSystem, const entt::entity in_entity, const btTransform& in_transform)
+				: btDefaultMotionState(in_transform), m_pSystem(in_pSystem), m_entity(in_entity) {};
+
+			void setWorldTransform(const btTransform& in_transform) override;
+
+			inline entt::entity GetEntity() const { return m_entity; }
+
+		private:
+			friend PhysicsSystem;
+
+			PhysicsSystem* m_pSystem = nullptr;
+			entt::entity m_entity = entt::null;
+			bool m_isMoved = false; // Already on the moved list
+		};
 
 		// ---------- Getters ---------- //
 		constexpr inline tScalar GetGravity() const { return m_globalGravity; }
+		inline btScalar GetFixedStep() const { return m_fixedStep; } // In seconds, like Bullet
+		inline bool IsMultithreaded() const { return m_isMultithreaded; }
 
 	private:
+#ifndef MEGA_DISABLE_DEBUG_UI
+		void BuildDebugPanel();
+#endif
+
+		// Bullet's internal tick callbacks, run around every fixed step to time it
+		static void OnPreStep(btDynamicsWorld* in_pWorld, btScalar in_timeStep);
+		static void OnPostStep(btDynamicsWorld* in_pWorld, btScalar in_timeStep);
+
+		// ---------------- Contact Events ------------------ //
+		// A touching pair, ordered by its packed entity handles so a tick's pairs can be diffed against the last's
+		// with one walk over both sorted lists. The event in it is the first entity's
+		struct ContactPair
+		{
+			uint64_t keys[2] = { 0, 0 }; // contact.entity's and contact.other's handles, packed
+			uint32_t eventMasks[2] = { CONTACT_EVENTS_NONE, CONTACT_EVENTS_NONE }; // What each of them asked for
+			ContactEvent contact;
+
+			bool operator<(const ContactPair& in_other) const { return keys[0] != in_other.keys[0] ? keys[0] < in_other.keys[0] : keys[1] < in_other.keys[1]; }
+			bool IsSamePair(const ContactPair& in_other) const { return keys[0] == in_other.keys[0] && keys[1] == in_other.keys[1]; }
+		};
+
+		// Collects the pairs touching after the step that either entity wants events for, and sorts the differences to
+		// the last tick's pairs into the begin/stay/end lists
+		void GatherContactEvents();
+		// Hands every event to the entities that asked for its type, after the step so callbacks never see a half
+		// stepped world
+		void DispatchContactEvents(Scene* in_pScene);
+
 		// --------------- ECS Component Callbacks ------------------ //
 		void OnConstructRigidBodyComponent(entt::registry& in_registry, entt::entity in_entityID);
 		void OnDestroyRigidBodyComponent(entt::registry& in_registry, entt::entity in_entityID);
@@ -59,6 +136,84 @@ namespace Mega
 		void OnDestroyCollisionCapsuleComponent(entt::registry& in_registry, entt::entity in_entityID);
 		void OnConstructCollisionTriangleMeshComponent(entt::registry& in_registry, entt::entity in_entityID);
 		void OnDestroyCollisionTriangleMeshComponent(entt::registry& in_registry, entt::entity in_entityID);
+		void OnConstructDisabledComponent(entt::registry& in_registry, entt::entity in_entityID);
+		void OnDestroyDisabledComponent(entt::registry& in_registry, entt::entity in_entityID);
+
+		// Into the world, or held back if the registry is not the active scene's
+		void AddSceneBody(const entt::registry& in_registry, btRigidBody* in_pBody);
+		void RemoveSceneBody(const entt::registry& in_registry, btRigidBody* in_pBody);
+
+		// ---------------- Shared Shapes ------------------ //
+		// Box, sphere and capsule colliders with the same dimensions share one Bullet shape, so spawning many of the
+		// same object does not allocate a shape each. Shapes are freed when the last collider using them is destroyed
+		enum class eShapeType : int32_t
+		{
+			Box = 0,
+			Sphere,
+			Capsule,
+		};
+		struct ShapeKey
+		{
+			eShapeType type = eShapeType::Box;
+			tScalar dimensions[3] = { 0, 0, 0 };
+
+			bool operator==(const ShapeKey& in_other) const
+			{
+				return type == in_other.type && dimensions[0] == in_other.dimensions[0] && dimensions[1] == in_other.dimensions[1] && dimensions[2] == in_other.dimensions[2];
+			}
+		};
+		struct ShapeKeyHash
+		{
+			size_t operator()(const ShapeKey& in_key) const
+			{
+				size_t hash = std::hash<int32_t>()((int32_t)in_key.type);
+				for (const tScalar dimension : in_key.dimensions) { hash = hash * 31 + std::hash<tScalar>()(dimension); }
+				return hash;
+			}
+		};
+		struct SharedShape
+		{
+			btCollisionShape* pShape = nullptr;
+			uint32_t refCount = 0;
+		};
+
+		template<typename tCreateShape>
+		btCollisionShape* AcquireShape(const ShapeKey& in_key, const tCreateShape& in_createShape)
+		{
+			std::lock_guard<std::mutex> lock(m_sharedShapeMutex); // Colliders are also created by the scene loading thread
+			SharedShape& shared = m_sharedShapes[in_key];
+			if (!shared.pShape)
+			{
+				shared.pShape = in_createShape();
+				m_sharedShapeKeys[shared.pShape] = in_key;
+			}
+
+			shared.refCount++;
+			return shared.pShape;
+		}
+		void ReleaseShape(btCollisionShape* in_pShape);
+
+		std::unordered_map<ShapeKey, SharedShape, ShapeKeyHash> m_sharedShapes;
+		std::unordered_map<const btCollisionShape*, ShapeKey> m_sharedShapeKeys; // To find a shape's entry when releasing it
+		std::mutex m_sharedShapeMutex;
+
+		// Bodies waiting for EndBodyBatch
+		std::vector<btRigidBody*> m_pBatchedBodies;
+		bool m_isBatchingBodies = false;
+
+		// Bodies whose transform changed in the last step, synced and cleared by OnUpdate
+		std::vector<MotionState*> m_pMovedStates;
+
+		// Touching pairs of this tick and the last, and the events found between them (indexed by eContactEvent).
+		// Kept between ticks so their memory is reused
+		std::vector<ContactPair> m_contactPairs;
+		std::vector<ContactPair> m_lastContactPairs;
+		std::vector<ContactPair> m_contactEvents[(size_t)eContactEvent::Count];
+
+		// Bodies of the scene being loaded, waiting for ActivateScene
+		const entt::registry* m_pActiveRegistry = nullptr;
+		std::vector<btRigidBody*> m_pLoadingBodies;
+		std::mutex m_loadingBodiesMutex;
 
 		// --------- Member Variables ----------- //
 		btDiscreteDynamicsWorld* m_pPhysicsWorld = nullptr;
@@ -67,14 +222,16 @@ namespace Mega
 		btCollisionDispatcher* m_dispatcher = nullptr;
 		btBroadphaseInterface* m_overlappingPairCache = nullptr;
 		btSequentialImpulseConstraintSolver* m_solver = nullptr;
+		btConstraintSolverPoolMt* m_pSolverPool = nullptr; // Multithreaded world only, solves islands in parallel
+		bool m_isMultithreaded = false;
 
 		tScalar m_globalGravity = -9.8f;
-	};
-
-	struct CollisionData
-	{
-		CollisionData(btPersistentManifold* in_pManifold) { pManifold = in_pManifold; }
 
-		btPersistentManifold* pManifold = nullptr;
+		// Fixed stepping, see EngineSettings::physicsStepRate
+		btScalar m_fixedStep = 1.0f / 60.0f;
+		int m_maxSubsteps = 4;
+		tNanosecond m_stepStartTime{};
+		bool m_isProfilingStep = false; // The step's zone was begun, see MEGA_PROFILE_BEGIN
+		int64_t m_slowestStepMicroseconds = 0; // In the current tick
 	};
 }
\ No newline at end of file
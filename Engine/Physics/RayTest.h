@@ -1,20 +1,35 @@
 #pragma once
 
-//namespace Mega
-//{
-//	class RayTest
-//	{
-//	public:
-//		RayTest(const Vec3& in_from, const Vec3& in_to)
-//			: m_to()
-//
-//
-//	private:
-//		Vec3 m_to = { 0, 0, 0 };
-//		Vec3 m_from = { 0, 0, 0 };
-//		
-//		bool m_hasCollided = false;
-//		bool m_stopOnFirstCollision = true;
-//	};
-//
-//} // namespace Mega
\ No newline at end of file
+#include <cstdint>
+
+#include "Engine/Core/Math/Math.h"
+#include "Engine/ECS/EntityHandle.h"
+
+// Queries a batch is split into per job when it is spread over the job system
+#define PHYSICS_QUERY_GRAIN_SIZE 16
+
+// Bodies are in every collision group (Bullet's default filter), a query with this mask can hit any of them
+#define PHYSICS_QUERY_MASK_ALL (-1)
+
+namespace Mega
+{
+	// A ray from "from" to "to", or a sphere swept along it when radius is above 0
+	struct RayQuery
+	{
+		Vec3 from = { 0, 0, 0 };
+		Vec3 to = { 0, 0, 0 };
+		float radius = 0.0f;
+		int32_t mask = PHYSICS_QUERY_MASK_ALL; // Collision groups the query can hit (btBroadphaseProxy::CollisionFilterGroups)
+		bool isFilteringBackfaces = true; // Rays only, triangle meshes are not hit from behind
+	};
+
+	// The closest hit of a query, everything a caller could want from it so one query is enough
+	struct RayHit
+	{
+		bool hasHit = false;
+		Vec3 position = { 0, 0, 0 };
+		Vec3 normal = { 0, 0, 0 };
+		float fraction = 1.0f; // How far along from -> to the hit is, 1 without a hit
+		EntityHandle entity{}; // Owner of the body hit, null for bodies without one (see Scene::GetEntity)
+	};
+} // namespace Mega
\ No newline at end of file
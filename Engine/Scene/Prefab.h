@@ -0,0 +1,91 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <utility>
+#include <type_traits>
+#include <entt/entt.hpp>
+
+#include "Engine/Core/Core.h"
+#include "Engine/ECS/Entity.h"
+#include "Engine/ECS/Components.h"
+
+// Forward declarations
+namespace Mega
+{
+	class Scene;
+}
+
+namespace Mega
+{
+	// The components a group of identical entities start with, instantiated in bulk by Engine::Instantiate. Every
+	// instance gets a copy of each component, so anything expensive they point at (meshes from LoadOBJ, collision
+	// shapes) is shared instead of created per entity
+	class Prefab final
+	{
+	public:
+		friend Scene;
+
+		// Where one instance starts, relative to the owner it is instantiated under
+		struct Instance
+		{
+			Vec3 position = Vec3(0, 0, 0);
+			Vec3 rotation = Vec3(0, 0, 0);
+			Vec3 scale = Vec3(1, 1, 1);
+		};
+
+		Prefab() = default;
+
+		// Components are added to instances in the order they were added here, so physics still needs its
+		// collision shape before its rigid body
+		template<typename tComponent, class... Args>
+		Prefab& Add(Args&&... in_args)
+		{
+			MEGA_STATIC_ASSERT(std::is_base_of<Mega::Component::ComponentBase, tComponent>::value == true, "Structs added to prefabs must be derived from Mega::Component!");
+			MEGA_STATIC_ASSERT(!std::is_same<Mega::Component::Transform, tComponent>::value, "Instances get their transform from Prefab::Instance");
+
+			m_pComponents.push_back(std::make_unique<PrefabComponent<tComponent>>(std::forward<Args>(in_args)...));
+			return *this;
+		}
+
+	private:
+		class PrefabComponentBase
+		{
+		public:
+			virtual ~PrefabComponentBase() = default;
+
+			virtual void Reserve(entt::registry& in_registry, const size_t in_count) const = 0;
+			virtual void Insert(entt::registry& in_registry, const entt::entity* in_pBegin, const entt::entity* in_pEnd) const = 0;
+		};
+
+		template<typename tComponent>
+		class PrefabComponent final : public PrefabComponentBase
+		{
+		public:
+			template<class... Args>
+			PrefabComponent(Args&&... in_args)
+				: component(std::forward<Args>(in_args)...) {}
+
+			void Reserve(entt::registry& in_registry, const size_t in_count) const override
+			{
+				auto& storage = in_registry.storage<tComponent>();
+				storage.reserve(storage.size() + in_count);
+			}
+			void Insert(entt::registry& in_registry, const entt::entity* in_pBegin, const entt::entity* in_pEnd) const override
+			{
+				in_registry.insert<tComponent>(in_pBegin, in_pEnd, component);
+			}
+
+			tComponent component;
+		};
+
+		std::vector<std::unique_ptr<PrefabComponentBase>> m_pComponents;
+	};
+
+	// Plain entity for prefab instances, it has no update of its own so the scene never ticks it
+	class PrefabEntity final : public Entity
+	{
+	public:
+		PrefabEntity() = default;
+	};
+} // namespace Mega
\ No newline at end of file
@@ -7,10 +7,18 @@
 
 namespace Mega
 {
-	eMegaResult Scene::Initialize()
+	eMegaResult Scene::Initialize(const uint32_t in_threadCount)
 	{
 		// ENTT
 		entt::entity entity = m_registry.create();
+		m_registry.on_construct<Component::Transform>().connect<&Scene::OnConstructTransform>(this);
+		m_registry.on_destroy<Component::Transform>().connect<&Scene::OnDestroyTransform>(this);
+
+		m_pCommandBuffers.resize(in_threadCount);
+		for (std::unique_ptr<CommandBuffer>& pBuffer : m_pCommandBuffers)
+		{
+			pBuffer = std::make_unique<CommandBuffer>();
+		}
 
 		return eMegaResult::SUCCESS;
 	}
@@ -23,70 +31,258 @@ namespace Mega
 		}
 		
 		DeleteAllDestroyed();
-		delete m_pRootEntity; // Root entity not part of the entity list
+		if (m_pRootEntity != nullptr)
+		{
+			ReleaseHandle(m_pRootEntity->GetHandle());
+			delete m_pRootEntity; // Root entity not part of the entity list
+			m_pRootEntity = nullptr;
+		}
+
+		for (std::unique_ptr<CommandBuffer>& pBuffer : m_pCommandBuffers)
+		{
+			pBuffer->Clear();
+		}
 
 		m_registry.clear();
-		m_pEntities.clear();
+		ClearComponentChanges(); // Clearing the registry records every tracked component as removed
+		m_entityLists.clear();
+		m_pEntityListsByType.clear();
+		m_pUpdateLists.clear();
+		m_pUpdatePostLists.clear();
+		m_transformHierarchy.clear();
+		m_dirtyTransforms.clear();
+		m_changedTransforms.clear();
+		m_entitySlots.clear();
+		m_firstFreeSlot = UINT32_MAX;
 
 		return eMegaResult::SUCCESS;
 	}
 
 	eMegaResult Scene::Update(const tTimestep in_dt)
 	{
-		// Update all entities so long as they are marked active
+		MEGA_PROFILE_SCOPE("Scene::Update");
+
+		m_lastFrameAllocationCount = m_frameAllocationCount;
+		m_frameAllocationCount = 0;
+
+		// Update all entities so long as they are marked active, one type at a time
 		if (m_pRootEntity) { m_pRootEntity->Update(in_dt); }
-		for (std::vector<Entity*>& sublist : m_pEntities) // TODO use one list not sublists
+		for (size_t i = 0; i < m_pUpdateLists.size(); i++) // Indexed, updates can add lists for new types
 		{
-			for (Entity* pEntity : sublist)
-			{
-				if (pEntity->IsActive()) { pEntity->Update(in_dt); }
-			}
+			m_pUpdateLists[i]->Update(in_dt);
 		}
 
 		return eMegaResult::SUCCESS;
 	}
 	eMegaResult Scene::UpdatePost(const tTimestep in_dt)
 	{
+		MEGA_PROFILE_SCOPE("Scene::UpdatePost");
+
 		if (m_pRootEntity) { m_pRootEntity->UpdatePost(in_dt); }
-		for (std::vector<Entity*>& sublist : m_pEntities)
+		for (size_t i = 0; i < m_pUpdatePostLists.size(); i++) // Indexed, updates can add lists for new types
 		{
-			for (Entity* pEntity : sublist)
-			{
-				if (pEntity->IsActive()) { pEntity->UpdatePost(in_dt); }
-			}
+			m_pUpdatePostLists[i]->UpdatePost(in_dt);
 		}
 
 		// Remove all entities that have been marked destroyed
+		MEGA_PROFILE_SCOPE("Scene::DeleteAllDestroyed");
 		DeleteAllDestroyed();
 
 		return eMegaResult::SUCCESS;
 	}
 
+	void Scene::FlushTransformChanges()
+	{
+		MEGA_PROFILE_SCOPE("Scene::FlushTransformChanges");
+
+		if (m_isHierarchyDirty) { RebuildTransformHierarchy(); }
+
+		m_transformPass++;
+		m_dirtyNodes.clear();
+		for (const entt::entity entity : m_dirtyTransforms)
+		{
+			// Removed since it changed, or on the list twice
+			Component::Transform* pTransform = m_registry.valid(entity) ? m_registry.try_get<Component::Transform>(entity) : nullptr;
+			if (!pTransform || !pTransform->hasChanged) { continue; }
+
+			const uint32_t nodeIndex = pTransform->hierarchyIndex;
+			if (nodeIndex < m_transformHierarchy.size() && m_transformHierarchy[nodeIndex].entity == entity)
+			{
+				m_dirtyNodes.push_back(nodeIndex);
+			}
+			else
+			{
+				UpdateWorldTransform(*pTransform, nullptr); // Not under the root (registry only), its world is its local
+			}
+		}
+		m_dirtyTransforms.clear();
+
+		// Owners come before what they own, so a dirty node under another dirty node is already walked when reached
+		std::sort(m_dirtyNodes.begin(), m_dirtyNodes.end());
+		for (const uint32_t dirtyIndex : m_dirtyNodes)
+		{
+			if (m_transformHierarchy[dirtyIndex].lastPass == m_transformPass) { continue; }
+
+			m_nodeStack.push_back(dirtyIndex);
+			while (!m_nodeStack.empty())
+			{
+				HierarchyNode& node = m_transformHierarchy[m_nodeStack.back()];
+				m_nodeStack.pop_back();
+				node.lastPass = m_transformPass;
+
+				const Component::Transform* pParent = node.parentIndex != UINT32_MAX ? &m_registry.get<Component::Transform>(m_transformHierarchy[node.parentIndex].entity) : nullptr;
+				UpdateWorldTransform(m_registry.get<Component::Transform>(node.entity), pParent);
+
+				for (uint32_t i = 0; i < node.childCount; i++) { m_nodeStack.push_back(node.firstChild + i); }
+			}
+		}
+	}
+	void Scene::ResetChangedTransforms()
+	{
+		// Transforms that moved in the last tick are at rest until they change again
+		for (const entt::entity entity : m_changedTransforms)
+		{
+			if (!m_registry.valid(entity)) { continue; }
+
+			if (Component::Transform* pTransform = m_registry.try_get<Component::Transform>(entity)) { pTransform->isMoving = false; }
+		}
+		m_changedTransforms.clear();
+	}
+	void Scene::UpdateWorldTransform(Component::Transform& in_transform, const Component::Transform* in_pParent)
+	{
+		if (in_transform.isMatrixDirty) { in_transform.RebuildMatrix(); }
+		if (in_pParent) { in_transform.worldTransform = in_pParent->GetWorldTransform() * in_transform.transform; }
+		in_transform.hasChanged = false;
+
+		if (!in_transform.isMoving)
+		{
+			in_transform.isMoving = true;
+			m_changedTransforms.push_back(in_transform.entity);
+		}
+	}
+	void Scene::RebuildTransformHierarchy()
+	{
+		m_transformHierarchy.clear();
+		m_isHierarchyDirty = false;
+		if (!m_pRootEntity) { return; }
+
+		// The array doubles as the breadth first queue, the entities are kept next to it while it is built
+		m_hierarchyEntities.clear();
+		m_transformHierarchy.push_back({ m_pRootEntity->m_enttID, UINT32_MAX });
+		m_hierarchyEntities.push_back(m_pRootEntity);
+		m_registry.get<Component::Transform>(m_pRootEntity->m_enttID).hierarchyIndex = 0;
+		for (uint32_t i = 0; i < m_transformHierarchy.size(); i++)
+		{
+			const uint32_t firstChild = (uint32_t)m_transformHierarchy.size();
+			for (const EntityHandle childHandle : m_hierarchyEntities[i]->m_children)
+			{
+				Entity* pChild = GetEntity(childHandle);
+				if (!pChild) { continue; }
+
+				// Its transform was removed, nothing under it can be placed
+				Component::Transform* pTransform = m_registry.try_get<Component::Transform>(pChild->m_enttID);
+				if (!pTransform) { continue; }
+
+				pTransform->hierarchyIndex = (uint32_t)m_transformHierarchy.size();
+				if (!pTransform->hasParent)
+				{
+					// World matrix has never been computed, make sure the next pass does
+					pTransform->hasParent = true;
+					pTransform->RecordChange();
+				}
+
+				m_transformHierarchy.push_back({ pChild->m_enttID, i });
+				m_hierarchyEntities.push_back(pChild);
+			}
+
+			m_transformHierarchy[i].firstChild = firstChild;
+			m_transformHierarchy[i].childCount = (uint32_t)m_transformHierarchy.size() - firstChild;
+		}
+	}
+	void Scene::OnConstructTransform(entt::registry& in_registry, const entt::entity in_entity)
+	{
+		Component::Transform& transform = in_registry.get<Component::Transform>(in_entity);
+		transform.pScene = this;
+		transform.entity = in_entity;
+		transform.hierarchyIndex = UINT32_MAX;
+		transform.isMoving = false;
+
+		// New transforms count as changed, also when copied from one that was already flushed
+		transform.hasChanged = true;
+		m_dirtyTransforms.push_back(in_entity);
+		m_isHierarchyDirty = true;
+	}
+
+	void Scene::ClearComponentChanges()
+	{
+		for (auto& [id, pChanges] : m_pComponentChanges)
+		{
+			pChanges->added.clear();
+			pChanges->changed.clear();
+			pChanges->removed.clear();
+		}
+	}
+
+	void Scene::FlushCommands()
+	{
+		MEGA_ASSERT(!m_isStructureLocked, "Flushing command buffers while systems are running");
+
+		// Transforms it creates or destroys mark the hierarchy for a rebuild through the storage's hooks (see
+		// OnConstructTransform), so the next transform pass picks them up
+		CommandBuffer::Flush(m_pCommandBuffers, m_registry);
+	}
+	void Scene::OnEntityActiveChanged(Entity* in_pEntity)
+	{
+		// Not in a list yet (still initializing) or the root, which is always updated
+		if (in_pEntity->m_listIndex == UINT32_MAX) { return; }
+
+		m_pEntityListsByType[in_pEntity->m_typeID]->OnActiveChanged(in_pEntity);
+	}
 	void Scene::DeleteEntity(Entity* in_pEntity)
 	{
 		m_registry.destroy(in_pEntity->m_enttID);
+		ReleaseHandle(in_pEntity->GetHandle());
 
-		delete in_pEntity;
+		m_isHierarchyDirty = true;
 	}
 	void Scene::DeleteAllDestroyed()
 	{
-		for (std::vector<Entity*>& sublist : m_pEntities)
+		for (std::unique_ptr<EntityListBase>& pList : m_entityLists)
+		{
+			pList->DeleteDestroyed(*this);
+		}
+	}
+
+	EntityHandle Scene::AcquireHandle(Entity* in_pEntity)
+	{
+		uint32_t index = m_firstFreeSlot;
+		if (index != UINT32_MAX)
+		{
+			m_firstFreeSlot = m_entitySlots[index].nextFree;
+		}
+		else
 		{
-			sublist.erase(
-				std::remove_if(
-					sublist.begin(), sublist.end(),
-					[this](Entity* e)
-					{
-						if (e->IsDestroyed())
-						{
-							DeleteEntity(e);
-							return true;
-						}
-						return false;
-					}
-				),
-				sublist.end()
-			);
+			const size_t capacity = m_entitySlots.capacity();
+			index = (uint32_t)m_entitySlots.size();
+			m_entitySlots.emplace_back();
+			CountAllocations(m_entitySlots.capacity() != capacity ? 1 : 0);
 		}
+
+		EntitySlot& slot = m_entitySlots[index];
+		slot.pEntity = in_pEntity;
+		slot.nextFree = UINT32_MAX;
+
+		return { index, slot.generation };
+	}
+	void Scene::ReleaseHandle(const EntityHandle in_handle)
+	{
+		EntitySlot& slot = m_entitySlots[in_handle.index];
+		MEGA_ASSERT(slot.generation == in_handle.generation, "Releasing a stale entity handle");
+
+		// Bumping the generation is what makes every outstanding handle to this entity resolve to null
+		slot.pEntity = nullptr;
+		slot.generation++;
+		slot.nextFree = m_firstFreeSlot;
+		m_firstFreeSlot = in_handle.index;
 	}
 };
\ No newline at end of file
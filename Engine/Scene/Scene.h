@@ -1,10 +1,19 @@
 #pragma once
 
+#include <memory>
+#include <vector>
+#include <algorithm>
+#include <unordered_map>
 #include <entt/entt.hpp>
 
 #include "Engine/ECS/Entity.h"
+#include "Engine/ECS/EntityPool.h"
+#include "Engine/ECS/EntityHandle.h"
+#include "Engine/ECS/CommandBuffer.h"
 #include "Engine/Core/Core.h"
+#include "Engine/Core/JobSystem.h"
 #include "Engine/Scene/Input.h"
+#include "Engine/Scene/Prefab.h"
 
 // Forward declarations
 class Mega::Entity;
@@ -16,8 +25,10 @@ namespace Mega
 	{
 	public:
 		friend Engine;
+		friend Entity;
+		friend Component::Transform;
 
-		eMegaResult Initialize();
+		eMegaResult Initialize(const uint32_t in_threadCount = 1); // One command buffer per thread that can record into one
 		eMegaResult Destroy();
 		eMegaResult Update(const tTimestep in_dt);
 		eMegaResult UpdatePost(const tTimestep in_dt);
@@ -26,6 +37,17 @@ namespace Mega
 		inline entt::registry& GetRegistry() { return m_registry; }
 		inline const entt::registry& GetRegistry() const { return m_registry; }
 
+		// The calling thread's command buffer. Systems record structural changes here instead of touching the
+		// registry while other systems may be iterating it, the engine flushes every buffer after the systems run.
+		// Only the main thread and the job system's workers have one
+		inline CommandBuffer& GetCommandBuffer()
+		{
+			const uint32_t threadIndex = JobSystem::GetThreadIndex();
+			MEGA_ASSERT(threadIndex < m_pCommandBuffers.size(), "Recording commands from a thread outside the job system (the scene loader?)");
+			return *m_pCommandBuffers[threadIndex];
+		}
+		inline bool IsStructureLocked() const { return m_isStructureLocked; }
+
 		// All entities must have unbroken chain of ownership so the scene is
 		// only in charge of creating and controlling the root entity
 		template<typename tEntityType, class... Args>
@@ -42,76 +64,349 @@ namespace Mega
 			out_root->m_enttID = enttID;
 			out_root->m_pRegistry = &m_registry;
 			out_root->m_pScene = this;
+			out_root->m_typeID = EntityType::GetID<tEntityType>();
+			out_root->m_handle = AcquireHandle(out_root);
 
 			// Create ownership chain
 			out_root->SetOwner(out_root);
 			m_pRootEntity = out_root;
+			m_isHierarchyDirty = true;
 
 			out_root->Initialize();
 
 			return out_root;
 		}
 
-		// Returns a vector of all of a certain type of entity in the scene
+		// Returns every entity of a certain type in the scene (an exact type, not derived ones), active ones first.
+		// The list is empty if none have been added
 		template<typename tEntityType>
-		inline std::vector<tEntityType*>& GetAllOf()
+		inline const std::vector<tEntityType*>& GetAllOf() const
 		{
 			MEGA_STATIC_ASSERT(std::is_base_of<Entity, tEntityType>::value, "Type must be descendant of Entity class");
 
-			for (auto& sublist : m_pEntities)
+			const tEntityTypeID typeID = EntityType::GetID<tEntityType>();
+			if (typeID < m_pEntityListsByType.size() && m_pEntityListsByType[typeID])
 			{
-				if (Entity::TypeOf(sublist[0]) == Entity::TypeOf<tEntityType>())
-				{
-					return sublist;
-				}
+				return static_cast<const EntityList<tEntityType>*>(m_pEntityListsByType[typeID])->entities;
 			}
 
-			MEGA_ASSERT(false, "That entity type has not been added to scene");
-			return {};
+			static const std::vector<tEntityType*> s_empty;
+			return s_empty;
+		}
+
+		// Null if the entity has been deleted since the handle was taken
+		inline Entity* GetEntity(const EntityHandle in_handle) const
+		{
+			if (in_handle.index >= m_entitySlots.size()) { return nullptr; }
+
+			const EntitySlot& slot = m_entitySlots[in_handle.index];
+			return slot.generation == in_handle.generation ? slot.pEntity : nullptr;
+		}
+
+		// Entities whose transform changed during the last tick, filled by FlushTransformChanges. Ids can be stale if the
+		// entity has been destroyed since. An entity is listed once per tick
+		inline const std::vector<entt::entity>& GetChangedTransforms() const { return m_changedTransforms; }
+
+		// ------------ Change Tracking ------------ //
+		// Which entities had a component added, changed (Entity::MarkComponentChanged, or registry patch) or removed
+		// since the last drawn frame, so systems can redo work only for what changed. Ids can be stale, and an entity
+		// shows up once per change
+		struct ComponentChanges
+		{
+			std::vector<entt::entity> added;
+			std::vector<entt::entity> changed;
+			std::vector<entt::entity> removed;
+
+			inline bool IsEmpty() const { return added.empty() && changed.empty() && removed.empty(); }
+
+			// Storage callbacks
+			void OnAdded(entt::registry& in_registry, const entt::entity in_entity) { added.push_back(in_entity); }
+			void OnChanged(entt::registry& in_registry, const entt::entity in_entity) { changed.push_back(in_entity); }
+			void OnRemoved(entt::registry& in_registry, const entt::entity in_entity) { removed.push_back(in_entity); }
+		};
+
+		// Starts recording changes to a component type, nothing is recorded for types that are not tracked
+		template<typename tComponent>
+		void TrackChanges()
+		{
+			std::unique_ptr<ComponentChanges>& pChanges = m_pComponentChanges[entt::type_hash<tComponent>::value()];
+			if (pChanges) { return; }
+
+			pChanges = std::make_unique<ComponentChanges>();
+			m_registry.on_construct<tComponent>().template connect<&ComponentChanges::OnAdded>(pChanges.get());
+			m_registry.on_update<tComponent>().template connect<&ComponentChanges::OnChanged>(pChanges.get());
+			m_registry.on_destroy<tComponent>().template connect<&ComponentChanges::OnRemoved>(pChanges.get());
 		}
+		template<typename tComponent>
+		const ComponentChanges& GetComponentChanges() const
+		{
+			auto it = m_pComponentChanges.find(entt::type_hash<tComponent>::value());
+			MEGA_ASSERT(it != m_pComponentChanges.end(), "Reading the changes of a component type that is not tracked");
+			return *it->second;
+		}
+		void ClearComponentChanges(); // Called by the engine once the frame has been drawn
+
+		// Heap allocations made by entity storage (new pool slabs, list and handle table growth) during the last
+		// finished frame. Stays at zero once every pool has grown to the game's peak entity count
+		inline uint32_t GetEntityAllocationCount() const { return m_lastFrameAllocationCount; }
+		inline uint64_t GetTotalEntityAllocationCount() const { return m_totalAllocationCount; }
 
 	private:
-		// Ownership System: Adding A Child Entity
+		// Ownership System: Adding A Child Entity. The child's transform is relative to its owner's
 		template<typename tEntityType, class... Args>
-		inline tEntityType* AddEntity(Args&&... in_args)
+		inline tEntityType* AddEntity(Entity* in_owner, Args&&... in_args)
 		{
-			Entity* in_owner = m_pRootEntity; // TODO: all entities are children of root for now
-
 			MEGA_ASSERT(in_owner, "Creating a non-root entity with a null owner");
+			MEGA_ASSERT(in_owner->m_pScene == this, "Creating an entity owned by an entity from another scene");
+			MEGA_ASSERT(!m_isStructureLocked, "Creating an entity while systems are running, record it into a command buffer instead");
 			static_assert(std::is_base_of<Entity, tEntityType>::value, "Type must be descendant of Entity class to be added to scene");
 			//MEGA_ASSERT(in_owner->IsInitialized(), "Creating entity with an uninitialized owner"); TODO: should this be allowed?
 
+			EntityList<tEntityType>& list = GetOrCreateEntityList<tEntityType>();
+			const size_t slabCount = list.pool.GetSlabCount();
+
 			// Create entity
-			tEntityType* out_entity = new tEntityType(std::forward<Args>(in_args)...);
+			tEntityType* out_entity = list.pool.Create(std::forward<Args>(in_args)...);
 			MEGA_ASSERT(out_entity, "Entity could not be allocated");
 
 			entt::entity enttID = m_registry.create();
 			out_entity->m_enttID = enttID;
 			out_entity->m_pRegistry = &m_registry;
 			out_entity->m_pScene = this;
+			out_entity->m_typeID = EntityType::GetID<tEntityType>();
+			out_entity->m_handle = AcquireHandle(out_entity);
 
 			out_entity->SetOwner(in_owner);
 			out_entity->Initialize();
+			m_isHierarchyDirty = true;
+
+			const size_t capacity = list.entities.capacity();
+			out_entity->m_listIndex = (uint32_t)list.entities.size();
+			list.entities.push_back(out_entity);
+			if (out_entity->IsActive()) { list.Activate(out_entity->m_listIndex); }
+
+			CountAllocations((uint32_t)(list.pool.GetSlabCount() - slabCount) + (list.entities.capacity() != capacity ? 1 : 0));
+
+			return out_entity;
+		}
 
-			// Add to entity list
-			for (auto& list : m_pEntities)
+		// Creates an entity per instance, each starting with the prefab's components. Everything the batch needs (the
+		// type's list and pool, the handle table, every component pool) is grown once up front and each component
+		// type is added to all the instances in one insert. Entities are initialized once all of their components are
+		// in, so OnInitialize can already use them. Instances under a disabled owner start disabled (see
+		// Entity::SetIsEnabled), their bodies never join the physics world until the owner is enabled
+		template<typename tEntityType, class... Args>
+		void Instantiate(Entity* in_owner, const Prefab& in_prefab, const std::vector<Prefab::Instance>& in_instances, std::vector<tEntityType*>* out_pEntities, const Args&... in_args)
+		{
+			MEGA_ASSERT(in_owner, "Instantiating a prefab with a null owner");
+			MEGA_ASSERT(in_owner->m_pScene == this, "Instantiating a prefab under an entity from another scene");
+			MEGA_ASSERT(!m_isStructureLocked, "Instantiating a prefab while systems are running");
+			static_assert(std::is_base_of<Entity, tEntityType>::value, "Type must be descendant of Entity class to be added to scene");
+
+			const size_t count = in_instances.size();
+			if (count == 0) { return; }
+
+			EntityList<tEntityType>& list = GetOrCreateEntityList<tEntityType>();
+			const size_t slabCount = list.pool.GetSlabCount();
+			const size_t listCapacity = list.entities.capacity();
+			const size_t slotCapacity = m_entitySlots.capacity();
+
+			list.entities.reserve(list.entities.size() + count);
+			m_entitySlots.reserve(m_entitySlots.size() + count);
+			in_owner->m_children.reserve(in_owner->m_children.size() + count);
+			auto& transformStorage = m_registry.storage<Component::Transform>();
+			transformStorage.reserve(transformStorage.size() + count);
+			for (const std::unique_ptr<Prefab::PrefabComponentBase>& pComponent : in_prefab.m_pComponents)
+			{
+				pComponent->Reserve(m_registry, count);
+			}
+
+			std::vector<entt::entity> enttIDs(count);
+			m_registry.create(enttIDs.begin(), enttIDs.end());
+
+			const bool isOwnerEnabled = in_owner->IsEnabled();
+			if (!isOwnerEnabled) { m_registry.insert<Component::Disabled>(enttIDs.begin(), enttIDs.end()); } // Before the prefab's rigid bodies
+
+			std::vector<tEntityType*> entities;
+			std::vector<tEntityType*>& created = out_pEntities ? *out_pEntities : entities;
+			const size_t firstCreated = created.size();
+			created.reserve(firstCreated + count);
+
+			for (size_t i = 0; i < count; i++)
 			{
-				if (list.size() > 0)
+				tEntityType* pEntity = list.pool.Create(in_args...); // Every instance is constructed from the same arguments
+				MEGA_ASSERT(pEntity, "Entity could not be allocated");
+
+				pEntity->m_enttID = enttIDs[i];
+				pEntity->m_pRegistry = &m_registry;
+				pEntity->m_pScene = this;
+				pEntity->m_typeID = EntityType::GetID<tEntityType>();
+				pEntity->m_handle = AcquireHandle(pEntity);
+
+				// Rigid bodies read their starting transform when they are added
+				const Prefab::Instance& instance = in_instances[i];
+				m_registry.emplace<Component::Transform>(enttIDs[i], instance.position, instance.rotation, instance.scale);
+
+				pEntity->SetOwner(in_owner);
+				pEntity->m_listIndex = (uint32_t)list.entities.size();
+				list.entities.push_back(pEntity);
+				pEntity->m_isActive = isOwnerEnabled;
+				if (isOwnerEnabled) { list.Activate(pEntity->m_listIndex); }
+
+				created.push_back(pEntity);
+			}
+
+			for (const std::unique_ptr<Prefab::PrefabComponentBase>& pComponent : in_prefab.m_pComponents)
+			{
+				pComponent->Insert(m_registry, enttIDs.data(), enttIDs.data() + count);
+			}
+
+			for (size_t i = firstCreated; i < created.size(); i++)
+			{
+				created[i]->Initialize();
+			}
+			m_isHierarchyDirty = true;
+
+			CountAllocations((uint32_t)(list.pool.GetSlabCount() - slabCount) + (list.entities.capacity() != listCapacity ? 1 : 0)
+				+ (m_entitySlots.capacity() != slotCapacity ? 1 : 0));
+		}
+
+		// ------------ Entity Storage ------------ //
+		// Every entity of one type, kept together so updating or iterating a type walks a single array. Typed so
+		// GetAllOf can hand the array out as is, the base lets the scene update every list without knowing the types.
+		// Active entities are kept at the front so the tick passes never look at inactive ones
+		class EntityListBase
+		{
+		public:
+			virtual ~EntityListBase() = default;
+
+			virtual void Update(const tTimestep in_dt) = 0;
+			virtual void UpdatePost(const tTimestep in_dt) = 0;
+			virtual void DeleteDestroyed(Scene& in_scene) = 0;
+			virtual void OnActiveChanged(Entity* in_pEntity) = 0;
+		};
+
+		template<typename tEntityType>
+		class EntityList final : public EntityListBase
+		{
+		public:
+			// Types that leave OnUpdate / OnUpdatePost as Entity's empty default never get a tick list entry
+			static constexpr bool s_hasUpdate = !std::is_same_v<decltype(&tEntityType::OnUpdate), decltype(&Entity::OnUpdate)>;
+			static constexpr bool s_hasUpdatePost = !std::is_same_v<decltype(&tEntityType::OnUpdatePost), decltype(&Entity::OnUpdatePost)>;
+
+			// Entities can add, activate and deactivate more of their own type while a pass runs, the cursor marks
+			// how far it has got so OnActiveChanged can keep the updated entities in front of it
+			void Update(const tTimestep in_dt) override
+			{
+				if constexpr (s_hasUpdate)
+				{
+					for (m_cursor = 0; m_cursor < m_activeCount;)
+					{
+						entities[m_cursor++]->template Update<tEntityType>(in_dt);
+					}
+					m_cursor = 0;
+				}
+			}
+			void UpdatePost(const tTimestep in_dt) override
+			{
+				if constexpr (s_hasUpdatePost)
 				{
-					// Fine the correct sub list to put this entity type in
-					if (Entity::TypeOf(list[0]) == Entity::TypeOf(out_entity))
+					for (m_cursor = 0; m_cursor < m_activeCount;)
 					{
-						list.push_back(out_entity);
-						return out_entity;
-					};
-				};
-			};
+						entities[m_cursor++]->template UpdatePost<tEntityType>(in_dt);
+					}
+					m_cursor = 0;
+				}
+			}
+			void DeleteDestroyed(Scene& in_scene) override
+			{
+				// Destroyed entities are inactive, so only the back of the list has to be searched
+				const auto inactiveBegin = entities.begin() + m_activeCount;
+				entities.erase(
+					std::remove_if(
+						inactiveBegin, entities.end(),
+						[this, &in_scene](tEntityType* e)
+						{
+							if (e->IsDestroyed())
+							{
+								in_scene.DeleteEntity(e);
+								pool.Delete(e);
+								return true;
+							}
+							return false;
+						}
+					),
+					entities.end()
+				);
 
-			// If theres not a current list for this type of entity, make a new one
-			std::vector<Entity*> newList = { out_entity };
-			m_pEntities.push_back(newList);
+				for (uint32_t i = m_activeCount; i < entities.size(); i++) { entities[i]->m_listIndex = i; }
+			}
+			void OnActiveChanged(Entity* in_pEntity) override
+			{
+				if (in_pEntity->IsActive()) { Activate(in_pEntity->m_listIndex); }
+				else { Deactivate(in_pEntity->m_listIndex); }
+			}
 
-			return out_entity;
+			// Moves an entity behind the active range into it. It lands after the cursor, so an entity activated
+			// mid pass is still updated by that pass (twice, if it was deactivated after its update earlier in the pass)
+			void Activate(const uint32_t in_index)
+			{
+				MEGA_ASSERT(in_index >= m_activeCount, "Activating an entity that is already in the active range");
+				Swap(in_index, m_activeCount);
+				m_activeCount++;
+			}
+			void Deactivate(uint32_t in_index)
+			{
+				MEGA_ASSERT(in_index < m_activeCount, "Deactivating an entity that is not in the active range");
+
+				// Already updated this pass, first swap it with the last updated entity and pull the cursor back so
+				// the entity that replaces it below is not skipped
+				if (in_index < m_cursor)
+				{
+					m_cursor--;
+					Swap(in_index, m_cursor);
+					in_index = m_cursor;
+				}
+
+				m_activeCount--;
+				Swap(in_index, m_activeCount);
+			}
+
+			std::vector<tEntityType*> entities;
+			EntityPool<tEntityType> pool; // Memory for the entities above
+
+		private:
+			void Swap(const uint32_t in_a, const uint32_t in_b)
+			{
+				std::swap(entities[in_a], entities[in_b]);
+				entities[in_a]->m_listIndex = in_a;
+				entities[in_b]->m_listIndex = in_b;
+			}
+
+			uint32_t m_activeCount = 0; // entities[0, m_activeCount) are active
+			uint32_t m_cursor = 0; // Next entity to update while a pass is running, 0 otherwise
+		};
+
+		template<typename tEntityType>
+		EntityList<tEntityType>& GetOrCreateEntityList()
+		{
+			const tEntityTypeID typeID = EntityType::GetID<tEntityType>();
+			if (typeID >= m_pEntityListsByType.size())
+			{
+				m_pEntityListsByType.resize((size_t)typeID + 1, nullptr);
+				CountAllocations(1);
+			}
+
+			EntityListBase*& pList = m_pEntityListsByType[typeID];
+			if (!pList)
+			{
+				pList = m_entityLists.emplace_back(std::make_unique<EntityList<tEntityType>>()).get();
+				if constexpr (EntityList<tEntityType>::s_hasUpdate) { m_pUpdateLists.push_back(pList); }
+				if constexpr (EntityList<tEntityType>::s_hasUpdatePost) { m_pUpdatePostLists.push_back(pList); }
+				CountAllocations(1);
+			}
+
+			return *static_cast<EntityList<tEntityType>*>(pList);
 		}
 
 		// Scene is only creatable and destroyable by Engine
@@ -124,12 +419,81 @@ namespace Mega
 		Scene& operator=(const Scene&) = delete;
 		Scene& operator=(Scene&&) = delete;
 
-		void DeleteEntity(Entity* in_entity);
+		// Rebuilds the matrix of every transform changed since the last call, propagates world matrices to the
+		// subtrees under them, and records every transform whose world matrix changed. Run by the engine right before
+		// the systems are scheduled and again at the end of the tick. While systems run, setters rebuild the local
+		// matrix straight away (see Transform::MarkChanged), so parallel readers never write the lazy matrix. World
+		// matrices under a transform moved by a system catch up at the end of the tick
+		void FlushTransformChanges();
+		void ResetChangedTransforms(); // Starts a tick's changed list, once the engine stored the previous transforms
+		void RebuildTransformHierarchy();
+		// Recomputes one transform's matrices and records it as changed, its owner's world matrix is already current
+		void UpdateWorldTransform(Component::Transform& in_transform, const Component::Transform* in_pParent);
+
+		// Transform storage callbacks. Adding or removing a transform can change the hierarchy, and swap and pop
+		// moves other transforms, so only entt ids are kept anywhere
+		void OnConstructTransform(entt::registry& in_registry, const entt::entity in_entity);
+		void OnDestroyTransform(entt::registry& in_registry, const entt::entity in_entity) { m_isHierarchyDirty = true; }
+		inline void OnTransformChanged(const entt::entity in_entity) { m_dirtyTransforms.push_back(in_entity); } // By Transform::RecordChange
+
+		void FlushCommands(); // Makes every change recorded into the command buffers, only while no system is running
+		void OnEntityActiveChanged(Entity* in_pEntity); // Called by Entity::SetIsActive
+		void DeleteEntity(Entity* in_entity); // Frees the entity's ECS id and handle, its list's pool frees the memory
 		void DeleteAllDestroyed();
 
+		// ------------ Handles ------------ //
+		struct EntitySlot
+		{
+			Entity* pEntity = nullptr;
+			uint32_t generation = 0;
+			uint32_t nextFree = UINT32_MAX;
+		};
+
+		EntityHandle AcquireHandle(Entity* in_pEntity);
+		void ReleaseHandle(const EntityHandle in_handle);
+
+		inline void CountAllocations(const uint32_t in_count) { m_frameAllocationCount += in_count; m_totalAllocationCount += in_count; }
+
 		// ENTT
 		entt::registry m_registry{};
 		Entity* m_pRootEntity = nullptr;
-		std::vector<std::vector<Entity*>> m_pEntities{};
+
+		std::vector<std::unique_ptr<CommandBuffer>> m_pCommandBuffers{}; // Indexed by JobSystem::GetThreadIndex
+		bool m_isStructureLocked = false; // Set by the engine while systems run, entities and components can not be added or removed directly
+
+		std::vector<std::unique_ptr<EntityListBase>> m_entityLists{}; // In the order their types were first added, which is the update order
+		std::vector<EntityListBase*> m_pEntityListsByType{}; // Indexed by tEntityTypeID, null for types with no list yet
+		std::vector<EntityListBase*> m_pUpdateLists{}; // Lists whose type overrides OnUpdate, same order as above
+		std::vector<EntityListBase*> m_pUpdatePostLists{}; // Lists whose type overrides OnUpdatePost, same order as above
+
+		// ------------ Transform Hierarchy ------------ //
+		// Every entity's transform in breadth first order from the root, so a parent always comes before its children
+		// and each node's children sit next to each other. Rebuilt only when entities or transforms are added or removed
+		struct HierarchyNode
+		{
+			entt::entity entity = entt::null;
+			uint32_t parentIndex = UINT32_MAX; // Into the hierarchy, UINT32_MAX for the root
+			uint32_t firstChild = 0;
+			uint32_t childCount = 0;
+			uint32_t lastPass = 0; // Last transform pass that walked this node, so overlapping dirty subtrees are walked once
+		};
+		std::vector<HierarchyNode> m_transformHierarchy{};
+		bool m_isHierarchyDirty = true;
+		uint32_t m_transformPass = 0;
+
+		std::vector<entt::entity> m_dirtyTransforms{}; // Changed since the last pass, see Transform::RecordChange
+		std::vector<uint32_t> m_dirtyNodes{}; // Scratch for the pass and the rebuild, kept so their memory is reused
+		std::vector<uint32_t> m_nodeStack{};
+		std::vector<Entity*> m_hierarchyEntities{};
+
+		std::vector<entt::entity> m_changedTransforms{};
+		std::unordered_map<entt::id_type, std::unique_ptr<ComponentChanges>> m_pComponentChanges{}; // By component type, see TrackChanges
+
+		std::vector<EntitySlot> m_entitySlots{};
+		uint32_t m_firstFreeSlot = UINT32_MAX; // Freed slots form a list through EntitySlot::nextFree
+
+		uint32_t m_frameAllocationCount = 0;
+		uint32_t m_lastFrameAllocationCount = 0;
+		uint64_t m_totalAllocationCount = 0;
 	};
 } // namespace Mega
\ No newline at end of file
@@ -0,0 +1,494 @@
+#include "SceneSnapshot.h"
+
+#include <mutex>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <unordered_set>
+
+#include "Engine/Engine.h"
+#include "Engine/Core/Profiler.h"
+
+namespace Mega
+{
+	namespace
+	{
+		inline size_t AlignSection(const size_t in_offset)
+		{
+			return (in_offset + SNAPSHOT_SECTION_ALIGNMENT - 1) & ~(size_t)(SNAPSHOT_SECTION_ALIGNMENT - 1);
+		}
+	}
+
+	bool SceneSnapshot::Save(const Entity* in_pRoot, const tFilePath in_filePath)
+	{
+		MEGA_PROFILE_SCOPE("SceneSnapshot::Save");
+		MEGA_ASSERT(in_pRoot, "Saving a snapshot of a null entity");
+
+		std::vector<EntityRecord> entities;
+		std::vector<ModelRecord> models;
+		std::vector<AnimatedModelRecord> animatedModels;
+		std::vector<AnimationRecord> animations;
+		std::vector<BodyRecord> bodies;
+		std::vector<LightRecord> lights;
+		std::vector<SoundEffectRecord> soundEffects;
+
+		// Every path and name is stored once
+		std::string strings;
+		std::unordered_map<std::string, uint32_t> stringOffsets;
+		const auto addString = [&strings, &stringOffsets](const std::string_view in_string) -> uint32_t
+		{
+			if (in_string.empty()) { return SNAPSHOT_NO_STRING; }
+
+			auto [it, isNew] = stringOffsets.try_emplace(std::string(in_string), (uint32_t)strings.size());
+			if (isNew)
+			{
+				strings.append(in_string);
+				strings.push_back('\0');
+			}
+			return it->second;
+		};
+
+		// Depth first, so every parent is written before its children and each entity's records are written together
+		uint32_t skippedCount = 0;
+		std::vector<std::pair<const Entity*, uint32_t>> stack = { { in_pRoot, UINT32_MAX } };
+		while (!stack.empty())
+		{
+			const auto [pEntity, parent] = stack.back();
+			stack.pop_back();
+			if (pEntity->IsDestroyed()) { continue; }
+
+			const uint32_t index = (uint32_t)entities.size();
+			const entt::registry& registry = *pEntity->m_pRegistry;
+			const entt::entity id = pEntity->m_enttID;
+
+			const Component::Transform& transform = *pEntity->m_pTransformComponent;
+			EntityRecord& entity = entities.emplace_back();
+			entity.parent = parent;
+			entity.isEnabled = index == 0 ? pEntity->IsEnabled() : pEntity->IsEnabledSelf(); // The root has no owner in the snapshot
+			entity.isActive = pEntity->IsActiveSelf();
+			entity.position = transform.GetPosition();
+			entity.rotation = transform.GetRotation();
+			entity.scale = transform.GetScale();
+			entity.orientation = transform.GetOrientation();
+
+			if (const Component::Model* pModel = registry.try_get<Component::Model>(id))
+			{
+				const std::string meshPath = Engine::FindAssetPath(pModel->vertexData);
+				if (meshPath.empty()) { skippedCount++; }
+				else { models.push_back({ index, addString(meshPath), addString(Engine::FindAssetPath(pModel->textureData)), pModel->materialData }); }
+			}
+
+			if (const Component::AnimatedModel* pModel = registry.try_get<Component::AnimatedModel>(id))
+			{
+				const std::string meshPath = Engine::FindAssetPath(pModel->mesh);
+				const std::string skeletonPath = Engine::FindAssetPath(pModel->skeleton);
+				if (meshPath.empty() || skeletonPath.empty()) { skippedCount++; }
+				else
+				{
+					const uint32_t firstAnimation = (uint32_t)animations.size();
+					for (const auto& [name, animation] : pModel->animationNameMap)
+					{
+						animations.push_back({ addString(name), addString(Engine::FindAssetPath(animation)), animation.shouldLoop });
+					}
+					animatedModels.push_back({ index, addString(meshPath), addString(skeletonPath), firstAnimation, (uint32_t)animations.size() - firstAnimation, pModel->isPlaying });
+				}
+			}
+
+			if (const Component::RigidBody* pBody = registry.try_get<Component::RigidBody>(id))
+			{
+				BodyRecord body;
+				body.entity = index;
+				body.type = (uint32_t)pBody->type;
+				body.mass = pBody->mass;
+				body.friction = pBody->friction;
+				body.restitution = pBody->restitution;
+				body.gravity = pBody->gravity;
+				body.syncRotation = pBody->syncRot;
+				body.localOffset = pBody->localOffset;
+
+				// Same order the physics system picks the shape in
+				bool hasShape = true;
+				if (const Component::CollisionCapsule* pCapsule = registry.try_get<Component::CollisionCapsule>(id))
+				{
+					body.shapeType = eShapeType::Capsule;
+					body.shapeSize = Vec3(pCapsule->radius, pCapsule->height, 0);
+				}
+				else if (const Component::CollisionTriangleMesh* pMesh = registry.try_get<Component::CollisionTriangleMesh>(id))
+				{
+					body.shapeType = eShapeType::TriangleMesh;
+					body.shapeMeshPath = addString(Engine::FindAssetPath(pMesh->vertexData));
+					hasShape = body.shapeMeshPath != SNAPSHOT_NO_STRING;
+				}
+				else if (const Component::CollisionSphere* pSphere = registry.try_get<Component::CollisionSphere>(id))
+				{
+					body.shapeType = eShapeType::Sphere;
+					body.shapeSize = Vec3(pSphere->radius, 0, 0);
+				}
+				else if (const Component::CollisionBox* pBox = registry.try_get<Component::CollisionBox>(id))
+				{
+					body.shapeType = eShapeType::Box;
+					body.shapeSize = pBox->dimensions;
+				}
+				else { hasShape = false; } // Height fields
+
+				if (hasShape) { bodies.push_back(body); }
+				else { skippedCount++; }
+			}
+
+			if (const Component::Light* pLight = registry.try_get<Component::Light>(id))
+			{
+				lights.push_back({ index, pLight->lightData });
+			}
+
+			if (const Component::SoundPlayer* pPlayer = registry.try_get<Component::SoundPlayer>(id))
+			{
+				SoundEffectRecord soundEffect = { index, SNAPSHOT_NO_STRING, SNAPSHOT_NO_STRING, pPlayer->soundSource.GetGain(),
+					pPlayer->soundSource.GetPitch(), pPlayer->buffer, pPlayer->playSpeed };
+				if (pPlayer->sounds.empty()) { soundEffects.push_back(soundEffect); } // Still restores the player
+
+				for (const auto& [name, sound] : pPlayer->sounds)
+				{
+					soundEffect.name = addString(name);
+					soundEffect.path = addString(Engine::FindAssetPath(sound));
+					if (soundEffect.path == SNAPSHOT_NO_STRING) { skippedCount++; continue; }
+
+					soundEffects.push_back(soundEffect);
+				}
+			}
+
+			if (registry.any_of<Component::Water, Component::CollisionHeightField>(id)) { skippedCount++; }
+
+			// Reversed so the children come off the stack in order
+			for (auto it = pEntity->m_children.rbegin(); it != pEntity->m_children.rend(); it++)
+			{
+				if (const Entity* pChild = pEntity->m_pScene->GetEntity(*it)) { stack.push_back({ pChild, index }); }
+			}
+		}
+
+		if (skippedCount > 0) { std::cout << "Snapshot " << in_filePath << " skipped " << skippedCount << " components without a file to load them from" << std::endl; }
+
+		// Lay the sections out one after another
+		Header header;
+		size_t byteCount = AlignSection(sizeof(Header));
+		const auto placeSection = [&header, &byteCount](const eSection in_section, const size_t in_count, const size_t in_recordSize)
+		{
+			header.sections[(size_t)in_section] = { (uint32_t)byteCount, (uint32_t)in_count };
+			byteCount = AlignSection(byteCount + in_count * in_recordSize);
+		};
+		placeSection(eSection::Entities, entities.size(), sizeof(EntityRecord));
+		placeSection(eSection::Models, models.size(), sizeof(ModelRecord));
+		placeSection(eSection::AnimatedModels, animatedModels.size(), sizeof(AnimatedModelRecord));
+		placeSection(eSection::Animations, animations.size(), sizeof(AnimationRecord));
+		placeSection(eSection::Bodies, bodies.size(), sizeof(BodyRecord));
+		placeSection(eSection::Lights, lights.size(), sizeof(LightRecord));
+		placeSection(eSection::SoundEffects, soundEffects.size(), sizeof(SoundEffectRecord));
+		placeSection(eSection::Strings, strings.size(), 1);
+		header.byteCount = (uint32_t)byteCount;
+
+		std::vector<uint8_t> bytes(byteCount, 0);
+		std::memcpy(bytes.data(), &header, sizeof(Header));
+		const auto copySection = [&header, &bytes](const eSection in_section, const void* in_pData, const size_t in_size)
+		{
+			if (in_size > 0) { std::memcpy(bytes.data() + header.sections[(size_t)in_section].offset, in_pData, in_size); }
+		};
+		copySection(eSection::Entities, entities.data(), entities.size() * sizeof(EntityRecord));
+		copySection(eSection::Models, models.data(), models.size() * sizeof(ModelRecord));
+		copySection(eSection::AnimatedModels, animatedModels.data(), animatedModels.size() * sizeof(AnimatedModelRecord));
+		copySection(eSection::Animations, animations.data(), animations.size() * sizeof(AnimationRecord));
+		copySection(eSection::Bodies, bodies.data(), bodies.size() * sizeof(BodyRecord));
+		copySection(eSection::Lights, lights.data(), lights.size() * sizeof(LightRecord));
+		copySection(eSection::SoundEffects, soundEffects.data(), soundEffects.size() * sizeof(SoundEffectRecord));
+		copySection(eSection::Strings, strings.data(), strings.size());
+
+		std::ofstream file(std::string(in_filePath), std::ios::binary | std::ios::trunc);
+		if (!file) { return false; }
+		file.write(reinterpret_cast<const char*>(bytes.data()), (std::streamsize)bytes.size());
+		return file.good();
+	}
+
+	bool SceneSnapshot::Read(const tFilePath in_filePath)
+	{
+		MEGA_PROFILE_SCOPE("SceneSnapshot::Read");
+
+		m_bytes.clear();
+		m_meshes.clear();
+		m_textures.clear();
+
+		std::ifstream file(std::string(in_filePath), std::ios::ate | std::ios::binary); // Start at the end for the size
+		if (!file) { return false; }
+
+		const size_t byteCount = (size_t)file.tellg();
+		if (byteCount < sizeof(Header)) { return false; }
+
+		// One read, the records are used from this buffer as they are
+		m_bytes.resize(byteCount);
+		file.seekg(0);
+		file.read(reinterpret_cast<char*>(m_bytes.data()), (std::streamsize)byteCount);
+		MEGA_ASSERT((uintptr_t)m_bytes.data() % SNAPSHOT_SECTION_ALIGNMENT == 0, "Snapshot buffer is not aligned for its records");
+
+		const Header& header = GetHeader();
+		bool isValid = file.good() && header.magic == SNAPSHOT_MAGIC && header.version == SNAPSHOT_VERSION && header.byteCount == byteCount;
+
+		const size_t recordSizes[(size_t)eSection::Count] = { sizeof(EntityRecord), sizeof(ModelRecord), sizeof(AnimatedModelRecord),
+			sizeof(AnimationRecord), sizeof(BodyRecord), sizeof(LightRecord), sizeof(SoundEffectRecord), 1 };
+		for (size_t i = 0; i < (size_t)eSection::Count && isValid; i++)
+		{
+			const Section& section = header.sections[i];
+			isValid = section.offset % SNAPSHOT_SECTION_ALIGNMENT == 0 && section.offset + (size_t)section.count * recordSizes[i] <= byteCount;
+		}
+
+		const Section& strings = header.sections[(size_t)eSection::Strings];
+		isValid = isValid && (strings.count == 0 || m_bytes[strings.offset + strings.count - 1] == '\0');
+		isValid = isValid && AreRecordsValid();
+
+		if (!isValid)
+		{
+			std::cout << "Snapshot " << in_filePath << " is damaged or from another version" << std::endl;
+			m_bytes.clear();
+		}
+		return isValid;
+	}
+
+	Entity* SceneSnapshot::Instantiate(Entity* in_owner)
+	{
+		MEGA_PROFILE_SCOPE("SceneSnapshot::Instantiate");
+		MEGA_ASSERT(!m_bytes.empty(), "Instantiating a snapshot that has not been read");
+		MEGA_ASSERT(in_owner, "Instantiating a snapshot with a null owner");
+
+		const uint32_t entityCount = GetCount(eSection::Entities);
+		if (entityCount == 0) { return nullptr; }
+
+		m_nextEntity = 0;
+		m_nextModel = 0;
+		m_nextAnimatedModel = 0;
+		m_nextBody = 0;
+		m_nextLight = 0;
+		m_nextSoundEffect = 0;
+
+		// Each entity restores its components while it initializes (see SnapshotEntity)
+		const EntityRecord* pEntities = GetRecords<EntityRecord>(eSection::Entities);
+		std::vector<Entity*> created(entityCount);
+		for (uint32_t i = 0; i < entityCount; i++)
+		{
+			const uint32_t parent = pEntities[i].parent;
+			MEGA_ASSERT(parent == UINT32_MAX ? i == 0 : parent < i, "Snapshot entity written before its parent");
+
+			created[i] = Engine::AddChildEntity<SnapshotEntity>(parent == UINT32_MAX ? in_owner : created[parent], this);
+		}
+
+		// Once the whole tree exists, disabling an entity reaches its children. Records hold each entity's own state
+		for (uint32_t i = 0; i < entityCount; i++)
+		{
+			const EntityRecord& entity = pEntities[i];
+			if (!entity.isEnabled) { created[i]->SetIsEnabled(false); }
+			if (!entity.isActive) { created[i]->SetIsActive(false); }
+		}
+
+		return created[0];
+	}
+
+	void SceneSnapshot::Restore(Entity* in_pEntity)
+	{
+		const uint32_t index = m_nextEntity++;
+		const EntityRecord& entity = GetRecords<EntityRecord>(eSection::Entities)[index];
+
+		Component::Transform& transform = *in_pEntity->m_pTransformComponent;
+		transform.SetPosition(entity.position);
+		transform.SetRotation(entity.rotation);
+		transform.SetOrientation(entity.orientation); // Exact even if it was set after the euler angles
+		transform.SetScale(entity.scale);
+
+		// Loads every path once per snapshot, LoadOBJ shares meshes anyway but textures are loaded again each call
+		const auto loadMesh = [this](const uint32_t in_path)
+		{
+			auto it = m_meshes.find(in_path);
+			if (it == m_meshes.end()) { it = m_meshes.emplace(in_path, Engine::LoadOBJ(GetString(in_path))).first; }
+			return it->second;
+		};
+		const auto loadTexture = [this](const uint32_t in_path)
+		{
+			if (in_path == SNAPSHOT_NO_STRING) { return TextureData{}; }
+
+			auto it = m_textures.find(in_path);
+			if (it == m_textures.end()) { it = m_textures.emplace(in_path, Engine::LoadTexture(GetString(in_path))).first; }
+			return it->second;
+		};
+
+		// Every section is sorted by entity, this entity's records are the next ones in each
+		const ModelRecord* pModels = GetRecords<ModelRecord>(eSection::Models);
+		if (m_nextModel < GetCount(eSection::Models) && pModels[m_nextModel].entity == index)
+		{
+			const ModelRecord& model = pModels[m_nextModel++];
+			in_pEntity->AddComponent<Component::Model>(loadMesh(model.meshPath), loadTexture(model.texturePath), model.materialData);
+		}
+
+		const AnimatedModelRecord* pAnimatedModels = GetRecords<AnimatedModelRecord>(eSection::AnimatedModels);
+		if (m_nextAnimatedModel < GetCount(eSection::AnimatedModels) && pAnimatedModels[m_nextAnimatedModel].entity == index)
+		{
+			// Animated meshes are loaded per model, each one gets its own skinning matrices
+			const AnimatedModelRecord& record = pAnimatedModels[m_nextAnimatedModel++];
+			Component::AnimatedModel& model = in_pEntity->AddComponent<Component::AnimatedModel>(Engine::LoadAnimatedMesh(GetString(record.meshPath)),
+				Engine::LoadAnimatedSkeleton(GetString(record.skeletonPath)));
+
+			const AnimationRecord* pAnimations = GetRecords<AnimationRecord>(eSection::Animations) + record.firstAnimation;
+			for (uint32_t i = 0; i < record.animationCount; i++)
+			{
+				const AnimationRecord& animation = pAnimations[i];
+				model.AddAnimation(InternName(GetString(animation.name)), Engine::LoadAnimation(GetString(animation.path)), animation.shouldLoop);
+			}
+			if (!record.isPlaying) { model.Pause(); }
+		}
+
+		const BodyRecord* pBodies = GetRecords<BodyRecord>(eSection::Bodies);
+		if (m_nextBody < GetCount(eSection::Bodies) && pBodies[m_nextBody].entity == index)
+		{
+			const BodyRecord& record = pBodies[m_nextBody++];
+
+			// The shape has to be there before the body is created
+			switch (record.shapeType)
+			{
+			case eShapeType::Box: in_pEntity->AddComponent<Component::CollisionBox>(record.shapeSize); break;
+			case eShapeType::Sphere: in_pEntity->AddComponent<Component::CollisionSphere>(record.shapeSize.x); break;
+			case eShapeType::Capsule: in_pEntity->AddComponent<Component::CollisionCapsule>(record.shapeSize.x, record.shapeSize.y); break;
+			case eShapeType::TriangleMesh: in_pEntity->AddComponent<Component::CollisionTriangleMesh>(loadMesh(record.shapeMeshPath)); break;
+			}
+
+			Component::RigidBody& body = in_pEntity->AddComponent<Component::RigidBody>((Component::RigidBody::eRigidBodyType)record.type,
+				record.mass, record.friction, record.restitution);
+			body.localOffset = record.localOffset;
+			if (body.type == Component::RigidBody::eRigidBodyType::Dynamic) { body.SetGravity(record.gravity); }
+			if (!record.syncRotation) { body.SyncRotation(false); }
+		}
+
+		const LightRecord* pLights = GetRecords<LightRecord>(eSection::Lights);
+		if (m_nextLight < GetCount(eSection::Lights) && pLights[m_nextLight].entity == index)
+		{
+			in_pEntity->AddComponent<Component::Light>(pLights[m_nextLight++].lightData);
+		}
+
+		const SoundEffectRecord* pSoundEffects = GetRecords<SoundEffectRecord>(eSection::SoundEffects);
+		if (m_nextSoundEffect < GetCount(eSection::SoundEffects) && pSoundEffects[m_nextSoundEffect].entity == index)
+		{
+			const SoundEffectRecord& settings = pSoundEffects[m_nextSoundEffect];
+			Component::SoundPlayer& player = in_pEntity->AddComponent<Component::SoundPlayer>();
+			player.SetGain(settings.gain);
+			player.SetPitch(settings.pitch);
+			player.SetBuffer(settings.buffer);
+			player.playSpeed = settings.playSpeed;
+
+			for (; m_nextSoundEffect < GetCount(eSection::SoundEffects) && pSoundEffects[m_nextSoundEffect].entity == index; m_nextSoundEffect++)
+			{
+				const SoundEffectRecord& soundEffect = pSoundEffects[m_nextSoundEffect];
+				if (soundEffect.name == SNAPSHOT_NO_STRING) { continue; } // A player without sounds
+
+				player.AddSoundEffect(InternName(GetString(soundEffect.name)), Engine::LoadSound(GetString(soundEffect.path)));
+			}
+		}
+	}
+
+	const char* SceneSnapshot::GetString(const uint32_t in_offset) const
+	{
+		if (in_offset == SNAPSHOT_NO_STRING) { return nullptr; }
+
+		const Section& strings = GetHeader().sections[(size_t)eSection::Strings];
+		MEGA_ASSERT(in_offset < strings.count, "Snapshot string out of range");
+		return reinterpret_cast<const char*>(m_bytes.data() + strings.offset + in_offset);
+	}
+
+	bool SceneSnapshot::AreRecordsValid() const
+	{
+		// The string section ends with a terminator, so any offset into it reads a whole string
+		const uint32_t stringByteCount = GetCount(eSection::Strings);
+		const auto isString = [stringByteCount](const uint32_t in_offset) { return in_offset < stringByteCount; };
+		const auto isStringOrNone = [&isString](const uint32_t in_offset) { return in_offset == SNAPSHOT_NO_STRING || isString(in_offset); };
+
+		// Restore takes each section's records in entity order, any other order would skip them
+		const uint32_t entityCount = GetCount(eSection::Entities);
+		const auto areSortedByEntity = [entityCount](const auto* in_pRecords, const uint32_t in_count)
+		{
+			for (uint32_t i = 0; i < in_count; i++)
+			{
+				if (in_pRecords[i].entity >= entityCount || (i > 0 && in_pRecords[i].entity < in_pRecords[i - 1].entity)) { return false; }
+			}
+			return true;
+		};
+
+		const EntityRecord* pEntities = GetRecords<EntityRecord>(eSection::Entities);
+		for (uint32_t i = 0; i < entityCount; i++)
+		{
+			const uint32_t parent = pEntities[i].parent;
+			if (i == 0 ? parent != UINT32_MAX : parent >= i) { return false; }
+		}
+
+		// One model of each kind and one body per entity
+		const auto isOnePerEntity = [](const auto* in_pRecords, const uint32_t in_count)
+		{
+			for (uint32_t i = 1; i < in_count; i++)
+			{
+				if (in_pRecords[i].entity == in_pRecords[i - 1].entity) { return false; }
+			}
+			return true;
+		};
+
+		const ModelRecord* pModels = GetRecords<ModelRecord>(eSection::Models);
+		const uint32_t modelCount = GetCount(eSection::Models);
+		if (!areSortedByEntity(pModels, modelCount) || !isOnePerEntity(pModels, modelCount)) { return false; }
+		for (uint32_t i = 0; i < modelCount; i++)
+		{
+			if (!isString(pModels[i].meshPath) || !isStringOrNone(pModels[i].texturePath)) { return false; }
+		}
+
+		const AnimatedModelRecord* pAnimatedModels = GetRecords<AnimatedModelRecord>(eSection::AnimatedModels);
+		const uint32_t animatedModelCount = GetCount(eSection::AnimatedModels);
+		const uint32_t animationCount = GetCount(eSection::Animations);
+		if (!areSortedByEntity(pAnimatedModels, animatedModelCount) || !isOnePerEntity(pAnimatedModels, animatedModelCount)) { return false; }
+		for (uint32_t i = 0; i < animatedModelCount; i++)
+		{
+			const AnimatedModelRecord& model = pAnimatedModels[i];
+			if (!isString(model.meshPath) || !isString(model.skeletonPath)) { return false; }
+			if ((uint64_t)model.firstAnimation + model.animationCount > animationCount) { return false; }
+		}
+
+		const AnimationRecord* pAnimations = GetRecords<AnimationRecord>(eSection::Animations);
+		for (uint32_t i = 0; i < animationCount; i++)
+		{
+			if (!isString(pAnimations[i].name) || !isString(pAnimations[i].path)) { return false; }
+		}
+
+		const BodyRecord* pBodies = GetRecords<BodyRecord>(eSection::Bodies);
+		const uint32_t bodyCount = GetCount(eSection::Bodies);
+		if (!areSortedByEntity(pBodies, bodyCount) || !isOnePerEntity(pBodies, bodyCount)) { return false; }
+		for (uint32_t i = 0; i < bodyCount; i++)
+		{
+			const BodyRecord& body = pBodies[i];
+			if (body.type > (uint32_t)Component::RigidBody::eRigidBodyType::Static) { return false; }
+			if (body.shapeType > eShapeType::TriangleMesh) { return false; }
+			if (body.shapeType == eShapeType::TriangleMesh && !isString(body.shapeMeshPath)) { return false; }
+		}
+
+		const LightRecord* pLights = GetRecords<LightRecord>(eSection::Lights);
+		const uint32_t lightCount = GetCount(eSection::Lights);
+		if (!areSortedByEntity(pLights, lightCount) || !isOnePerEntity(pLights, lightCount)) { return false; }
+
+		// Several sounds per player, a player without any has a single record with no name
+		const SoundEffectRecord* pSoundEffects = GetRecords<SoundEffectRecord>(eSection::SoundEffects);
+		const uint32_t soundEffectCount = GetCount(eSection::SoundEffects);
+		if (!areSortedByEntity(pSoundEffects, soundEffectCount)) { return false; }
+		for (uint32_t i = 0; i < soundEffectCount; i++)
+		{
+			const SoundEffectRecord& soundEffect = pSoundEffects[i];
+			if (soundEffect.name == SNAPSHOT_NO_STRING ? soundEffect.path != SNAPSHOT_NO_STRING : !isString(soundEffect.name) || !isString(soundEffect.path)) { return false; }
+		}
+
+		return true;
+	}
+
+	tFilePath SceneSnapshot::InternName(const char* in_pName)
+	{
+		static std::mutex s_mutex;
+		static std::unordered_set<std::string> s_names; // Nodes never move, so the views stay valid
+
+		std::lock_guard<std::mutex> lock(s_mutex);
+		return *s_names.emplace(in_pName).first;
+	}
+} // namespace Mega
\ No newline at end of file
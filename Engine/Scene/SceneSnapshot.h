@@ -0,0 +1,187 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <type_traits>
+#include <unordered_map>
+
+#include "Engine/Core/Core.h"
+#include "Engine/ECS/Entity.h"
+#include "Engine/Graphics/Objects/Light.h"
+#include "Engine/Graphics/Objects/Model.h"
+
+#define SNAPSHOT_MAGIC 0x504E534D // "MSNP"
+#define SNAPSHOT_VERSION 1
+#define SNAPSHOT_SECTION_ALIGNMENT 16 // Records are used in place, every section starts aligned for the widest one
+#define SNAPSHOT_NO_STRING UINT32_MAX
+
+namespace Mega
+{
+	// Binary snapshot of a part of a scene: its entities' ownership, transforms, models, animated models, rigid
+	// bodies (with their collision shapes), lights, and sound players. The file is a header followed by fixed size
+	// records grouped into sections, all trivially copyable and aligned, so loading is one read with no parsing.
+	// Assets are stored by path (see Engine::FindAssetPath) and loaded through the engine's loaders again.
+	//
+	// Entities come back as SnapshotEntity, the behaviour of the types they were saved from is not stored. Water,
+	// height fields, and models using generated meshes are skipped
+	class SceneSnapshot final
+	{
+	public:
+		SceneSnapshot() = default;
+
+		static bool Save(const Entity* in_pRoot, const tFilePath in_filePath);
+
+		// Reads and checks a file, nothing is created yet
+		bool Read(const tFilePath in_filePath);
+		// Creates the snapshot's entities under in_owner and returns its root. Can be called more than once
+		Entity* Instantiate(Entity* in_owner);
+
+	private:
+		friend class SnapshotEntity;
+
+		enum class eSection : uint32_t
+		{
+			Entities = 0,
+			Models = 1,
+			AnimatedModels = 2,
+			Animations = 3,
+			Bodies = 4,
+			Lights = 5,
+			SoundEffects = 6,
+			Strings = 7,
+			Count = 8
+		};
+		struct Section
+		{
+			uint32_t offset = 0; // From the start of the file
+			uint32_t count = 0; // Records, or bytes for the strings
+		};
+		struct Header
+		{
+			uint32_t magic = SNAPSHOT_MAGIC;
+			uint32_t version = SNAPSHOT_VERSION;
+			uint32_t byteCount = 0;
+			uint32_t padding = 0;
+			Section sections[(size_t)eSection::Count];
+		};
+
+		// Records refer to their entity by its index in the entity section, parents always come before children.
+		// Strings are offsets into the string section, SNAPSHOT_NO_STRING for none
+		struct EntityRecord
+		{
+			uint32_t parent = UINT32_MAX; // UINT32_MAX for the snapshot's root
+			uint32_t isEnabled = 1; // Its own state (see Entity::IsEnabledSelf), the root's as it was seen
+			uint32_t isActive = 1; // Its own, see Entity::IsActiveSelf
+			Vec3 position;
+			Vec3 rotation; // Euler angles, rigid bodies start from these
+			Vec3 scale;
+			Quat orientation;
+		};
+		struct ModelRecord
+		{
+			uint32_t entity = 0;
+			uint32_t meshPath = SNAPSHOT_NO_STRING;
+			uint32_t texturePath = SNAPSHOT_NO_STRING;
+			MaterialData materialData;
+		};
+		struct AnimatedModelRecord
+		{
+			uint32_t entity = 0;
+			uint32_t meshPath = SNAPSHOT_NO_STRING;
+			uint32_t skeletonPath = SNAPSHOT_NO_STRING;
+			uint32_t firstAnimation = 0; // Into the animation section
+			uint32_t animationCount = 0;
+			uint32_t isPlaying = 1;
+		};
+		struct AnimationRecord
+		{
+			uint32_t name = SNAPSHOT_NO_STRING;
+			uint32_t path = SNAPSHOT_NO_STRING;
+			uint32_t shouldLoop = 1;
+		};
+		enum class eShapeType : uint32_t
+		{
+			Box = 0,
+			Sphere = 1,
+			Capsule = 2,
+			TriangleMesh = 3
+		};
+		struct BodyRecord
+		{
+			uint32_t entity = 0;
+			uint32_t type = 0; // PhysicsSystem::eRigidBodyType
+			float mass = 1.0f;
+			float friction = 1.0f;
+			float restitution = 0.3f;
+			float gravity = -9.8f;
+			uint32_t syncRotation = 1;
+			Vec3 localOffset;
+
+			eShapeType shapeType = eShapeType::Box;
+			Vec3 shapeSize; // Box dimensions, or radius (and height) in x (and y)
+			uint32_t shapeMeshPath = SNAPSHOT_NO_STRING; // Triangle meshes
+		};
+		struct LightRecord
+		{
+			uint32_t entity = 0;
+			LightData lightData;
+		};
+		struct SoundEffectRecord // One per sound added to a player, the player's settings are repeated in each
+		{
+			uint32_t entity = 0;
+			uint32_t name = SNAPSHOT_NO_STRING;
+			uint32_t path = SNAPSHOT_NO_STRING;
+			float gain = 1.0f;
+			float pitch = 1.0f;
+			float buffer = 0.0f;
+			float playSpeed = 1.0f;
+		};
+
+		template<typename tRecord>
+		const tRecord* GetRecords(const eSection in_section) const
+		{
+			static_assert(std::is_trivially_copyable<tRecord>::value, "Snapshot records are read in place");
+			static_assert(alignof(tRecord) <= SNAPSHOT_SECTION_ALIGNMENT, "Snapshot record is aligned wider than its section");
+			return reinterpret_cast<const tRecord*>(m_bytes.data() + GetHeader().sections[(size_t)in_section].offset);
+		}
+		inline uint32_t GetCount(const eSection in_section) const { return GetHeader().sections[(size_t)in_section].count; }
+		inline const Header& GetHeader() const { return *reinterpret_cast<const Header*>(m_bytes.data()); }
+		const char* GetString(const uint32_t in_offset) const; // Null for SNAPSHOT_NO_STRING
+		bool AreRecordsValid() const; // Every index, string offset, and enum in range, once the sections are known to fit
+		static tFilePath InternName(const char* in_pName); // Components keep names as string_views, these outlive the snapshot
+
+		void Restore(Entity* in_pEntity); // Adds the next entity's components, from its OnInitialize
+
+		std::vector<uint8_t> m_bytes; // The whole file, records are read from it in place
+
+		// Instantiate's position in each section, records are sorted by entity
+		uint32_t m_nextEntity = 0;
+		uint32_t m_nextModel = 0;
+		uint32_t m_nextAnimatedModel = 0;
+		uint32_t m_nextBody = 0;
+		uint32_t m_nextLight = 0;
+		uint32_t m_nextSoundEffect = 0;
+
+		// Assets loaded by Instantiate, by string offset
+		std::unordered_map<uint32_t, VertexData> m_meshes;
+		std::unordered_map<uint32_t, TextureData> m_textures;
+	};
+
+	// What snapshot entities are created as, its components are restored while it initializes
+	class SnapshotEntity final : public Entity
+	{
+	public:
+		SnapshotEntity(SceneSnapshot* in_pSnapshot)
+			: m_pSnapshot(in_pSnapshot) {}
+
+	private:
+		void OnInitialize() override
+		{
+			m_pSnapshot->Restore(this);
+			m_pSnapshot = nullptr;
+		}
+
+		SceneSnapshot* m_pSnapshot = nullptr;
+	};
+} // namespace Mega
\ No newline at end of file
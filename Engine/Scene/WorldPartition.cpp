@@ -0,0 +1,179 @@
+#include "WorldPartition.h"
+
+#include <cmath>
+#include <algorithm>
+
+#include "Engine/Engine.h"
+#include "Engine/Core/Profiler.h"
+#include "Engine/Scene/Scene.h"
+
+namespace Mega
+{
+	void WorldPartition::AddInstances(const std::shared_ptr<const Prefab>& in_pPrefab, const std::vector<Prefab::Instance>& in_instances)
+	{
+		MEGA_ASSERT(in_pPrefab, "Adding instances of a null prefab to a world partition");
+
+		for (const Prefab::Instance& instance : in_instances)
+		{
+			Cell& cell = m_cells[GetCellCoord(instance.position)];
+			MEGA_ASSERT(cell.state == eCellState::Unloaded, "Adding instances to a cell that is already loaded");
+
+			std::vector<StreamedGroup>& groups = cell.placedContent.groups;
+			if (groups.empty() || groups.back().pPrefab != in_pPrefab) { groups.push_back({ in_pPrefab, {} }); }
+			groups.back().instances.push_back(instance);
+		}
+	}
+
+	WorldPartition::CellCoord WorldPartition::GetCellCoord(const Vec3& in_position) const
+	{
+		return { (int32_t)std::floor(in_position.x / m_settings.cellSize), (int32_t)std::floor(in_position.z / m_settings.cellSize) };
+	}
+
+	uint32_t WorldPartition::GetCellCount(const eCellState in_state) const
+	{
+		return (uint32_t)std::count_if(m_cells.begin(), m_cells.end(), [in_state](const auto& in_cell) { return in_cell.second.state == in_state; });
+	}
+
+	void WorldPartition::OnUpdate(const tTimestep in_dt)
+	{
+		MEGA_PROFILE_SCOPE("WorldPartition::OnUpdate");
+
+		Vec3 center;
+		if (!FindStreamingCenter(center)) { return; }
+
+		// Generated cells only exist while they are near enough to load
+		if (m_cellLoader)
+		{
+			const CellCoord centerCoord = GetCellCoord(center);
+			const int32_t reach = (int32_t)std::ceil(m_settings.loadRadius / m_settings.cellSize);
+			for (int32_t x = centerCoord.x - reach; x <= centerCoord.x + reach; x++)
+			{
+				for (int32_t z = centerCoord.z - reach; z <= centerCoord.z + reach; z++)
+				{
+					const CellCoord coord = { x, z };
+					if (GetDistance(coord, center) < m_settings.loadRadius) { m_cells.try_emplace(coord); }
+				}
+			}
+		}
+
+		const float unloadRadius = m_settings.loadRadius + m_settings.hysteresis;
+		const float deactivateRadius = m_settings.activeRadius + m_settings.hysteresis;
+		uint32_t instantiateCount = 0;
+		for (auto it = m_cells.begin(); it != m_cells.end();)
+		{
+			Cell& cell = it->second;
+			const float distance = GetDistance(it->first, center);
+
+			switch (cell.state)
+			{
+			case eCellState::Unloaded:
+				if (distance < m_settings.loadRadius) { StartLoad(it->first, cell); }
+				break;
+			case eCellState::Loading:
+				if (!cell.pLoadCounter->IsDone()) { break; }
+				if (distance > unloadRadius) { Unload(cell); } // Left before it finished
+				else if (instantiateCount < m_settings.maxInstantiatesPerTick)
+				{
+					Spawn(cell);
+					instantiateCount++;
+				}
+				break;
+			case eCellState::Loaded:
+				if (distance > unloadRadius) { Unload(cell); }
+				else if (distance < m_settings.activeRadius)
+				{
+					Engine::SetEntityEnabled(GetScene()->GetEntity(cell.cellEntity), true);
+					cell.state = eCellState::Active;
+				}
+				break;
+			case eCellState::Active:
+				if (distance > deactivateRadius)
+				{
+					Engine::SetEntityEnabled(GetScene()->GetEntity(cell.cellEntity), false);
+					cell.state = eCellState::Loaded;
+				}
+				break;
+			}
+
+			const bool isEmpty = cell.state == eCellState::Unloaded && cell.placedContent.groups.empty();
+			it = isEmpty ? m_cells.erase(it) : std::next(it);
+		}
+	}
+
+	void WorldPartition::OnDestroy()
+	{
+		// Loading jobs write into the cells
+		for (const auto& [coord, cell] : m_cells)
+		{
+			if (cell.state == eCellState::Loading) { Engine::WaitForJobs(*cell.pLoadCounter); }
+		}
+	}
+
+	bool WorldPartition::FindStreamingCenter(Vec3& out_center) const
+	{
+		auto view = GetScene()->GetRegistry().view<Component::Transform, Component::CameraTarget>();
+		for (const auto& [entity, transform, target] : view.each())
+		{
+			if (!target.IsActive()) { continue; }
+
+			out_center = Vec3(transform.GetWorldTransform()[3]);
+			return true;
+		}
+
+		return false;
+	}
+
+	float WorldPartition::GetDistance(const CellCoord& in_coord, const Vec3& in_position) const
+	{
+		// To the nearest point of the cell, so a target inside it is at 0
+		const float minX = in_coord.x * m_settings.cellSize;
+		const float minZ = in_coord.z * m_settings.cellSize;
+		const float dx = std::max({ minX - in_position.x, 0.0f, in_position.x - (minX + m_settings.cellSize) });
+		const float dz = std::max({ minZ - in_position.z, 0.0f, in_position.z - (minZ + m_settings.cellSize) });
+
+		return std::sqrt(dx * dx + dz * dz);
+	}
+
+	void WorldPartition::StartLoad(const CellCoord& in_coord, Cell& in_cell)
+	{
+		in_cell.state = eCellState::Loading;
+		if (!in_cell.pLoadCounter) { in_cell.pLoadCounter = std::make_unique<JobCounter>(); }
+		if (!m_cellLoader) { return; } // Only placed content, already in memory
+
+		// Loaders block on the main thread, so the cell is built where the main thread's waits can never pick it up
+		Engine::GetJobSystem().RunBlocking([loader = m_cellLoader, coord = in_coord, pContent = &in_cell.loadedContent]()
+		{
+			MEGA_PROFILE_SCOPE("WorldPartition::LoadCell");
+			loader(coord, *pContent);
+		}, in_cell.pLoadCounter.get());
+	}
+
+	void WorldPartition::Spawn(Cell& in_cell)
+	{
+		MEGA_PROFILE_SCOPE("WorldPartition::Spawn");
+
+		// Disabled before anything is added, so the instances start disabled too
+		WorldCell* pCell = Engine::AddChildEntity<WorldCell>(this);
+		pCell->SetIsEnabled(false);
+		in_cell.cellEntity = pCell->GetHandle();
+
+		for (const CellContent* pContent : { &in_cell.placedContent, &in_cell.loadedContent })
+		{
+			for (const StreamedGroup& group : pContent->groups)
+			{
+				Engine::Instantiate(pCell, *group.pPrefab, group.instances);
+			}
+		}
+
+		in_cell.state = eCellState::Loaded;
+	}
+
+	void WorldPartition::Unload(Cell& in_cell)
+	{
+		if (Entity* pCell = GetScene()->GetEntity(in_cell.cellEntity)) { pCell->Destroy(); }
+		in_cell.cellEntity = {};
+
+		in_cell.loadedContent = CellContent(); // Frees the instance arrays too, not just their elements
+		in_cell.state = eCellState::Unloaded;
+	}
+} // namespace Mega
\ No newline at end of file
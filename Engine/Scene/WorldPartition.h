@@ -0,0 +1,114 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+
+#include "Engine/Core/Core.h"
+#include "Engine/ECS/Entity.h"
+#include "Engine/Scene/Prefab.h"
+#include "Engine/Core/JobSystem.h"
+
+namespace Mega
+{
+	// Holds the entities of one streamed cell, destroying it unloads them all
+	class WorldCell final : public Entity
+	{
+	public:
+		WorldCell() = default;
+	};
+
+	// Splits the world into square cells on the XZ plane and streams their entities around the active camera target.
+	// Cells within the load radius are loaded (their content built on a job, then instantiated disabled), cells within
+	// the active radius are enabled, and a cell steps back down once it is a radius plus the hysteresis away. Only
+	// active cells have bodies in the physics world or get drawn, so both stay proportional to the neighbourhood.
+	// Anything that has to exist everywhere (the ground, the player) is added outside the partition
+	class WorldPartition : public Entity
+	{
+	public:
+		struct Settings
+		{
+			float cellSize = 50.0f;
+			float activeRadius = 75.0f; // Distance to a cell's edge
+			float loadRadius = 125.0f;
+			float hysteresis = 10.0f; // So a target on a boundary does not flip a cell every tick
+			uint32_t maxInstantiatesPerTick = 1; // Spreads the cost of crossing into new cells over ticks
+		};
+
+		struct CellCoord
+		{
+			int32_t x = 0;
+			int32_t z = 0;
+
+			inline bool operator==(const CellCoord& in_other) const { return x == in_other.x && z == in_other.z; }
+		};
+
+		// Instances of one prefab in a cell, positions are relative to the partition
+		struct StreamedGroup
+		{
+			std::shared_ptr<const Prefab> pPrefab; // Shared by every cell placing it
+			std::vector<Prefab::Instance> instances;
+		};
+		struct CellContent
+		{
+			std::vector<StreamedGroup> groups;
+		};
+
+		// Builds a cell's content each time it loads, on the job system's I/O thread. Asset loaders can be called from it
+		using tCellLoader = std::function<void(const CellCoord& in_coord, CellContent& out_content)>;
+
+		enum class eCellState
+		{
+			Unloaded = 0,
+			Loading = 1,
+			Loaded = 2, // Instantiated but disabled
+			Active = 3
+		};
+
+		WorldPartition(const Settings& in_settings = {})
+			: m_settings(in_settings) {}
+
+		// Sorts the instances into the cells they fall in, they are spawned and destroyed with their cell
+		void AddInstances(const std::shared_ptr<const Prefab>& in_pPrefab, const std::vector<Prefab::Instance>& in_instances);
+		// Optional, for content generated or read per cell instead of placed up front
+		inline void SetCellLoader(tCellLoader in_loader) { m_cellLoader = std::move(in_loader); }
+
+		CellCoord GetCellCoord(const Vec3& in_position) const;
+		uint32_t GetCellCount(const eCellState in_state) const;
+		inline const Settings& GetSettings() const { return m_settings; }
+
+		void OnUpdate(const tTimestep in_dt) override;
+		void OnDestroy() override;
+
+	private:
+		struct CellCoordHash
+		{
+			inline size_t operator()(const CellCoord& in_coord) const
+			{
+				return std::hash<uint64_t>()(((uint64_t)(uint32_t)in_coord.x << 32) | (uint32_t)in_coord.z);
+			}
+		};
+
+		struct Cell
+		{
+			eCellState state = eCellState::Unloaded;
+			CellContent placedContent; // From AddInstances, kept while unloaded
+			CellContent loadedContent; // From the cell loader, dropped when unloaded
+			std::unique_ptr<JobCounter> pLoadCounter; // Jobs hold its address, so it lives on the heap
+			EntityHandle cellEntity; // The WorldCell while loaded
+		};
+
+		bool FindStreamingCenter(Vec3& out_center) const; // The first active camera target's world position
+		float GetDistance(const CellCoord& in_coord, const Vec3& in_position) const;
+
+		void StartLoad(const CellCoord& in_coord, Cell& in_cell);
+		void Spawn(Cell& in_cell);
+		void Unload(Cell& in_cell);
+
+		Settings m_settings;
+		tCellLoader m_cellLoader;
+		std::unordered_map<CellCoord, Cell, CellCoordHash> m_cells; // Nodes never move, loading jobs write into them
+	};
+} // namespace Mega
\ No newline at end of file
@@ -5,6 +5,7 @@
 
 #include "AudioFile/AudioFile.h"
 #include "Engine/Core/Debug.h"
+#include "Engine/Core/MemoryTracker.h"
 #include "Engine/Sound/SoundData.h"
 
 namespace Mega
@@ -58,6 +59,7 @@ namespace Mega
 		alGetBufferi(soundBuffer.soundID, AL_CHANNELS, &channels);
 		alGetBufferi(soundBuffer.soundID, AL_BITS, &bits);
 		alGetBufferi(soundBuffer.soundID, AL_FREQUENCY, &frequency);
+		MemoryTracker::Allocate(eMemoryTag::Audio, (size_t)sizeInBytes); // Buffers are kept until the device closes
 		auto lengthInSamples = sizeInBytes * 8 / (channels * bits);
 		soundBuffer.length = (float)lengthInSamples / (float)frequency;
 
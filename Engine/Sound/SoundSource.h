@@ -14,6 +14,8 @@ namespace Mega
 		void Play(const SoundData& in_sound);
 		inline void SetPitch(float in_pitch) { pitch = in_pitch; alSourcef(pSoundSource, AL_PITCH, in_pitch); }
 		inline void SetGain(float in_gain) { gain = in_gain, alSourcef(pSoundSource, AL_GAIN, in_gain); }
+		inline float GetPitch() const { return pitch; }
+		inline float GetGain() const { return gain; }
 
 	private:
 		ALuint pSoundSource = 0;
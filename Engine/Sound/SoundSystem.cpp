@@ -67,6 +67,7 @@ namespace Mega
 	eMegaResult SoundSystem::OnUpdate(const tTimestep in_dt, Scene* in_pScene)
 	{
 		auto view = in_pScene->GetRegistry().view<Component::SoundPlayer>();
+		SetTouchedCount((uint32_t)view.size());
 		for (const auto& [entity, player] : view.each())
 		{
 			player.timeToPlay -= in_dt;
@@ -86,6 +87,11 @@ namespace Mega
 		return eMegaResult::SUCCESS;
 	}
 
+	void SoundSystem::DeclareAccess(SystemAccess& in_access) const
+	{
+		in_access.Writes<Component::SoundPlayer>();
+	}
+
 	SoundData SoundSystem::LoadSound(const tFilePath in_soundPath)
 	{
 		MEGA_ASSERT(IsInitialized(), "Loading sound with unitialized Sound System");
@@ -18,6 +18,8 @@ namespace Mega
 		eMegaResult OnInitialize() override;
 		eMegaResult OnDestroy() override;
 		eMegaResult OnUpdate(const tTimestep in_dt, Scene* in_pScene) override;
+		const char* GetName() const override { return "SoundSystem"; }
+		void DeclareAccess(SystemAccess& in_access) const override;
 
 		SoundData LoadSound(const tFilePath in_soundPath);
 
@@ -4,6 +4,7 @@
 
 #include "ImGui/imgui.h"
 #include "Engine/Core/Time.h"
+#include "Engine/Core/Telemetry.h"
 #include "Engine/Scene/Scene.h"
 #include "Engine/Wind/WindComponents.h"
 #include "Engine/Engine.h"
@@ -13,6 +14,11 @@ glm::vec2 g_dir = { 0, 1 };
 float g_str = 50.0f;
 namespace Mega
 {
+	namespace
+	{
+		const tCounterID g_solverIterationCounter = Telemetry::Register("Wind/Solver iterations", eCounterType::Counter);
+	}
+
 	// ================ Wind System ================ //
 	eMegaResult WindSystem::OnInitialize()
 	{
@@ -20,6 +26,8 @@ namespace Mega
 
 		m_globalWindData.resize(m_windSimulator.GetBlockCount());
 
+		MEGA_ADD_DEBUG_PANEL(this, "Wind", [this]() { BuildDebugPanel(); });
+
 		return eMegaResult::SUCCESS;
 	};
 
@@ -27,33 +35,25 @@ namespace Mega
 	float g_dt = 1000;
 	eMegaResult WindSystem::OnUpdate(const tTimestep in_dt, Scene* in_pScene)
 	{
-		///////////////////// AHHHHHH ///////////////////////////////
-
-
-		ImGui::DragFloat4("Global Wind Vector", &m_globalWindVector.x, 0.01f);
-
-
-		/////////////////////////////////////////////////////////////
-		
 		// Update wind simulation using the new data
 		m_windSimulator.Update(in_dt);
 		m_windSimulator.FillVelocityData(m_globalWindData);
 
 		// Send wind motor component data to wind simulation
 		const auto& viewMotors = in_pScene->GetRegistry().view<Component::WindMotor>();
+		uint32_t motorCount = 0;
 		for (const auto& [entity, motor] : viewMotors.each())
 		{
 			// Each wind motor component adds wind to the simulation at a specific position
 			if (motor.isOn)
 			{
+				motorCount++;
 				m_windSimulator.AddVelocity(Vec2(motor.position.x, motor.position.z), Vec2(motor.forceVector.x, motor.forceVector.z));
 				motor.isOn = false;
 			}
 		}
+		SetTouchedCount(motorCount);
 
-
-		ImGui::DragFloat("Wind Strength", &g_str, 0.001, 0, 50);
-		ImGui::Checkbox("Add Wind", &g_b);
 		if (g_b)
 		{
 			//m_windSimulator.AddVelocity(Vec2(5, 5), normalize(Vec2(cos(Engine::Runtime() / 1000.0) + 1, sin(Engine::Runtime() / 1000.0) + 1)) * Vec2(15));
@@ -63,26 +63,6 @@ namespace Mega
 			//m_windSimulator.AddVelocity(Vec2(10, 10), Vec2(-1, -1) * g_str);
 		}
 
-		// ------------------- ImGui Display ----------------------- //
-
-		// TODO: Confirm simulation working using densisites (display that in buttons instead of velocity)
-		ImGui::NewLine();
-		for (uint32_t m = 0; m < m_windSimulator.m_gridDimensions.x; m++)
-		{
-			for (uint32_t i = 0; i < m_windSimulator.m_gridDimensions.y; i++)
-			{
-				Vec4 windData = m_globalWindData[IX(i, m)];
-				if (ImGui::ColorButton(std::string(std::to_string(m + i)).c_str(), ImVec4(windData.x, \
-					windData.z, 0, 1)))
-				{
-					m_windSimulator.AddDensity(Vec2(i, m), 1);
-				}
-				ImGui::SameLine();
-			}
-			ImGui::NewLine();
-		}
-		// --------------------------------------------------------- //
-
 		// Read back wind data from the simulation and send it to the reciever components
 		const auto& viewRecievers = in_pScene->GetRegistry().view<Component::WindReciever>();
 		for (const auto& [entity, reciever] : viewRecievers.each())
@@ -96,10 +76,50 @@ namespace Mega
 
 	eMegaResult WindSystem::OnDestroy()
 	{
+		MEGA_REMOVE_DEBUG_PANELS(this);
 		m_windSimulator.Destroy();
 
 		return eMegaResult::SUCCESS;
 	}
+
+	void WindSystem::DeclareAccess(SystemAccess& in_access) const
+	{
+		in_access.Writes<Component::WindMotor, Component::WindReciever>();
+	}
+
+#ifndef MEGA_DISABLE_DEBUG_UI
+	void WindSystem::BuildDebugPanel()
+	{
+		ImGui::DragFloat4("Global Wind Vector", &m_globalWindVector.x, 0.01f);
+		ImGui::DragFloat("Wind Strength", &g_str, 0.001, 0, 50);
+		ImGui::Checkbox("Add Wind", &g_b);
+		m_windSimulator.BuildDebugPanel();
+
+		// The field is drawn as one rect per block straight into the window's draw list behind a single button, so it
+		// is one widget and one draw call instead of a widget per block. Clicking a block adds density to it
+		// TODO: Confirm simulation working using densisites (display that in buttons instead of velocity)
+		const float blockSize = 6.0f;
+		const ImVec2 origin = ImGui::GetCursorScreenPos();
+		if (ImGui::InvisibleButton("##WindField", ImVec2(blockSize * m_windSimulator.m_gridDimensions.y, blockSize * m_windSimulator.m_gridDimensions.x)))
+		{
+			const ImVec2 mousePos = ImGui::GetIO().MousePos;
+			const uint32_t i = std::min((uint32_t)((mousePos.x - origin.x) / blockSize), m_windSimulator.m_gridDimensions.y - 1);
+			const uint32_t m = std::min((uint32_t)((mousePos.y - origin.y) / blockSize), m_windSimulator.m_gridDimensions.x - 1);
+			m_windSimulator.AddDensity(Vec2(i, m), 1);
+		}
+
+		ImDrawList* pDrawList = ImGui::GetWindowDrawList();
+		for (uint32_t m = 0; m < m_windSimulator.m_gridDimensions.x; m++)
+		{
+			for (uint32_t i = 0; i < m_windSimulator.m_gridDimensions.y; i++)
+			{
+				const Vec4& windData = m_globalWindData[IX(i, m)];
+				const ImVec2 blockMin = ImVec2(origin.x + i * blockSize, origin.y + m * blockSize);
+				pDrawList->AddRectFilled(blockMin, ImVec2(blockMin.x + blockSize, blockMin.y + blockSize), ImGui::GetColorU32(ImVec4(windData.x, windData.z, 0, 1)));
+			}
+		}
+	}
+#endif
 }
 	
 	// =========== Fluid Simulation ============ //
@@ -123,25 +143,28 @@ namespace Mega
 
 	eMegaResult WindSystem::FluidSimulator2D::Update(const tTimestep in_dt)
 	{
-		ImGui::DragFloat("Scale Wind DT", &g_dt, 1, 1);
-		ImGui::DragFloat("Wind Viscosity", &m_viscosity, 0.0001, 0.000001);
-		int i = m_diffusionPrecision;
-		ImGui::DragInt("Wind DP", &i, 1, 1, 20);
-		m_diffusionPrecision = i;
 		const tTimestep scaled_dt = in_dt / g_dt;
 
 		// ----------------------- Fluid Simulation Step ----------------------- //
-		Diffuse(1, m_pVelocityDataX0, m_pVelocityDataX, m_viscosity, scaled_dt);
+		// Each step only touches the arrays passed to it, so the x/y velocity steps and the density diffusion
+		// (which does not need velocity until it is advected) are run as separate jobs
+		JobSystem& jobSystem = Engine::GetJobSystem();
+		JobCounter velocityDiffused, densityDiffused, velocityAdvected;
+
+		jobSystem.Run([&]() { Diffuse(0, m_pTemp, m_pDensityData, m_diffusionRate, scaled_dt); }, &densityDiffused);
+		jobSystem.Run([&]() { Diffuse(1, m_pVelocityDataX0, m_pVelocityDataX, m_viscosity, scaled_dt); }, &velocityDiffused);
 		Diffuse(2, m_pVelocityDataY0, m_pVelocityDataY, m_viscosity, scaled_dt);
+		jobSystem.Wait(velocityDiffused);
 
 		Project(m_pVelocityDataX0, m_pVelocityDataY0, m_pVelocityDataX, m_pVelocityDataY);
 		
-		Advect(1, m_pVelocityDataX, m_pVelocityDataX0, m_pVelocityDataX0, m_pVelocityDataY0, scaled_dt);
+		jobSystem.Run([&]() { Advect(1, m_pVelocityDataX, m_pVelocityDataX0, m_pVelocityDataX0, m_pVelocityDataY0, scaled_dt); }, &velocityAdvected);
 		Advect(2, m_pVelocityDataY, m_pVelocityDataY0, m_pVelocityDataX0, m_pVelocityDataY0, scaled_dt);
+		jobSystem.Wait(velocityAdvected);
 		
 		Project(m_pVelocityDataX, m_pVelocityDataY, m_pVelocityDataX0, m_pVelocityDataY0);
 
-		Diffuse(0, m_pTemp, m_pDensityData, m_diffusionRate, scaled_dt);
+		jobSystem.Wait(densityDiffused);
 		Advect(0, m_pDensityData, m_pTemp, m_pVelocityDataX, m_pVelocityDataY, scaled_dt);
 
 		return eMegaResult::SUCCESS;
@@ -152,37 +175,50 @@ namespace Mega
 		return eMegaResult::SUCCESS;
 	}
 
+#ifndef MEGA_DISABLE_DEBUG_UI
+	void WindSystem::FluidSimulator2D::BuildDebugPanel()
+	{
+		ImGui::DragFloat("Scale Wind DT", &g_dt, 1, 1);
+		ImGui::DragFloat("Wind Viscosity", &m_viscosity, 0.0001, 0.000001);
+		int i = m_diffusionPrecision;
+		ImGui::DragInt("Wind DP", &i, 1, 1, 20);
+		m_diffusionPrecision = i;
+	}
+#endif
+
 	void WindSystem::FluidSimulator2D::FillVelocityData(std::vector<Vec4>& in_buffer)
 	{
 		const size_t expectedBufferSize = GetBlockCount() * sizeof(Vec4);
 		const size_t inputBufferSize    = in_buffer.size() * sizeof(in_buffer[0]);
 		MEGA_ASSERT(inputBufferSize == expectedBufferSize, "Buffer sizes not equal");
 
-		for (uint32_t x = 0; x < WIND_SIM_GRID_DIMENSIONS_X; x++)
+		Engine::ParallelFor(0, WIND_SIM_GRID_DIMENSIONS_X, WIND_SIM_GRID_DIMENSIONS_X / 4, [&](const uint32_t in_begin, const uint32_t in_end)
 		{
-			for (uint32_t y = 0; y < WIND_SIM_GRID_DIMENSIONS_Y; y++)
+			for (uint32_t x = in_begin; x < in_end; x++)
 			{
-				// TODO: optimiza
-				const size_t index = IX(x, y);
-
-				Vec4 vec{};
-
-				vec.x = (m_pVelocityDataX[index]) / 5.0f;
-				vec.y = (m_pVelocityDataY[index]);
-				vec.z = (m_pVelocityDataY[index]) / 5.0f;
-				vec.w = std::min<tScalar>(1, glm::length(Vec3(vec)));
-				
-				if (vec.w > 0)
+				for (uint32_t y = 0; y < WIND_SIM_GRID_DIMENSIONS_Y; y++)
 				{
-					Vec3 norm = Vec3(vec);
-					vec.x = norm.x;
-					vec.y = norm.y;
-					vec.z = norm.z;
+					const size_t index = IX(x, y);
+
+					Vec4 vec{};
+
+					vec.x = (m_pVelocityDataX[index]) / 5.0f;
+					vec.y = (m_pVelocityDataY[index]);
+					vec.z = (m_pVelocityDataY[index]) / 5.0f;
+					vec.w = std::min<tScalar>(1, glm::length(Vec3(vec)));
+					
+					if (vec.w > 0)
+					{
+						Vec3 norm = Vec3(vec);
+						vec.x = norm.x;
+						vec.y = norm.y;
+						vec.z = norm.z;
+					}
+
+					in_buffer[IX(x, y)] = vec;
 				}
-
-				in_buffer[IX(x, y)] = vec;
 			}
-		}
+		});
 	}
 
 	void WindSystem::FluidSimulator2D::ClearVelocity()
@@ -226,6 +262,7 @@ namespace Mega
 				}
 			}
 		}
+		Telemetry::Add(g_solverIterationCounter, m_diffusionPrecision); // Solves run on jobs too
 
 		SetBoundry(in_callIndex, in_pX);
 	}
@@ -30,6 +30,8 @@ namespace Mega
 
 		eMegaResult OnInitialize() override;
 		eMegaResult OnUpdate(const tTimestep in_dt, Scene* in_pScene) override;
+		const char* GetName() const override { return "WindSystem"; }
+		void DeclareAccess(SystemAccess& in_access) const override;
 		eMegaResult OnDestroy() override;
 
 		// Getters / Setters
@@ -55,6 +57,9 @@ namespace Mega
 			// Fills a vector with fluid data (changes array structure to AoS (array of vecs vs 4 arrays for each x, y, z, a) because that is how it is most likely
 			// going to be used especially by the gpu)
 			void FillVelocityData(std::vector<Vec4>& in_buffer);
+#ifndef MEGA_DISABLE_DEBUG_UI
+			void BuildDebugPanel(); // Its tweakables, part of the wind system's panel
+#endif
 
 			// Number of blocks in the 3d grid
 			inline constexpr uint64_t GetBlockCount() const { return (uint64_t)(WIND_SIM_GRID_DIMENSIONS_X * WIND_SIM_GRID_DIMENSIONS_Y); }
@@ -85,6 +90,10 @@ namespace Mega
 		};
 
 	private:
+#ifndef MEGA_DISABLE_DEBUG_UI
+		void BuildDebugPanel();
+#endif
+
 		Vec3 m_windSimCenter = { 0, 0, 0 };
 		tWindVector m_globalWindVector = { 1, 0, 0, 1 }; // xyz dir, w magnitude
 		std::vector<tWindVector> m_globalWindData{};
@@ -23,6 +23,7 @@ void CharacterController::OnInitialize()
 	m_pPhysicsBody->SyncRotation(false);
 	m_pPhysicsBody->SetGravity(m_gravity);
 	m_pPhysicsBody->localOffset = { 0, 1, 0 };
+	m_pPhysicsBody->SetContactEvents(Mega::ContactEventBit(Mega::eContactEvent::Begin) | Mega::ContactEventBit(Mega::eContactEvent::Stay)); // Ground checks, every tick it touches
 	m_pCollisionShape = &GetComponent<Mega::Component::CollisionCapsule>(); // TODO: more general get collision shape component function?
 
 	m_stateMachine = Mega::StateMachine<CharacterController>(this, eMovementState::StateCount);
@@ -34,6 +35,15 @@ void CharacterController::OnInitialize()
 	m_stateMachine.AddState(eMovementState::WallClimbing, &CharacterController::OnUpdateWallClimbing, &CharacterController::OnEntryWallClimbing, &CharacterController::OnExitWallClimbing);
 
 	SetState(eMovementState::Idle);
+
+#ifndef MEGA_DISABLE_DEBUG_UI
+	Mega::Engine::RunOnMainThread([this]() { MEGA_ADD_DEBUG_PANEL(this, "Character Controller", [this]() { BuildDebugPanel(); }, true); });
+#endif
+}
+
+void CharacterController::OnDestroy()
+{
+	MEGA_REMOVE_DEBUG_PANELS(this);
 }
 
 void CharacterController::ControlWithInput(const Mega::Input& in_input)
@@ -84,7 +94,16 @@ void CharacterController::OnUpdate(const Mega::tTimestep in_dt)
 	// Frame Setup
 	m_dt = in_dt;
 
-	// ImGui
+	// Update state machine
+	m_stateMachine.Update(in_dt);
+
+	// Cleanup before physics
+	m_groundCollisionTest = false;
+}
+
+#ifndef MEGA_DISABLE_DEBUG_UI
+void CharacterController::BuildDebugPanel()
+{
 	ImGui::Text(MovementStateName(MovementState()));
 	ImGui::Text("Last State:");
 	ImGui::Text(MovementStateName(LastMovementState()));
@@ -96,13 +115,8 @@ void CharacterController::OnUpdate(const Mega::tTimestep in_dt)
 	//ImGui::DragFloat("Jump Height", &m_jumpHeight, 1.0, 0.0);
 	ImGui::Checkbox("On Ground", &m_groundRayTest);
 	ImGui::Checkbox("On Wall", &m_wallRayTest);
-
-	// Update state machine
-	m_stateMachine.Update(in_dt);
-
-	// Cleanup before physics
-	m_groundCollisionTest = false;
 }
+#endif
 
 float wallBuffer = 0.8; // How far the ray comes out of the player
 float wallStart = 0.5;
@@ -116,8 +130,15 @@ void CharacterController::OnUpdatePost(const Mega::tTimestep in_dt)
 
 	const tScalar rayBuffer = 0.5; // How far the ray comes out of the player
 	const tScalar rayStart = 0.2;
-	m_groundRayTest = Mega::Engine::PerformRayTestCollision(pos + Vec3(0, rayStart, 0), pos + Vec3(0, -rayBuffer, 0));
-	m_wallRayTest = Mega::Engine::PerformRayTestCollision(pos + Vec3(0, wallStart, 0), pos + (facing * (capsuleRadius + wallBuffer)));
+	const Mega::RayQuery queries[2] =
+	{
+		{ pos + Vec3(0, rayStart, 0), pos + Vec3(0, -rayBuffer, 0) }, // Ground
+		{ pos + Vec3(0, wallStart, 0), pos + (facing * (capsuleRadius + wallBuffer)) }, // Wall
+	};
+	Mega::RayHit hits[2];
+	Mega::Engine::PerformQueries(queries, hits, 2);
+	m_groundRayTest = hits[0].hasHit;
+	m_wallRayTest = hits[1].hasHit;
 
 	if (IsState(eMovementState::Jumping) && MovementStateTimer(eMovementState::Jumping) < m_jumpBuffer) { m_groundRayTest = false; }
 
@@ -129,22 +150,17 @@ void CharacterController::OnUpdatePost(const Mega::tTimestep in_dt)
 	ClearInputFields();
 }
 
-void CharacterController::OnCollision(const Mega::Entity* in_pEntity, const Mega::CollisionData& in_collisionData)
+void CharacterController::OnContact(const Mega::Entity* in_pOther, const Mega::ContactEvent& in_event)
 {
 	// Bug: falling off cliff can still jump once
-	if (TypeOf(in_pEntity) == TypeOf<Mega::Wall>() || TypeOf(in_pEntity) == TypeOf<Arena>())
+	if (TypeOf(in_pOther) == TypeOf<Mega::Wall>() || TypeOf(in_pOther) == TypeOf<Arena>())
 	{
-		const btPersistentManifold* pManifold = in_collisionData.pManifold;
-		for (int i = 0; i < pManifold->getNumContacts(); i++)
+		// The normal points into us, up when standing on it. Not exactly up on slopes or with solver noise
+		if (in_event.normal.y > m_groundNormalMinY)
 		{
-			const btManifoldPoint& contact = pManifold->getContactPoint(i);
-
-			if (contact.m_normalWorldOnB.getY() == 1)
-			{
-				if (IsState(eMovementState::Jumping) && MovementStateTimer(eMovementState::Jumping) < m_jumpBuffer) { return; }
+			if (IsState(eMovementState::Jumping) && MovementStateTimer(eMovementState::Jumping) < m_jumpBuffer) { return; }
 
-				m_groundCollisionTest = true;
-			}
+			m_groundCollisionTest = true;
 		}
 	}
 }
@@ -37,8 +37,8 @@ public:
 	void OnInitialize() override;
 	void OnUpdate(const Mega::tTimestep in_dt) override;
 	void OnUpdatePost(const Mega::tTimestep in_dt) override;
-	void OnCollision(const Mega::Entity* in_pEntity, const Mega::CollisionData& in_collisionData) override;
-	void OnDestroy() override {};
+	void OnContact(const Mega::Entity* in_pOther, const Mega::ContactEvent& in_event) override;
+	void OnDestroy() override;
 
 protected:
 	// To control using keyboard input
@@ -84,11 +84,12 @@ protected:
 
 private:
 	void InterpolateRotation();
+	void BuildDebugPanel();
 	inline void SetState(eMovementState in_state) { m_stateMachine.SetState(in_state); }
 
 	// ---------------- Physics Helpers ---------------
-	inline void ApplyCentralForce(const Mega::Vec3& in_force) { m_pPhysicsBody->pPhysicsBody->applyCentralForce({ in_force.x, in_force.y, in_force.z }); }
-	inline void ApplyCentralImpulse(const Mega::Vec3& in_force) { m_pPhysicsBody->pPhysicsBody->applyCentralImpulse({ in_force.x, in_force.y, in_force.z }); }
+	inline void ApplyCentralForce(const Mega::Vec3& in_force) { m_pPhysicsBody->ApplyCentralForce(in_force); }
+	inline void ApplyCentralImpulse(const Mega::Vec3& in_force) { m_pPhysicsBody->ApplyCentralImpulse(in_force); }
 	inline void SetLinearVelocity(const Mega::Vec3& in_velocity) { m_pPhysicsBody->SetLinearVelocity(in_velocity); }
 	// ------------------------------------------------
 
@@ -132,6 +133,7 @@ private:
 	tScalar m_dashSpeed = 10.0f;
 	tScalar m_rollSpeed = 3.0f;
 	tScalar m_jumpHeight = 50.0f;
+	tScalar m_groundNormalMinY = 0.7f; // Contacts facing at least this far up are ground, slopes up to about 45 degrees
 
 	Mega::tTimestep m_dashTime = 120;
 	Mega::tTimestep m_dashResetTime = 1000;
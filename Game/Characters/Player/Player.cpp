@@ -28,19 +28,20 @@ void Player::OnInitialize()
 	m_pAnimation->AddAnimation("Falling", Mega::Engine::LoadAnimation("Assets/Animations/Player/JumpLoop.ozz"));
 
 	m_pWindMotor = &AddComponent<Mega::Component::WindMotor>();
+
+#ifndef MEGA_DISABLE_DEBUG_UI
+	Mega::Engine::RunOnMainThread([this]() { MEGA_ADD_DEBUG_PANEL(this, "Player", [this]() { BuildDebugPanel(); }, true); });
+#endif
 };
 
 void Player::OnUpdate(const Mega::tTimestep in_dt)
 {
-	ImGui::Checkbox("Lock Player", &g_lockPlayer);
 	if (!g_lockPlayer) { CharacterController::ControlWithInput(Mega::Engine::GetInput()); }
 	CharacterController::OnUpdate(in_dt);
 }
 
 void Player::OnUpdatePost(const Mega::tTimestep in_dt)
 {
-	float fps = (1.0f / in_dt) * 1000;
-	ImGui::SliderFloat("FPS", &fps, 0, 300);
 	PlayCorrectAnimation();
 	CharacterController::OnUpdatePost(in_dt);
 }
@@ -73,15 +74,22 @@ void Player::PlayCorrectAnimation()
 	glm::vec3 rightFootPosition = GetPosition() + Vec3(perp2.x / 4.0, 0, perp2.y / 4.0);
 
 	// Foot Planting
-	auto rayTestPositionLeft = Mega::Engine::PerformRayTestPosition({ leftFootPosition.x, GetPosition().y + 1, leftFootPosition.z }, { leftFootPosition.x, GetPosition().y - 10, leftFootPosition.z });
-	auto rayTestPositionRight = Mega::Engine::PerformRayTestPosition({ rightFootPosition.x, GetPosition().y + 1, rightFootPosition.z }, { rightFootPosition.x, GetPosition().y - 10, rightFootPosition.z });
+	const Mega::RayQuery footQueries[2] =
+	{
+		{ { leftFootPosition.x, GetPosition().y + 1, leftFootPosition.z }, { leftFootPosition.x, GetPosition().y - 10, leftFootPosition.z } },
+		{ { rightFootPosition.x, GetPosition().y + 1, rightFootPosition.z }, { rightFootPosition.x, GetPosition().y - 10, rightFootPosition.z } },
+	};
+	Mega::RayHit footHits[2];
+	Mega::Engine::PerformQueries(footQueries, footHits, 2);
+
+	auto rayTestPositionLeft = footHits[0].position;
+	auto rayTestPositionRight = footHits[1].position;
 	rayTestPositionLeft.y -= 0.05f;
 	rayTestPositionRight.y -= 0.05f;
 
-	auto rayTestNormalLeft = Mega::Engine::PerformRayTestNormal({ leftFootPosition.x, GetPosition().y + 1, leftFootPosition.z }, { leftFootPosition.x, GetPosition().y - 10, leftFootPosition.z });
-	auto rayTestNormalRight = Mega::Engine::PerformRayTestNormal({ rightFootPosition.x, GetPosition().y + 1, rightFootPosition.z }, { rightFootPosition.x, GetPosition().y - 10, rightFootPosition.z });
+	auto rayTestNormalLeft = footHits[0].normal;
+	auto rayTestNormalRight = footHits[1].normal;
 
-	ImGui::DragFloat("Sound Buffer", &pitch, 0.001, 0.0, 1000);
 	m_pSoundPlayer->SetBuffer(pitch);
 	if (MovementState() == eMovementState::Running)
 	{
@@ -99,12 +107,24 @@ void Player::PlayCorrectAnimation()
 	}
 }
 
-void Player::OnCollision(const Mega::Entity* in_pEntity, const Mega::CollisionData& in_collisionData)
+void Player::OnContact(const Mega::Entity* in_pOther, const Mega::ContactEvent& in_event)
 {
-	CharacterController::OnCollision(in_pEntity, in_collisionData);
+	CharacterController::OnContact(in_pOther, in_event);
 }
 
 void Player::OnDestroy()
 {
-	CharacterController::OnDestroy();
-}
\ No newline at end of file
+	CharacterController::OnDestroy(); // Removes this one's panels too
+}
+
+#ifndef MEGA_DISABLE_DEBUG_UI
+void Player::BuildDebugPanel()
+{
+	ImGui::Checkbox("Lock Player", &g_lockPlayer);
+
+	float fps = ImGui::GetIO().Framerate;
+	ImGui::SliderFloat("FPS", &fps, 0, 300);
+
+	ImGui::DragFloat("Sound Buffer", &pitch, 0.001, 0.0, 1000);
+}
+#endif
\ No newline at end of file
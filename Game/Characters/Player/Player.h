@@ -14,11 +14,12 @@ public:
 	void OnInitialize() override;
 	void OnUpdate(const Mega::tTimestep in_dt) override;
 	void OnUpdatePost(const Mega::tTimestep in_dt) override;
-	void OnCollision(const Mega::Entity* in_pEntity, const Mega::CollisionData& in_collisionData) override;
+	void OnContact(const Mega::Entity* in_pOther, const Mega::ContactEvent& in_event) override;
 	void OnDestroy() override;
 
 private:
 	void PlayCorrectAnimation();
+	void BuildDebugPanel();
 
 	Spear* m_pSpear = nullptr;
 	Spear* m_pIKTargetModel = nullptr;
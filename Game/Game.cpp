@@ -1,62 +1,158 @@
 #include "Game/Game.h"
 
-#include <thread>
-#include <time.h>
+#include <vector>
+#include <iostream>
+#include <algorithm>
 
 #include "Game/World/World.h"
+#include "Engine/Core/Telemetry.h"
 
 // TODO: Another name for scene? or just have "engine" take care of the systems part and have
 // scene just control the entities/loaded shit? (scene would basically be root entity)
 // TODO: Entity (Player) GetPosition() should use rigid body motionstate not entity transform?
-// TODO: fix transform component class (glm::decompose) - or really transform should only control pos, rot, scale, and make proper 
-// transform on GetTransform()
 // TODO: Animation model matrices are now getting their entity's transform directly multiplied to them cpu side
 // (to make joint attachment and stuff easier) is this efficient enough?
 
-void Game::Initialize()
+void Game::Initialize(const Mega::EngineSettings& in_settings)
 {
-    Mega::Engine::Initialize();
+    Mega::Engine::Initialize(in_settings);
 
     m_pScene = Mega::Engine::GetScene();
-    m_pScene->CreateRootEntity<World>();
+    m_pWorld = m_pScene->CreateRootEntity<World>();
 }   
 
-// Game loop
+// Game loop - the engine owns it, see EngineSettings for the tick and frame rates
 void Game::Run()
 {
-    Mega::tTimestep dt = 0.0; // Number of millis per frame
-    // For now lock at 60FPS - target time is number of nanosecs one frame should take
-    Mega::tNanosecond targetTime = Mega::tNanosecond((int)((1000.0 * 1000.0 * 1000.0) / 30.0)); // TODO: lock to physics using GameState jawn
-    Mega::tNanosecond timePassed = Mega::tNanosecond(0);
-    Mega::tNanosecond currentTime = Mega::Time<Mega::tNanosecond>();
+    Mega::Engine::Run();
+}
+
+void Game::Destroy()
+{
+    Mega::Engine::Destroy();
+}
+
+void Game::RunSpawnBenchmark(const uint32_t in_count)
+{
+    using Mega::tNanosecond;
 
-    while (!Mega::Engine::ShouldClose())
+    const Mega::Vec3 dimensions(1, 5, 1);
+    std::vector<Mega::Prefab::Instance> instances(in_count);
+    for (uint32_t i = 0; i < in_count; i++)
     {
-        Mega::tNanosecond startTime = Mega::Time<Mega::tNanosecond>();
+        instances[i].position = Mega::Vec3((i % 100) * 2.0f, 10.0f, (i / 100) * 2.0f); // A grid above the arena
+        instances[i].scale = dimensions;
+    }
 
-        Mega::Engine::HandleInput();
-        Mega::Engine::Update(dt);
-        Mega::Engine::Display();
+    const auto printResult = [in_count](const char* in_name, const tNanosecond in_elapsed)
+    {
+        const double elapsedMs = in_elapsed.count() / 1000.0 / 1000.0;
+        std::cout << in_name << ": " << in_count << " walls in " << elapsedMs << "ms, "
+            << elapsedMs * 1000.0 / std::max(in_count, 1u) << "ms per thousand" << std::endl;
+    };
+
+    // One at a time, the way World spawns its walls
+    std::vector<Mega::Wall*> walls;
+    walls.reserve(in_count);
+
+    const tNanosecond singleStart = Mega::Time<tNanosecond>();
+    for (const Mega::Prefab::Instance& instance : instances)
+    {
+        walls.push_back(Mega::Engine::AddChildEntity<Mega::Wall>(m_pWorld, instance.position, dimensions));
+    }
+    printResult("AddChildEntity", Mega::Time<tNanosecond>() - singleStart);
+
+    // The scene deletes destroyed entities at the end of a tick
+    for (Mega::Wall* pWall : walls) { pWall->Destroy(); }
+    Mega::Engine::Update(Mega::Engine::GetTickTimestep());
+    Mega::Engine::Display();
+
+    // The same walls as one batch
+    Mega::Prefab wallPrefab;
+    wallPrefab.Add<Mega::Component::Model>(Mega::Engine::LoadOBJ("Assets/Models/Shapes/Cube.obj"), Mega::TextureData{}, Mega::MaterialData(0.1f, 0.5f, 0.5f))
+        .Add<Mega::Component::CollisionBox>(dimensions)
+        .Add<Mega::Component::RigidBody>(Mega::Component::RigidBody::eRigidBodyType::Static, 0.0f, 0.5f, 0.5f);
+
+    // Under one entity so they can be snapshotted together
+    Mega::PrefabEntity* pGroup = Mega::Engine::AddChildEntity<Mega::PrefabEntity>(m_pWorld);
+
+    const tNanosecond batchStart = Mega::Time<tNanosecond>();
+    Mega::Engine::Instantiate(pGroup, wallPrefab, instances);
+    printResult("Instantiate", Mega::Time<tNanosecond>() - batchStart);
 
-        // Wait loop to lock at the target FPS
-        Mega::tNanosecond endTime = Mega::Time<Mega::tNanosecond>();
-        auto deltaTime = (endTime - startTime);
-        if (deltaTime < targetTime)
+    // The same walls written to a snapshot and read back
+    const char* snapshotPath = "SpawnBenchmark.snapshot";
+    const tNanosecond saveStart = Mega::Time<tNanosecond>();
+    const bool isSaved = Mega::Engine::SaveSnapshot(pGroup, snapshotPath);
+    printResult("SaveSnapshot", Mega::Time<tNanosecond>() - saveStart);
+
+    pGroup->Destroy();
+    Mega::Engine::Update(Mega::Engine::GetTickTimestep());
+    Mega::Engine::Display();
+    if (!isSaved) { return; }
+
+    const tNanosecond loadStart = Mega::Time<tNanosecond>();
+    Mega::Entity* pLoaded = Mega::Engine::LoadSnapshot(m_pWorld, snapshotPath);
+    printResult("LoadSnapshot", Mega::Time<tNanosecond>() - loadStart);
+
+    if (pLoaded) { pLoaded->Destroy(); }
+    Mega::Engine::Update(Mega::Engine::GetTickTimestep());
+    Mega::Engine::Display();
+}
+
+void Game::RunPhysicsBenchmark(const uint32_t in_tickCount)
+{
+    // Registering a name again returns the physics system's counters
+    const Mega::tCounterID stepCounter = Mega::Telemetry::Register("Physics/Steps", Mega::eCounterType::Counter);
+    const Mega::tCounterID stepTimeCounter = Mega::Telemetry::Register("Physics/Step time (us)", Mega::eCounterType::Counter);
+    const Mega::tCounterID slowestStepCounter = Mega::Telemetry::Register("Physics/Slowest step (us)", Mega::eCounterType::Gauge);
+    std::cout << "Physics benchmark: " << (Mega::Engine::IsPhysicsMultithreaded() ? "multithreaded" : "single threaded") << " world, "
+        << Mega::Engine::GetJobSystem().GetWorkerCount() << " workers, " << in_tickCount << " ticks per body count" << std::endl;
+
+    // A floor of its own above the arena, 200 units across so the ~75 unit grid of boxes lands well inside it
+    Mega::Prefab floorPrefab;
+    floorPrefab.Add<Mega::Component::CollisionBox>(Mega::Vec3(200, 1, 200))
+        .Add<Mega::Component::RigidBody>(Mega::Component::RigidBody::eRigidBodyType::Static, 0.0f, 0.5f, 0.5f);
+    Mega::PrefabEntity* pFloor = Mega::Engine::AddChildEntity<Mega::PrefabEntity>(m_pWorld);
+    Mega::Engine::Instantiate(pFloor, floorPrefab, { Mega::Prefab::Instance{ Mega::Vec3(0, 19.5f, 0) } });
+
+    Mega::Prefab boxPrefab;
+    boxPrefab.Add<Mega::Component::CollisionBox>(Mega::Vec3(1, 1, 1))
+        .Add<Mega::Component::RigidBody>(Mega::Component::RigidBody::eRigidBodyType::Dynamic, 1.0f, 0.5f, 0.3f);
+
+    for (const uint32_t bodyCount : { 1000u, 5000u, 20000u })
+    {
+        // Layers of 50 x 50 boxes with gaps between them, so they fall, pile up, and start to settle
+        std::vector<Mega::Prefab::Instance> instances(bodyCount);
+        for (uint32_t i = 0; i < bodyCount; i++)
         {
-            Mega::tNanosecond remainingTime = targetTime - deltaTime - Mega::tMillisecond(2); // Buffer needed because the sleep function is not exact
-            if (remainingTime > Mega::tNanosecond(0))
-            {
-                std::this_thread::sleep_for(remainingTime);
-            }
+            instances[i].position = Mega::Vec3(((i % 50) - 25.0f) * 1.5f, 22.0f + (i / 2500) * 1.5f, (((i / 50) % 50) - 25.0f) * 1.5f);
+        }
+        Mega::PrefabEntity* pGroup = Mega::Engine::AddChildEntity<Mega::PrefabEntity>(m_pWorld);
+        Mega::Engine::Instantiate(pGroup, boxPrefab, instances);
+
+        int64_t stepCount = 0;
+        int64_t stepMicroseconds = 0;
+        int64_t slowestStepMicroseconds = 0;
+        for (uint32_t i = 0; i < in_tickCount; i++)
+        {
+            Mega::Engine::Update(Mega::Engine::GetTickTimestep());
+            Mega::Engine::Display(); // Closes the frame, so the counters hold this tick's steps
 
-            while ((Mega::Time<Mega::tNanosecond>() - startTime + Mega::tMicrosecond(10)) < targetTime) {};
+            stepCount += Mega::Telemetry::GetValue(stepCounter);
+            stepMicroseconds += Mega::Telemetry::GetValue(stepTimeCounter);
+            slowestStepMicroseconds = std::max(slowestStepMicroseconds, Mega::Telemetry::GetValue(slowestStepCounter));
         }
 
-        dt = (Mega::Time<Mega::tNanosecond>() - startTime).count() / 1000.0 / 1000.0;
+        std::cout << bodyCount << " bodies: " << stepCount << " steps, " << stepMicroseconds / 1000.0 / std::max<int64_t>(stepCount, 1)
+            << "ms per step, slowest step " << slowestStepMicroseconds / 1000.0 << "ms" << std::endl;
+
+        pGroup->Destroy();
+        Mega::Engine::Update(Mega::Engine::GetTickTimestep());
+        Mega::Engine::Display();
     }
-}
 
-void Game::Destroy()
-{
-    Mega::Engine::Destroy();
+    pFloor->Destroy();
+    Mega::Engine::Update(Mega::Engine::GetTickTimestep());
+    Mega::Engine::Display();
 }
\ No newline at end of file
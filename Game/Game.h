@@ -5,10 +5,18 @@
 class Game
 {
 public:
-	void Initialize();
+	void Initialize(const Mega::EngineSettings& in_settings = {});
 	void Run();
 	void Destroy();
 
+	// Spawns in_count walls one at a time, then as one prefab batch, then from a snapshot of that batch, printing
+	// what each costs per thousand
+	void RunSpawnBenchmark(const uint32_t in_count);
+	// Drops 1k, 5k, then 20k dynamic boxes onto a floor and runs in_tickCount ticks with each, printing the physics
+	// step time. Run once with and once without EngineSettings::isPhysicsMultithreaded to compare the worlds
+	void RunPhysicsBenchmark(const uint32_t in_tickCount);
+
 private:
 	Mega::Scene* m_pScene = nullptr;
+	Mega::Entity* m_pWorld = nullptr;
 };
\ No newline at end of file
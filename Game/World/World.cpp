@@ -25,20 +25,64 @@ void World::OnInitialize()
 
 	//Mega::Engine::AddChildEntity<SkyBox>(this);
 	Mega::Engine::AddChildEntity<Arena>(this);
+
+	// Pillars scattered over the ground around the arena, only the ones near the player are loaded
+	const Mega::Vec3 pillarDimensions(2, 6, 2);
+	auto pPillarPrefab = std::make_shared<Mega::Prefab>();
+	pPillarPrefab->Add<Mega::Component::Model>(Mega::Engine::LoadOBJ("Assets/Models/Shapes/Cube.obj"), Mega::TextureData{}, Mega::MaterialData(0.1f, 0.5f, 0.5f))
+		.Add<Mega::Component::CollisionBox>(pillarDimensions)
+		.Add<Mega::Component::RigidBody>(Mega::Component::RigidBody::eRigidBodyType::Static, 0.0f, 0.5f, 0.5f);
+
+	std::vector<Mega::Prefab::Instance> pillars;
+	for (int x = -140; x <= 140; x += 20)
+	{
+		for (int z = -140; z <= 140; z += 20)
+		{
+			if (std::abs(x) < 60 && std::abs(z) < 60) { continue; } // The arena
+
+			Mega::Prefab::Instance& pillar = pillars.emplace_back();
+			pillar.position = Mega::Vec3(x + (z % 7), pillarDimensions.y / 2, z + (x % 5));
+			pillar.scale = pillarDimensions;
+		}
+	}
+
+	m_pWorldPartition = Mega::Engine::AddChildEntity<Mega::WorldPartition>(this);
+	m_pWorldPartition->AddInstances(pPillarPrefab, pillars);
+
+	// Built once per drawn frame, whatever number of ticks ran. Worlds can be built on the scene loading thread, panels
+	// are only added on the main thread
+#ifndef MEGA_DISABLE_DEBUG_UI
+	Mega::Engine::RunOnMainThread([this]() { MEGA_ADD_DEBUG_PANEL(this, "World", [this]() { BuildDebugPanel(); }, true); });
+#endif
 }
 
 void World::OnUpdate(const Mega::tTimestep in_dt)
 {
 	m_pSoundPlayer->Play("Ambient");
-
-	Mega::Vec3 lightDir = dirLight->GetLightDirection();
-	ImGui::DragFloat3("Sun Color", &dirLight->GetLightData()->color.x, 0.001, 0.0, 1.0);
-	ImGui::DragFloat("Sun Strength", &dirLight->GetLightData()->strength, 0.01, 0.0, 1.0);
-	ImGui::DragFloat3("Sun Direction", &lightDir.x, 1);
-	dirLight->SetLightDirection(lightDir);
 }
 
 void World::OnDestroy()
 {
+	MEGA_REMOVE_DEBUG_PANELS(this);
+}
+
+#ifndef MEGA_DISABLE_DEBUG_UI
+void World::BuildDebugPanel()
+{
+	// The renderer only re-gathers lights that were marked changed
+	bool isSunChanged = false;
+	isSunChanged |= ImGui::DragFloat3("Sun Color", &dirLight->GetLightData()->color.x, 0.001, 0.0, 1.0);
+	isSunChanged |= ImGui::DragFloat("Sun Strength", &dirLight->GetLightData()->strength, 0.01, 0.0, 1.0);
+	if (isSunChanged) { dirLight->MarkLightChanged(); }
 
-}
\ No newline at end of file
+	Mega::Vec3 lightDir = dirLight->GetLightDirection();
+	if (ImGui::DragFloat3("Sun Direction", &lightDir.x, 1)) { dirLight->SetLightDirection(lightDir); }
+
+	using eCellState = Mega::WorldPartition::eCellState;
+	ImGui::Text("World Cells: %u active, %u loaded, %u loading", m_pWorldPartition->GetCellCount(eCellState::Active),
+		m_pWorldPartition->GetCellCount(eCellState::Loaded), m_pWorldPartition->GetCellCount(eCellState::Loading));
+
+	// Builds a fresh world in the background, this one keeps running until it is swapped out
+	if (!Mega::Engine::IsLoadingScene() && ImGui::Button("Reload World")) { Mega::Engine::LoadSceneAsync<World>(); }
+}
+#endif
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Engine/Engine.h"
+#include "Engine/Scene/WorldPartition.h"
 
 #include "Game/World/SkyBox.h"
 #include "Game/Objects/Arena.h"
@@ -19,7 +20,10 @@ public:
 	void OnUpdate(const Mega::tTimestep in_dt) override;
 
 private:
+	void BuildDebugPanel();
+
 	Player* m_pPlayer = nullptr;
+	Mega::WorldPartition* m_pWorldPartition = nullptr; // Streams the scenery around the player
 
 	Mega::Component::SoundPlayer* m_pSoundPlayer = nullptr; // plays global sounds and music
 	Mega::PointLight* pointLight = nullptr;
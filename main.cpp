@@ -1,11 +1,76 @@
 #include "Game/Game.h"
 
-int main()
+#include <cstdlib>
+#include <cstring>
+
+// Usage: Game [--headless [frameCount]] [--profile [tracePath]] [--spawn-benchmark [count]] [--physics-benchmark [tickCount]] [--physics-mt]
+// Headless runs the simulation without a window, renderer, or audio device for the given number of frames (or until closed)
+// Profile records timing zones, writing a Chrome trace and printing a per phase summary on exit
+// Spawn benchmark times spawning count walls (default 10000) one by one, as a prefab batch, and from a snapshot, headless, then exits
+// Physics benchmark prints the physics step time with 1k, 5k, and 20k boxes over tickCount ticks each (default 300), headless, then exits
+// Physics mt uses Bullet's multithreaded world (needs Bullet built with BT_THREADSAFE)
+int main(int argc, char** argv)
 {
+    Mega::EngineSettings settings{};
+    uint32_t spawnBenchmarkCount = 0;
+    uint32_t physicsBenchmarkTickCount = 0;
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::strcmp(argv[i], "--headless") == 0)
+        {
+            settings.isHeadless = true;
+            if (i + 1 < argc && argv[i + 1][0] != '-')
+            {
+                settings.headlessFrameCount = std::strtoull(argv[++i], nullptr, 10);
+            }
+        }
+        else if (std::strcmp(argv[i], "--profile") == 0)
+        {
+            settings.isProfilerEnabled = true;
+            if (i + 1 < argc && argv[i + 1][0] != '-')
+            {
+                settings.profilerTracePath = argv[++i];
+            }
+        }
+        else if (std::strcmp(argv[i], "--spawn-benchmark") == 0)
+        {
+            settings.isHeadless = true;
+            spawnBenchmarkCount = 10000;
+            if (i + 1 < argc && argv[i + 1][0] != '-')
+            {
+                spawnBenchmarkCount = (uint32_t)std::strtoul(argv[++i], nullptr, 10);
+            }
+        }
+        else if (std::strcmp(argv[i], "--physics-benchmark") == 0)
+        {
+            settings.isHeadless = true;
+            physicsBenchmarkTickCount = 300;
+            if (i + 1 < argc && argv[i + 1][0] != '-')
+            {
+                physicsBenchmarkTickCount = (uint32_t)std::strtoul(argv[++i], nullptr, 10);
+            }
+        }
+        else if (std::strcmp(argv[i], "--physics-mt") == 0)
+        {
+            settings.isPhysicsMultithreaded = true;
+        }
+    }
+
     Game* game = new Game();
 
-    game->Initialize();
-    game->Run();
+    game->Initialize(settings);
+    if (spawnBenchmarkCount > 0)
+    {
+        game->RunSpawnBenchmark(spawnBenchmarkCount);
+    }
+    else if (physicsBenchmarkTickCount > 0)
+    {
+        game->RunPhysicsBenchmark(physicsBenchmarkTickCount);
+    }
+    else
+    {
+        game->Run();
+    }
     game->Destroy();
 
     delete game;